@@ -21,32 +21,103 @@ DEFINES += \
 
 
 INCLUDEPATH += \
+    src/AudioBackend \
     src/AudioManager\
     src/BigPictureTV \
     src/Configurator \
+    src/DetectionScheduler \
+    src/DetectionStateMachine \
+    src/DetectionWorker \
     src/NightLightSwitcher \
+    src/PowerShellHost \
+    src/ProcessRunner \
+    src/ProcessTable \
+    src/RegistryWatcher \
+    src/RuleMatcher \
     src/ShortcutManager \
     src/SteamWindowManager \
+    src/SystemStateMonitor \
+    src/TitleMatcher \
+    src/TraceRecorder \
+    src/TransitionExecutor \
+    src/TransitionPlan \
     src/Utils \
+    src/WindowEnumerator \
+    src/WindowEventSource \
+    src/WindowFilter \
+    src/WindowMatcher \
+    src/WindowTable \
 
 SOURCES += \
+    src/AudioBackend/powershellaudiobackend.cpp \
+    src/AudioBackend/win32audiobackend.cpp \
     src/AudioManager/audiomanager.cpp \
     src/BigPictureTV/BigPictureTV.cpp \
     src/main.cpp \
     src/NightLightSwitcher/NightLightSwitcher.cpp \
+    src/PowerShellHost/powershellhost.cpp \
+    src/ProcessRunner/processrunner.cpp \
+    src/ProcessTable/processtable.cpp \
+    src/ProcessTable/win32processsource.cpp \
+    src/RegistryWatcher/keystore.cpp \
+    src/RegistryWatcher/registrywatcher.cpp \
+    src/RegistryWatcher/win32keystore.cpp \
+    src/RuleMatcher/rulematcher.cpp \
     src/Configurator/configurator.cpp \
+    src/DetectionScheduler/detectionscheduler.cpp \
+    src/DetectionStateMachine/detectionstatemachine.cpp \
+    src/DetectionWorker/detectionworker.cpp \
     src/ShortcutManager/shortcutmanager.cpp \
     src/SteamWindowManager/steamwindowmanager.cpp \
-    src/Utils/utils.cpp
+    src/SystemStateMonitor/systemstatemonitor.cpp \
+    src/TitleMatcher/titlematcher.cpp \
+    src/TraceRecorder/tracerecorder.cpp \
+    src/TransitionExecutor/transitionexecutor.cpp \
+    src/TransitionPlan/transitionplan.cpp \
+    src/Utils/utils.cpp \
+    src/WindowEnumerator/win32windowenumerator.cpp \
+    src/WindowEventSource/windoweventsource.cpp \
+    src/WindowEventSource/wineventwindowsource.cpp \
+    src/WindowFilter/windowfilter.cpp \
+    src/WindowTable/windowtable.cpp
 
 HEADERS += \
+    src/AudioBackend/audiobackend.h \
+    src/AudioBackend/powershellaudiobackend.h \
+    src/AudioBackend/win32audiobackend.h \
     src/AudioManager/audiomanager.h \
     src/BigPictureTV/BigPictureTV.h \
     src/Configurator/configurator.h \
+    src/DetectionScheduler/detectionscheduler.h \
+    src/DetectionStateMachine/detectionstatemachine.h \
+    src/DetectionWorker/detectionworker.h \
+    src/DetectionWorker/spscqueue.h \
     src/NightLightSwitcher/NightLightSwitcher.h \
+    src/PowerShellHost/powershellhost.h \
+    src/ProcessRunner/processrunner.h \
+    src/ProcessTable/processsource.h \
+    src/ProcessTable/processtable.h \
+    src/ProcessTable/win32processsource.h \
+    src/RegistryWatcher/keystore.h \
+    src/RegistryWatcher/registrywatcher.h \
+    src/RegistryWatcher/win32keystore.h \
+    src/RuleMatcher/rulematcher.h \
     src/ShortcutManager/shortcutmanager.h \
+    src/SteamWindowManager/bigpicturetitles.h \
     src/SteamWindowManager/steamwindowmanager.h \
-    src/Utils/utils.h
+    src/SystemStateMonitor/systemstatemonitor.h \
+    src/TitleMatcher/titlematcher.h \
+    src/TraceRecorder/tracerecorder.h \
+    src/TransitionExecutor/transitionexecutor.h \
+    src/TransitionPlan/transitionplan.h \
+    src/Utils/utils.h \
+    src/WindowEnumerator/win32windowenumerator.h \
+    src/WindowEnumerator/windowenumerator.h \
+    src/WindowEventSource/windoweventsource.h \
+    src/WindowEventSource/wineventwindowsource.h \
+    src/WindowFilter/windowfilter.h \
+    src/WindowMatcher/windowmatcher.h \
+    src/WindowTable/windowtable.h
 
 FORMS += \
     src/Configurator/configurator.ui
@@ -61,7 +132,7 @@ RESOURCES += \
 
 RC_FILE = src/Resources/appicon.rc
 
-LIBS += -lole32 -luser32 -ladvapi32 -lshell32
+LIBS += -lole32 -luser32 -ladvapi32 -lshell32 -lwtsapi32
 
 DEPENDENCIES_DIR = $$PWD/dependencies
 DEST_DIR = $$OUT_PWD/release/dependencies
@@ -0,0 +1,116 @@
+#include "benchmarkrunner.h"
+#include <QElapsedTimer>
+#include <QJsonValue>
+#include <QTextStream>
+#include "allocationcounter.h"
+
+const int BenchmarkRunner::ALLOCATION_SAMPLES = 100;
+const double BenchmarkRunner::DEFAULT_TOLERANCE = 0.25;
+
+BenchmarkRunner::BenchmarkRunner(const QString &filter, int minimumMilliseconds)
+    : filter(filter)
+    , minimumNanoseconds(qint64(minimumMilliseconds) * 1000000)
+{}
+
+void BenchmarkRunner::run(const QString &name, const std::function<void()> &operation)
+{
+    if (!filter.isEmpty() && !name.contains(filter)) {
+        return;
+    }
+
+    operation();
+
+    // Counted separately so the counter's own work stays out of the timing.
+    AllocationCounter counter;
+    for (int i = 0; i < ALLOCATION_SAMPLES; ++i) {
+        operation();
+    }
+    Result result;
+    result.name = name;
+    result.allocationsPerOperation = double(counter.allocations()) / ALLOCATION_SAMPLES;
+    result.bytesPerOperation = double(counter.bytes()) / ALLOCATION_SAMPLES;
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 batch = 1;
+    while (true) {
+        for (qint64 i = 0; i < batch; ++i) {
+            operation();
+        }
+        result.operations += batch;
+        if (timer.nsecsElapsed() >= minimumNanoseconds) {
+            break;
+        }
+        batch *= 2;
+    }
+    result.nanosecondsPerOperation = double(timer.nsecsElapsed()) / result.operations;
+
+    QTextStream(stdout) << QString("%1 %2 ns/op %3 allocs/op %4 B/op\n")
+                               .arg(name, -48)
+                               .arg(result.nanosecondsPerOperation, 12, 'f', 1)
+                               .arg(result.allocationsPerOperation, 8, 'f', 2)
+                               .arg(result.bytesPerOperation, 10, 'f', 1);
+    resultList.append(result);
+}
+
+const QList<BenchmarkRunner::Result> &BenchmarkRunner::results() const
+{
+    return resultList;
+}
+
+QJsonObject BenchmarkRunner::toJson() const
+{
+    QJsonObject benchmarks;
+    for (const Result &result : resultList) {
+        QJsonObject entry;
+        entry["ns_per_op"] = result.nanosecondsPerOperation;
+        entry["allocations_per_op"] = result.allocationsPerOperation;
+        entry["bytes_per_op"] = result.bytesPerOperation;
+        benchmarks[result.name] = entry;
+    }
+
+    QJsonObject root;
+    root["allocations_counted"] = AllocationCounter::countsCAllocations() ? "all" : "operator new";
+    root["tolerance"] = DEFAULT_TOLERANCE;
+    root["benchmarks"] = benchmarks;
+    return root;
+}
+
+int BenchmarkRunner::compare(const QJsonObject &baseline) const
+{
+    const double tolerance = baseline["tolerance"].toDouble(DEFAULT_TOLERANCE);
+    const QJsonObject benchmarks = baseline["benchmarks"].toObject();
+    QTextStream out(stdout);
+    int regressions = 0;
+
+    // A null baseline value has not been recorded yet and is not compared.
+    for (const Result &result : resultList) {
+        const QJsonObject entry = benchmarks[result.name].toObject();
+        if (entry.isEmpty()) {
+            out << "No baseline for " << result.name << "\n";
+            continue;
+        }
+
+        const QJsonValue nanoseconds = entry["ns_per_op"];
+        if (nanoseconds.isDouble() && result.nanosecondsPerOperation > nanoseconds.toDouble() * (1 + tolerance)) {
+            out << "REGRESSION " << result.name << ": " << result.nanosecondsPerOperation
+                << " ns/op, baseline " << nanoseconds.toDouble() << "\n";
+            ++regressions;
+        }
+
+        // Allocations are deterministic, so any increase counts.
+        const QJsonValue allocations = entry["allocations_per_op"];
+        if (allocations.isDouble() && result.allocationsPerOperation > allocations.toDouble()) {
+            out << "REGRESSION " << result.name << ": " << result.allocationsPerOperation
+                << " allocs/op, baseline " << allocations.toDouble() << "\n";
+            ++regressions;
+        }
+        const QJsonValue bytes = entry["bytes_per_op"];
+        if (bytes.isDouble() && result.bytesPerOperation > bytes.toDouble()) {
+            out << "REGRESSION " << result.name << ": " << result.bytesPerOperation << " B/op, baseline "
+                << bytes.toDouble() << "\n";
+            ++regressions;
+        }
+    }
+    return regressions;
+}
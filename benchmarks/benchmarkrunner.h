@@ -0,0 +1,43 @@
+#ifndef BENCHMARKRUNNER_H
+#define BENCHMARKRUNNER_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <functional>
+
+// Times operations and counts the heap allocations they make.
+class BenchmarkRunner
+{
+public:
+    struct Result
+    {
+        QString name;
+        qint64 operations = 0;
+        double nanosecondsPerOperation = 0;
+        double allocationsPerOperation = 0;
+        double bytesPerOperation = 0;
+    };
+
+    BenchmarkRunner(const QString &filter, int minimumMilliseconds);
+
+    // Calls operation until the minimum time has passed; one call is one operation.
+    // The first call is not measured, so lazily sized scratch state does not count.
+    void run(const QString &name, const std::function<void()> &operation);
+
+    const QList<Result> &results() const;
+    QJsonObject toJson() const;
+    // Reports every result that is slower than the baseline by more than its tolerance,
+    // or allocates more often or more bytes. Returns the number of regressions.
+    int compare(const QJsonObject &baseline) const;
+
+private:
+    QString filter;
+    qint64 minimumNanoseconds;
+    QList<Result> resultList;
+
+    static const int ALLOCATION_SAMPLES;
+    static const double DEFAULT_TOLERANCE;
+};
+
+#endif // BENCHMARKRUNNER_H
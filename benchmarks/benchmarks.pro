@@ -0,0 +1,52 @@
+QT -= gui
+
+CONFIG += c++17 \
+          console \
+          silent \
+
+CONFIG -= app_bundle
+
+TARGET = detectorbench
+
+SRC_DIR = $$PWD/../src
+SHARED_DIR = $$PWD/../tests/shared
+
+INCLUDEPATH += \
+    $$SHARED_DIR \
+    $$SRC_DIR/ProcessTable \
+    $$SRC_DIR/RuleMatcher \
+    $$SRC_DIR/SteamWindowManager \
+    $$SRC_DIR/TitleMatcher \
+    $$SRC_DIR/WindowEnumerator \
+    $$SRC_DIR/WindowFilter \
+    $$SRC_DIR/WindowMatcher \
+    $$SRC_DIR/WindowTable \
+
+SOURCES += \
+    $$SHARED_DIR/allocationcounter.cpp \
+    $$SRC_DIR/ProcessTable/processtable.cpp \
+    $$SRC_DIR/RuleMatcher/rulematcher.cpp \
+    $$SRC_DIR/TitleMatcher/titlematcher.cpp \
+    $$SRC_DIR/WindowFilter/windowfilter.cpp \
+    $$SRC_DIR/WindowTable/windowtable.cpp \
+    benchmarkrunner.cpp \
+    detectorbenchmarks.cpp \
+    main.cpp \
+    titlesets.cpp
+
+HEADERS += \
+    $$SHARED_DIR/allocationcounter.h \
+    $$SHARED_DIR/fakeprocesssource.h \
+    $$SHARED_DIR/fakewindowenumerator.h \
+    $$SRC_DIR/ProcessTable/processsource.h \
+    $$SRC_DIR/ProcessTable/processtable.h \
+    $$SRC_DIR/RuleMatcher/rulematcher.h \
+    $$SRC_DIR/SteamWindowManager/bigpicturetitles.h \
+    $$SRC_DIR/TitleMatcher/titlematcher.h \
+    $$SRC_DIR/WindowEnumerator/windowenumerator.h \
+    $$SRC_DIR/WindowFilter/windowfilter.h \
+    $$SRC_DIR/WindowMatcher/windowmatcher.h \
+    $$SRC_DIR/WindowTable/windowtable.h \
+    benchmarkrunner.h \
+    detectorbenchmarks.h \
+    titlesets.h
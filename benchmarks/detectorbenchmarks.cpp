@@ -0,0 +1,166 @@
+#include "detectorbenchmarks.h"
+#include "bigpicturetitles.h"
+#include "fakeprocesssource.h"
+#include "fakewindowenumerator.h"
+#include "processtable.h"
+#include "rulematcher.h"
+#include "titlematcher.h"
+#include "titlesets.h"
+#include "windowfilter.h"
+#include "windowtable.h"
+
+namespace DetectorBenchmarks {
+
+namespace {
+
+const int RULE_COUNT = 32;
+
+// Stops at the first window the matcher accepts, like an unfiltered sweep without
+// window events.
+class FirstMatchVisitor : public WindowVisitor
+{
+public:
+    explicit FirstMatchVisitor(WindowMatcher &matcher)
+        : matcher(matcher)
+        , processId(0)
+        , result(-1)
+    {}
+
+    bool acceptWindow(quintptr window, const WindowAttributes &attributes) override
+    {
+        Q_UNUSED(window)
+        processId = attributes.processId;
+        return true;
+    }
+
+    bool visitWindow(quintptr window, QStringView title) override
+    {
+        Q_UNUSED(window)
+        result = matcher.matchWindow(title, processId);
+        return result < 0;
+    }
+
+    WindowMatcher &matcher;
+    quint32 processId;
+    int result;
+};
+
+TitleMatcher bigPictureMatcher()
+{
+    TitleMatcher matcher;
+    for (int entry = 0; entry < BigPictureTitles::COUNT; ++entry) {
+        BigPictureTitles::addTitle(matcher, entry);
+    }
+    return matcher;
+}
+
+// A mix of word, glob and regex rules that never fire, then one tied to the Steam web
+// helper that fires on the Big Picture window of every set.
+QList<RuleMatcher::Rule> customRules(int count)
+{
+    QList<RuleMatcher::Rule> rules;
+    for (int i = 0; i < count - 1; ++i) {
+        switch (i % 3) {
+        case 0:
+            rules.append(RuleMatcher::parseRule(QString("Project%1 Editor").arg(i)));
+            break;
+        case 1:
+            rules.append(RuleMatcher::parseRule(QString("*Session %1 -*").arg(i)));
+            break;
+        default:
+            rules.append(RuleMatcher::parseRule(QString("re:^Build #%1\\b").arg(i)));
+            break;
+        }
+    }
+    rules.append(RuleMatcher::parseRule("Steam", "steamwebhelper.exe"));
+    return rules;
+}
+
+void runSet(BenchmarkRunner &runner,
+            const TitleSets::Set &set,
+            TitleMatcher &matcher,
+            RuleMatcher &rules,
+            const ProcessTable &processes)
+{
+    FakeWindowEnumerator enumerator;
+    for (const FakeWindowEnumerator::Window &window : set.windows) {
+        enumerator.addWindow(window);
+    }
+
+    runner.run("titlematcher/" + set.name, [&]() {
+        for (const FakeWindowEnumerator::Window &window : set.windows) {
+            if (matcher.matchWindow(window.title, window.processId) >= 0) {
+                break;
+            }
+        }
+    });
+
+    runner.run("visit/" + set.name, [&]() {
+        FirstMatchVisitor visitor(matcher);
+        enumerator.visitWindows(visitor);
+    });
+
+    runner.run("rulematcher/" + set.name, [&]() {
+        FirstMatchVisitor visitor(rules);
+        enumerator.visitWindows(visitor);
+    });
+
+    SweepStats stats;
+    WindowTable table(&enumerator, &stats);
+    table.setMatcher(&matcher);
+    table.sweep();
+
+    runner.run("windowtable/" + set.name + "/steady", [&]() { table.sweep(); });
+
+    runner.run("windowtable/" + set.name + "/invalidated", [&]() {
+        table.invalidateAll();
+        table.sweep();
+    });
+
+    WindowFilter filter(&processes);
+    filter.setClassNames({"SDL_app"});
+    filter.setSkipToolWindows(true);
+    table.setFilter(&filter);
+    table.sweep();
+    runner.run("windowtable/" + set.name + "/filtered", [&]() {
+        table.invalidateAll();
+        table.sweep();
+    });
+    table.setFilter(nullptr);
+    table.sweep();
+
+    // One window changes its title every time, as a browser tab or media player would.
+    const FakeWindowEnumerator::Window &first = set.windows.first();
+    const QString titles[] = {first.title, first.title + " *"};
+    int current = 0;
+    runner.run("windowtable/" + set.name + "/retitled", [&]() {
+        current ^= 1;
+        enumerator.setTitle(first.handle, titles[current]);
+        table.invalidate(first.handle);
+        table.sweep();
+    });
+}
+
+} // namespace
+
+void run(BenchmarkRunner &runner)
+{
+    TitleMatcher matcher = bigPictureMatcher();
+
+    FakeProcessSource processSource;
+    processSource.addProcess(TitleSets::STEAM_WEB_HELPER_PROCESS_ID, "steamwebhelper.exe");
+    for (quint32 processId = 1000; processId < 1064; ++processId) {
+        processSource.addProcess(processId, "app.exe");
+    }
+    ProcessTable processes(&processSource);
+    processes.refresh();
+
+    RuleMatcher rules(&processes);
+    rules.setRules(customRules(RULE_COUNT));
+
+    for (const TitleSets::Set &set : TitleSets::all()) {
+        runSet(runner, set, matcher, rules, processes);
+    }
+}
+
+} // namespace DetectorBenchmarks
@@ -0,0 +1,14 @@
+#ifndef DETECTORBENCHMARKS_H
+#define DETECTORBENCHMARKS_H
+
+#include "benchmarkrunner.h"
+
+// The matching work behind isBigPictureRunning() and isCustomWindowRunning(), run
+// against every synthetic title set.
+namespace DetectorBenchmarks {
+
+void run(BenchmarkRunner &runner);
+
+} // namespace DetectorBenchmarks
+
+#endif // DETECTORBENCHMARKS_H
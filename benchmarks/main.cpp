@@ -0,0 +1,50 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include "benchmarkrunner.h"
+#include "detectorbenchmarks.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Window detection micro-benchmarks");
+    parser.addHelpOption();
+    QCommandLineOption filterOption("filter", "Only run benchmarks whose name contains <text>.", "text");
+    QCommandLineOption timeOption("min-time", "Minimum time per benchmark in milliseconds.", "ms", "200");
+    QCommandLineOption baselineOption("baseline", "Compare the results with a baseline JSON <file>.", "file");
+    QCommandLineOption writeOption("write-baseline", "Write the results as a baseline JSON <file>.", "file");
+    parser.addOptions({filterOption, timeOption, baselineOption, writeOption});
+    parser.process(app);
+
+    BenchmarkRunner runner(parser.value(filterOption), parser.value(timeOption).toInt());
+    DetectorBenchmarks::run(runner);
+
+    if (parser.isSet(writeOption)) {
+        QFile file(parser.value(writeOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning() << "Cannot write" << file.fileName();
+            return 2;
+        }
+        file.write(QJsonDocument(runner.toJson()).toJson());
+    }
+
+    if (parser.isSet(baselineOption)) {
+        QFile file(parser.value(baselineOption));
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning() << "Cannot read" << file.fileName();
+            return 2;
+        }
+        QJsonParseError error;
+        QJsonDocument baseline = QJsonDocument::fromJson(file.readAll(), &error);
+        if (!baseline.isObject()) {
+            qWarning() << "Invalid baseline" << file.fileName() << error.errorString();
+            return 2;
+        }
+        return runner.compare(baseline.object()) > 0 ? 1 : 0;
+    }
+    return 0;
+}
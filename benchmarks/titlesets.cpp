@@ -0,0 +1,105 @@
+#include "titlesets.h"
+#include <QRandomGenerator>
+#include <QStringList>
+#include <iterator>
+#include "bigpicturetitles.h"
+
+namespace TitleSets {
+
+namespace {
+
+struct Vocabulary
+{
+    const char *name;
+    QStringList words;
+    QString separator;
+    const char16_t *targetLanguage;
+};
+
+Vocabulary vocabulary(Script script)
+{
+    switch (script) {
+    case Nbsp:
+        // Browsers and chat clients put non-breaking spaces in their titles.
+        return {"nbsp",
+                {"Café", "Übersicht", "Paramètres", "Bibliothèque", "Téléchargements", "Steam", "Big",
+                 "Picture", "Amis", "Boutique", "Lecteur", "Document", "Modifié", "Navigateur"},
+                QString(QChar(0x00A0)),
+                u"french"};
+    case Cjk:
+        return {"cjk",
+                {"文档", "设置", "下载", "浏览器", "资源管理器", "好友", "商店", "游戏库", "大屏幕",
+                 "ゲーム", "ライブラリ", "設定", "메신저", "설정", "라이브러리"},
+                " ",
+                u"schinese"};
+    case Thai:
+        return {"thai",
+                {"หน้าแรก", "ตั้งค่า", "ดาวน์โหลด", "เอกสาร", "คลังเกม", "ร้านค้า", "เพื่อน", "โหมด",
+                 "เบราว์เซอร์", "ข้อความ"},
+                " ",
+                u"thai"};
+    case Ascii:
+    default:
+        return {"ascii",
+                {"Untitled", "Notepad", "Google", "Chrome", "Visual", "Studio", "Code", "Settings",
+                 "Discord", "Friends", "Library", "Store", "Downloads", "Document", "Explorer",
+                 "Terminal", "Steam", "Big", "Picture"},
+                " ",
+                u"english"};
+    }
+}
+
+const char *const CLASS_NAMES[] = {"Chrome_WidgetWin_1", "Notepad", "CabinetWClass", "ConsoleWindowClass",
+                                   "MozillaWindowClass", "SDL_app"};
+
+} // namespace
+
+Set make(Script script, int count)
+{
+    const Vocabulary words = vocabulary(script);
+    // A fixed seed keeps every run, and the baseline, on the same titles.
+    QRandomGenerator random(quint32(script) * 7919u + quint32(count));
+
+    Set set;
+    set.name = QString("%1-%2").arg(words.name).arg(count);
+    for (int i = 0; i < count - 1; ++i) {
+        QStringList title;
+        int length = 2 + random.bounded(5);
+        for (int word = 0; word < length; ++word) {
+            title.append(words.words[random.bounded(int(words.words.size()))]);
+        }
+
+        FakeWindowEnumerator::Window window;
+        window.handle = quintptr(0x10000 + i * 4);
+        window.title = title.join(words.separator);
+        window.className = CLASS_NAMES[random.bounded(int(std::size(CLASS_NAMES)))];
+        window.processId = 1000 + quint32(random.bounded(64));
+        window.toolWindow = random.bounded(8) == 0;
+        set.windows.append(window);
+    }
+
+    int entry = BigPictureTitles::findLanguage(words.targetLanguage);
+    FakeWindowEnumerator::Window target;
+    target.handle = quintptr(0x10000 + count * 4);
+    target.title = QString::fromUtf16(BigPictureTitles::ENTRIES[entry].title);
+    if (script == Nbsp) {
+        target.title.replace(' ', QChar(0x00A0));
+    }
+    target.className = "SDL_app";
+    target.processId = STEAM_WEB_HELPER_PROCESS_ID;
+    set.windows.append(target);
+    return set;
+}
+
+QList<Set> all()
+{
+    QList<Set> sets;
+    for (Script script : {Ascii, Nbsp, Cjk, Thai}) {
+        for (int count : {16, 256}) {
+            sets.append(make(script, count));
+        }
+    }
+    return sets;
+}
+
+} // namespace TitleSets
@@ -0,0 +1,33 @@
+#ifndef TITLESETS_H
+#define TITLESETS_H
+
+#include <QList>
+#include <QString>
+#include "fakewindowenumerator.h"
+
+// Synthetic desktops: windows with generated titles in one script, the last of which
+// is Big Picture in a matching language, owned by the Steam web helper.
+namespace TitleSets {
+
+enum Script {
+    Ascii,
+    Nbsp,
+    Cjk,
+    Thai
+};
+
+struct Set
+{
+    QString name;
+    QList<FakeWindowEnumerator::Window> windows;
+};
+
+const quint32 STEAM_WEB_HELPER_PROCESS_ID = 4242;
+
+Set make(Script script, int count);
+// Every script at a small and a large desktop size.
+QList<Set> all();
+
+} // namespace TitleSets
+
+#endif // TITLESETS_H
@@ -0,0 +1,38 @@
+#ifndef AUDIOBACKEND_H
+#define AUDIOBACKEND_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+struct AudioEndpoint
+{
+    // Opaque to callers; only passed back to setDefaultEndpoint().
+    std::string id;
+    std::string name;
+};
+
+// Lists playback endpoints and picks the default one. Implementations may throw
+// std::runtime_error when the underlying API fails.
+class AudioBackend
+{
+public:
+    virtual ~AudioBackend() {}
+
+    // Does slow set-up ahead of the first call, e.g. starting a helper process.
+    virtual void prepare() {}
+    virtual bool isAvailable() = 0;
+    virtual std::vector<AudioEndpoint> listEndpoints() = 0;
+    virtual std::string defaultEndpointName() = 0;
+    virtual bool setDefaultEndpoint(const AudioEndpoint &endpoint) = 0;
+
+    // Calls changed, from any thread, whenever endpoints appear, disappear or change
+    // state. Returns false when the backend cannot tell, in which case callers poll.
+    virtual bool watchEndpoints(const std::function<void()> &changed)
+    {
+        (void) changed;
+        return false;
+    }
+};
+
+#endif // AUDIOBACKEND_H
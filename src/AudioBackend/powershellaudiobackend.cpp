@@ -0,0 +1,138 @@
+#include "powershellaudiobackend.h"
+#include <QString>
+#include <charconv>
+#include <stdexcept>
+#include "powershellhost.h"
+
+const int PowerShellAudioBackend::COMMAND_TIMEOUT_MS = 15000;
+
+namespace {
+std::string_view trimmed(std::string_view text)
+{
+    const char *whitespace = " \t\r";
+    size_t first = text.find_first_not_of(whitespace);
+    if (first == std::string_view::npos) {
+        return std::string_view();
+    }
+    return text.substr(first, text.find_last_not_of(whitespace) - first + 1);
+}
+} // namespace
+
+PowerShellAudioBackend::PowerShellAudioBackend()
+    : shell(new PowerShellHost("powershell.exe", PowerShellHost::powerShellArguments({"AudioDeviceCmdlets"})))
+{}
+
+PowerShellAudioBackend::~PowerShellAudioBackend()
+{
+    delete shell;
+}
+
+void PowerShellAudioBackend::prepare()
+{
+    shell->prepare();
+}
+
+bool PowerShellAudioBackend::isAvailable()
+{
+    return true;
+}
+
+QByteArray PowerShellAudioBackend::executeCommand(const std::string &command)
+{
+    PowerShellHost::Result result = shell->execute(QString::fromStdString(command), COMMAND_TIMEOUT_MS);
+    if (!result.completed) {
+        throw std::runtime_error("PowerShell host failed: " + result.failure.toStdString());
+    }
+
+    if (!result.error.isEmpty()) {
+        throw std::runtime_error("PowerShell Error: " + result.error.toStdString());
+    }
+
+    return result.output;
+}
+
+std::vector<Device> PowerShellAudioBackend::parseDevices(std::string_view output)
+{
+    std::vector<Device> devices;
+    devices.reserve(20);
+    Device current{-1, "", ""};
+    bool hasIndex = false;
+
+    auto flush = [&]() {
+        if (hasIndex && current.index >= 0) {
+            devices.push_back(current);
+        }
+        current = Device{-1, "", ""};
+        hasIndex = false;
+    };
+
+    size_t position = 0;
+    while (position <= output.size()) {
+        size_t end = output.find('\n', position);
+        if (end == std::string_view::npos) {
+            end = output.size();
+        }
+        std::string_view line = trimmed(output.substr(position, end - position));
+        position = end + 1;
+
+        if (line.empty()) {
+            flush();
+            continue;
+        }
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            continue;
+        }
+        std::string_view key = trimmed(line.substr(0, colon));
+        std::string_view value = trimmed(line.substr(colon + 1));
+
+        // Keys are matched whole, so a device called "Type C Dock" is just a name.
+        if (key == "Index") {
+            // A second index without a blank line in between still starts a new record.
+            if (hasIndex) {
+                flush();
+            }
+            hasIndex = true;
+            int index = -1;
+            auto parsed = std::from_chars(value.data(), value.data() + value.size(), index);
+            current.index = (parsed.ec == std::errc() && parsed.ptr == value.data() + value.size()) ? index : -1;
+        } else if (key == "Name") {
+            current.name.assign(value.data(), value.size());
+        } else if (key == "Type") {
+            current.type.assign(value.data(), value.size());
+        }
+    }
+    flush();
+
+    return devices;
+}
+
+std::vector<AudioEndpoint> PowerShellAudioBackend::listEndpoints()
+{
+    QByteArray output = executeCommand("Get-AudioDevice -l");
+    std::vector<Device> devices = parseDevices(std::string_view(output.constData(), output.size()));
+    std::vector<AudioEndpoint> endpoints;
+    endpoints.reserve(devices.size());
+    for (const auto &device : devices) {
+        endpoints.push_back(AudioEndpoint{std::to_string(device.index), device.name});
+    }
+    return endpoints;
+}
+
+std::string PowerShellAudioBackend::defaultEndpointName()
+{
+    QByteArray output = executeCommand("Get-AudioDevice -p");
+    std::vector<Device> devices = parseDevices(std::string_view(output.constData(), output.size()));
+    return devices.empty() ? std::string() : devices.front().name;
+}
+
+bool PowerShellAudioBackend::setDefaultEndpoint(const AudioEndpoint &endpoint)
+{
+    int index = -1;
+    std::from_chars(endpoint.id.data(), endpoint.id.data() + endpoint.id.size(), index);
+    if (index < 1) {
+        throw std::runtime_error("Invalid device index: " + std::to_string(index));
+    }
+
+    return !executeCommand("Set-AudioDevice -Index " + endpoint.id).contains("Error");
+}
@@ -0,0 +1,45 @@
+#ifndef POWERSHELLAUDIOBACKEND_H
+#define POWERSHELLAUDIOBACKEND_H
+
+#include <QByteArray>
+#include <string_view>
+#include "audiobackend.h"
+
+class PowerShellHost;
+
+struct Device
+{
+    int index;
+    std::string name;
+    std::string type;
+};
+
+// Goes through the AudioDeviceCmdlets module; the fallback when the native backend
+// cannot be used.
+class PowerShellAudioBackend : public AudioBackend
+{
+public:
+    PowerShellAudioBackend();
+    ~PowerShellAudioBackend();
+
+    // Starts the PowerShell host early, so the first switch does not wait for it.
+    void prepare() override;
+    bool isAvailable() override;
+    std::vector<AudioEndpoint> listEndpoints() override;
+    std::string defaultEndpointName() override;
+    bool setDefaultEndpoint(const AudioEndpoint &endpoint) override;
+
+    // Reads Format-List style records ("Key : Value" lines, records apart by blank
+    // lines) in one pass without copying the output. Records without a valid index
+    // are dropped instead of failing the whole listing.
+    static std::vector<Device> parseDevices(std::string_view output);
+
+private:
+    QByteArray executeCommand(const std::string &command);
+
+    static const int COMMAND_TIMEOUT_MS;
+
+    PowerShellHost *shell;
+};
+
+#endif // POWERSHELLAUDIOBACKEND_H
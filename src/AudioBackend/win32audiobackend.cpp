@@ -0,0 +1,314 @@
+#include "win32audiobackend.h"
+#include <QString>
+#include <stdexcept>
+#include "powershellaudiobackend.h"
+#include <initguid.h>
+#include <mmdeviceapi.h>
+#include <functiondiscoverykeys_devpkey.h>
+
+namespace {
+// Not in the SDK headers. Only SetDefaultEndpoint is called; the methods before it
+// are declared to keep the vtable layout.
+// clang-format off
+interface DECLSPEC_UUID("f8679f50-850a-41cf-9c72-430f290290c8") IPolicyConfig : public IUnknown
+{
+    virtual HRESULT STDMETHODCALLTYPE GetMixFormat(PCWSTR, WAVEFORMATEX **) = 0;
+    virtual HRESULT STDMETHODCALLTYPE GetDeviceFormat(PCWSTR, INT, WAVEFORMATEX **) = 0;
+    virtual HRESULT STDMETHODCALLTYPE ResetDeviceFormat(PCWSTR) = 0;
+    virtual HRESULT STDMETHODCALLTYPE SetDeviceFormat(PCWSTR, WAVEFORMATEX *, WAVEFORMATEX *) = 0;
+    virtual HRESULT STDMETHODCALLTYPE GetProcessingPeriod(PCWSTR, INT, PINT64, PINT64) = 0;
+    virtual HRESULT STDMETHODCALLTYPE SetProcessingPeriod(PCWSTR, PINT64) = 0;
+    virtual HRESULT STDMETHODCALLTYPE GetShareMode(PCWSTR, struct DeviceShareMode *) = 0;
+    virtual HRESULT STDMETHODCALLTYPE SetShareMode(PCWSTR, struct DeviceShareMode *) = 0;
+    virtual HRESULT STDMETHODCALLTYPE GetPropertyValue(PCWSTR, const PROPERTYKEY &, PROPVARIANT *) = 0;
+    virtual HRESULT STDMETHODCALLTYPE SetPropertyValue(PCWSTR, const PROPERTYKEY &, PROPVARIANT *) = 0;
+    virtual HRESULT STDMETHODCALLTYPE SetDefaultEndpoint(PCWSTR, ERole) = 0;
+    virtual HRESULT STDMETHODCALLTYPE SetEndpointVisibility(PCWSTR, INT) = 0;
+};
+// clang-format on
+
+class DECLSPEC_UUID("870af99c-171d-4f9e-af0d-e63df40c2bc9") CPolicyConfigClient;
+
+// Balances CoInitializeEx for the calling thread. S_FALSE still needs balancing;
+// RPC_E_CHANGED_MODE means COM was already set up differently, which is fine too.
+class ComScope
+{
+public:
+    ComScope()
+        : result(CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED))
+    {}
+    ~ComScope()
+    {
+        if (SUCCEEDED(result)) {
+            CoUninitialize();
+        }
+    }
+
+private:
+    HRESULT result;
+};
+
+IMMDeviceEnumerator *createEnumerator()
+{
+    IMMDeviceEnumerator *enumerator = nullptr;
+    if (FAILED(CoCreateInstance(__uuidof(MMDeviceEnumerator),
+                                nullptr,
+                                CLSCTX_ALL,
+                                __uuidof(IMMDeviceEnumerator),
+                                reinterpret_cast<void **>(&enumerator)))) {
+        return nullptr;
+    }
+    return enumerator;
+}
+
+std::string friendlyName(IMMDevice *device)
+{
+    std::string name;
+    IPropertyStore *properties = nullptr;
+    if (SUCCEEDED(device->OpenPropertyStore(STGM_READ, &properties))) {
+        PROPVARIANT value;
+        PropVariantInit(&value);
+        if (SUCCEEDED(properties->GetValue(PKEY_Device_FriendlyName, &value)) && value.vt == VT_LPWSTR) {
+            name = QString::fromWCharArray(value.pwszVal).toStdString();
+        }
+        PropVariantClear(&value);
+        properties->Release();
+    }
+    return name;
+}
+
+std::string deviceId(IMMDevice *device)
+{
+    std::string id;
+    LPWSTR value = nullptr;
+    if (SUCCEEDED(device->GetId(&value))) {
+        id = QString::fromWCharArray(value).toStdString();
+        CoTaskMemFree(value);
+    }
+    return id;
+}
+} // namespace
+
+// Registered with the endpoint API, which calls it on its own threads. It only forwards
+// the news; listing the endpoints again is up to whoever is interested.
+class Win32AudioBackend::Watcher : public IMMNotificationClient
+{
+public:
+    explicit Watcher(const std::function<void()> &changed)
+        : references(1)
+        , changed(changed)
+        , com(CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED))
+        , enumerator(createEnumerator())
+    {}
+
+    bool start()
+    {
+        return enumerator && SUCCEEDED(enumerator->RegisterEndpointNotificationCallback(this));
+    }
+
+    // Must run on the thread that created the watcher, as it balances its COM setup.
+    void stop()
+    {
+        if (enumerator) {
+            enumerator->UnregisterEndpointNotificationCallback(this);
+            enumerator->Release();
+            enumerator = nullptr;
+        }
+        if (SUCCEEDED(com)) {
+            CoUninitialize();
+            com = E_FAIL;
+        }
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return InterlockedIncrement(&references);
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        ULONG count = InterlockedDecrement(&references);
+        if (count == 0) {
+            delete this;
+        }
+        return count;
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid, void **object) override
+    {
+        if (iid == __uuidof(IUnknown) || iid == __uuidof(IMMNotificationClient)) {
+            AddRef();
+            *object = static_cast<IMMNotificationClient *>(this);
+            return S_OK;
+        }
+        *object = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    HRESULT STDMETHODCALLTYPE OnDeviceStateChanged(LPCWSTR, DWORD) override
+    {
+        changed();
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE OnDeviceAdded(LPCWSTR) override
+    {
+        changed();
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE OnDeviceRemoved(LPCWSTR) override
+    {
+        changed();
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE OnDefaultDeviceChanged(EDataFlow, ERole, LPCWSTR) override
+    {
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE OnPropertyValueChanged(LPCWSTR, const PROPERTYKEY key) override
+    {
+        // Drivers often publish the real name only after the endpoint shows up.
+        if (IsEqualPropertyKey(key, PKEY_Device_FriendlyName)) {
+            changed();
+        }
+        return S_OK;
+    }
+
+private:
+    ~Watcher() {}
+
+    LONG references;
+    std::function<void()> changed;
+    HRESULT com;
+    IMMDeviceEnumerator *enumerator;
+};
+
+AudioBackend *createNativeAudioBackend()
+{
+    return new Win32AudioBackend();
+}
+
+AudioBackend *createFallbackAudioBackend()
+{
+    return new PowerShellAudioBackend();
+}
+
+Win32AudioBackend::Win32AudioBackend()
+    : availability(Unknown)
+    , watcher(nullptr)
+{}
+
+Win32AudioBackend::~Win32AudioBackend()
+{
+    if (watcher) {
+        watcher->stop();
+        watcher->Release();
+    }
+}
+
+bool Win32AudioBackend::isAvailable()
+{
+    if (availability == Unknown) {
+        ComScope com;
+        IMMDeviceEnumerator *enumerator = createEnumerator();
+        IPolicyConfig *policy = nullptr;
+        bool available = enumerator
+                         && SUCCEEDED(CoCreateInstance(__uuidof(CPolicyConfigClient),
+                                                       nullptr,
+                                                       CLSCTX_ALL,
+                                                       __uuidof(IPolicyConfig),
+                                                       reinterpret_cast<void **>(&policy)));
+        if (policy) {
+            policy->Release();
+        }
+        if (enumerator) {
+            enumerator->Release();
+        }
+        availability = available ? Available : Unavailable;
+    }
+    return availability == Available;
+}
+
+std::vector<AudioEndpoint> Win32AudioBackend::listEndpoints()
+{
+    ComScope com;
+    IMMDeviceEnumerator *enumerator = createEnumerator();
+    if (!enumerator) {
+        throw std::runtime_error("Failed to create the audio device enumerator.");
+    }
+
+    std::vector<AudioEndpoint> endpoints;
+    IMMDeviceCollection *collection = nullptr;
+    if (SUCCEEDED(enumerator->EnumAudioEndpoints(eRender, DEVICE_STATE_ACTIVE, &collection))) {
+        UINT count = 0;
+        collection->GetCount(&count);
+        endpoints.reserve(count);
+        for (UINT i = 0; i < count; ++i) {
+            IMMDevice *device = nullptr;
+            if (SUCCEEDED(collection->Item(i, &device))) {
+                endpoints.push_back(AudioEndpoint{deviceId(device), friendlyName(device)});
+                device->Release();
+            }
+        }
+        collection->Release();
+    }
+    enumerator->Release();
+    return endpoints;
+}
+
+std::string Win32AudioBackend::defaultEndpointName()
+{
+    ComScope com;
+    std::string name;
+    IMMDeviceEnumerator *enumerator = createEnumerator();
+    if (enumerator) {
+        IMMDevice *device = nullptr;
+        if (SUCCEEDED(enumerator->GetDefaultAudioEndpoint(eRender, eConsole, &device))) {
+            name = friendlyName(device);
+            device->Release();
+        }
+        enumerator->Release();
+    }
+    return name;
+}
+
+bool Win32AudioBackend::setDefaultEndpoint(const AudioEndpoint &endpoint)
+{
+    ComScope com;
+    IPolicyConfig *policy = nullptr;
+    if (FAILED(CoCreateInstance(__uuidof(CPolicyConfigClient),
+                                nullptr,
+                                CLSCTX_ALL,
+                                __uuidof(IPolicyConfig),
+                                reinterpret_cast<void **>(&policy)))) {
+        throw std::runtime_error("Failed to create the audio policy client.");
+    }
+
+    std::wstring id = QString::fromStdString(endpoint.id).toStdWString();
+    // The Sound control panel sets all three roles, so apps that follow either role
+    // end up on the same device.
+    bool succeeded = SUCCEEDED(policy->SetDefaultEndpoint(id.c_str(), eConsole))
+                     && SUCCEEDED(policy->SetDefaultEndpoint(id.c_str(), eMultimedia))
+                     && SUCCEEDED(policy->SetDefaultEndpoint(id.c_str(), eCommunications));
+    policy->Release();
+    return succeeded;
+}
+
+bool Win32AudioBackend::watchEndpoints(const std::function<void()> &changed)
+{
+    if (watcher) {
+        watcher->stop();
+        watcher->Release();
+    }
+    watcher = new Watcher(changed);
+    if (!watcher->start()) {
+        watcher->stop();
+        watcher->Release();
+        watcher = nullptr;
+        return false;
+    }
+    return true;
+}
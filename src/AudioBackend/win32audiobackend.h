@@ -0,0 +1,39 @@
+#ifndef WIN32AUDIOBACKEND_H
+#define WIN32AUDIOBACKEND_H
+
+#include "audiobackend.h"
+
+// Talks to the Windows endpoint API directly. The default device is set through
+// IPolicyConfig, the same undocumented interface the Sound control panel uses.
+class Win32AudioBackend : public AudioBackend
+{
+public:
+    Win32AudioBackend();
+    ~Win32AudioBackend();
+
+    bool isAvailable() override;
+    std::vector<AudioEndpoint> listEndpoints() override;
+    std::string defaultEndpointName() override;
+    bool setDefaultEndpoint(const AudioEndpoint &endpoint) override;
+    // The backend must be destroyed on the thread that started watching.
+    bool watchEndpoints(const std::function<void()> &changed) override;
+
+private:
+    class Watcher;
+
+    enum Availability {
+        Unknown,
+        Available,
+        Unavailable
+    };
+
+    Availability availability;
+    Watcher *watcher;
+};
+
+// The backends AudioManager() picks from: this one, and AudioDeviceCmdlets through
+// PowerShell when it cannot switch.
+AudioBackend *createNativeAudioBackend();
+AudioBackend *createFallbackAudioBackend();
+
+#endif // WIN32AUDIOBACKEND_H
@@ -1,136 +1,181 @@
-#include "AudioManager.h"
-#include <QProcess>
+#include "audiomanager.h"
+#include <QDebug>
+#include <QString>
 #include <algorithm>
-#include <cctype>
-#include <chrono>
-#include <sstream>
 #include <stdexcept>
-#include <thread>
-
-AudioManager::AudioManager() {}
-
-AudioManager::~AudioManager() {}
-
-std::string AudioManager::executeCommand(const std::string &command)
+#include "tracerecorder.h"
+#include "win32audiobackend.h"
+
+// Matches the old ten attempts half a second apart.
+const int AudioManager::SWITCH_TIMEOUT_MS = 5000;
+// Only used without notifications, or when an endpoint refused to become the default.
+const int AudioManager::RETRY_DELAY_MS = 500;
+
+AudioManager::AudioManager()
+    : AudioManager(createNativeAudioBackend(), createFallbackAudioBackend)
+{}
+
+AudioManager::AudioManager(AudioBackend *native, const std::function<AudioBackend *()> &createFallback)
+    : native(native)
+    , fallback(nullptr)
+    , backend(native)
+    , watching(false)
+    , generation(1)
+    , cachedGeneration(0)
 {
-    QProcess process;
-    process.setProgram("powershell.exe");
+    if (!native->isAvailable() && createFallback) {
+        qWarning() << "Native audio endpoint switching unavailable, using the fallback backend";
+        fallback = createFallback();
+        backend = fallback;
+    }
+    watching = backend->watchEndpoints([this]() { onEndpointsChanged(); });
+}
 
-    QStringList arguments;
-    arguments << "-Command" << QString::fromStdString(command);
-    process.setArguments(arguments);
+AudioManager::~AudioManager()
+{
+    // Deleting the backends stops notifications before the cache below goes away.
+    delete fallback;
+    delete native;
+}
 
-    process.start();
-    if (!process.waitForStarted()) {
-        throw std::runtime_error("Failed to start PowerShell process!");
-    }
-    if (!process.waitForFinished()) {
-        throw std::runtime_error("PowerShell process did not finish!");
+void AudioManager::prepare()
+{
+    if (fallback) {
+        fallback->prepare();
     }
+}
 
-    QByteArray output = process.readAllStandardOutput();
-    QByteArray error = process.readAllStandardError();
+std::string AudioManager::foldCase(const std::string &text)
+{
+    // Full Unicode folding; friendly names are often localized.
+    return QString::fromStdString(text).toCaseFolded().toStdString();
+}
 
-    if (!error.isEmpty()) {
-        throw std::runtime_error("PowerShell Error: " + error.toStdString());
+void AudioManager::onEndpointsChanged()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++generation;
     }
-
-    return output.toStdString();
+    changedCondition.notify_all();
 }
 
-std::vector<Device> AudioManager::parseDevices(const std::string &output)
+std::vector<AudioManager::Entry> AudioManager::currentEndpoints(unsigned long long &seen)
 {
-    std::vector<Device> devices;
-    devices.reserve(20);
-    std::istringstream stream(output);
-    std::string line;
-    Device currentDevice;
-    bool deviceStarted = false;
-
-    while (std::getline(stream, line)) {
-        if (line.find("Index") != std::string::npos) {
-            if (deviceStarted) {
-                devices.push_back(currentDevice);
-            }
-            currentDevice = Device{-1, "", ""};
-            deviceStarted = true;
-            currentDevice.index = std::stoi(line.substr(line.find(":") + 2));
-        } else if (line.find("Name") != std::string::npos) {
-            std::string_view lineView(line);
-            currentDevice.name = std::string(lineView.substr(lineView.find(":") + 2));
-        } else if (line.find("Type") != std::string::npos) {
-            std::string_view lineView(line);
-            currentDevice.type = std::string(lineView.substr(lineView.find(":") + 2));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        seen = generation;
+        if (watching && cachedGeneration == generation) {
+            return cachedEndpoints;
         }
     }
 
-    if (deviceStarted) {
-        devices.push_back(currentDevice);
+    // Listed outside the lock; a change meanwhile leaves the cache stale for the next read.
+    std::vector<Entry> entries;
+    for (auto &endpoint : backend->listEndpoints()) {
+        std::string folded = foldCase(endpoint.name);
+        entries.push_back(Entry{std::move(endpoint), std::move(folded)});
     }
-
-    return devices;
+    std::lock_guard<std::mutex> lock(mutex);
+    cachedEndpoints = entries;
+    cachedGeneration = seen;
+    return entries;
 }
 
-bool AudioManager::containsIgnoreCase(const std::string &str, const std::string &substr)
+bool AudioManager::waitForChange(unsigned long long seen, Clock::time_point until, const std::atomic<bool> *cancelled)
 {
-    std::string strLower = str;
-    std::string substrLower = substr;
-    std::transform(strLower.begin(), strLower.end(), strLower.begin(), ::tolower);
-    std::transform(substrLower.begin(), substrLower.end(), substrLower.begin(), ::tolower);
-    return strLower.find(substrLower) != std::string::npos;
+    // The flag is checked under the lock cancelWaits() takes, so a cancellation cannot
+    // slip in between the check and the wait.
+    std::unique_lock<std::mutex> lock(mutex);
+    changedCondition.wait_until(lock, until, [this, seen, cancelled]() {
+        return generation != seen || (cancelled && cancelled->load(std::memory_order_acquire));
+    });
+    return generation != seen;
 }
 
-bool AudioManager::checkDevice(const std::string &deviceName)
+void AudioManager::cancelWaits()
 {
-    std::string output = executeCommand("Get-AudioDevice -l");
-    std::vector<Device> devices = parseDevices(output);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+    }
+    changedCondition.notify_all();
+}
 
-    for (const auto &device : devices) {
-        if (containsIgnoreCase(device.name, deviceName)) {
+bool AudioManager::resolveDevice(const std::string &deviceName, AudioEndpoint &endpoint)
+{
+    if (!watching || deviceName.empty()) {
+        return false;
+    }
+    std::string folded = foldCase(deviceName);
+    unsigned long long seen;
+    for (const auto &entry : currentEndpoints(seen)) {
+        if (entry.foldedName.find(folded) != std::string::npos) {
+            endpoint = entry.endpoint;
             return true;
         }
     }
     return false;
 }
 
-void AudioManager::setAudioDevice(const std::string &deviceName)
+unsigned long long AudioManager::endpointGeneration()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return generation;
+}
+
+std::string AudioManager::getDefaultDeviceName()
 {
-    bool deviceFound = false;
-    int maxRetries = 10;
-    int retryCount = 0;
-    std::string result;
-
-    while (retryCount < maxRetries) {
-        std::string output = executeCommand("Get-AudioDevice -l");
-        std::vector<Device> devices = parseDevices(output);
-
-        for (const auto &device : devices) {
-            if (containsIgnoreCase(device.name, deviceName)) {
-                if (device.index < 1) {
-                    throw std::runtime_error("Invalid device index: "
-                                             + std::to_string(device.index));
-                }
-
-                std::string setCommand = "Set-AudioDevice -Index " + std::to_string(device.index);
-                result = executeCommand(setCommand);
-
-                if (result.find("Error") == std::string::npos) {
-                    deviceFound = true;
-                    break;
-                }
+    // Reading the default works even where switching it natively does not.
+    return native->defaultEndpointName();
+}
+
+void AudioManager::setAudioDevice(const std::string &deviceName,
+                                  const std::atomic<bool> *cancelled,
+                                  const std::string &preferredId)
+{
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(SWITCH_TIMEOUT_MS);
+    std::string folded = foldCase(deviceName);
+    int attempt = 0;
+
+    while (true) {
+        if (cancelled && cancelled->load(std::memory_order_acquire)) {
+            return;
+        }
+
+        unsigned long long seen;
+        std::vector<Entry> entries = currentEndpoints(seen);
+        if (!preferredId.empty()) {
+            std::stable_partition(entries.begin(), entries.end(), [&preferredId](const Entry &entry) {
+                return entry.endpoint.id == preferredId;
+            });
+        }
+        bool matched = false;
+        for (const auto &entry : entries) {
+            if (entry.foldedName.find(folded) == std::string::npos) {
+                continue;
+            }
+            matched = true;
+            ++attempt;
+            TraceRecorder::Span span(QStringLiteral("setAudioDevice attempt"), "audio");
+            if (span.isRecording()) {
+                span.setDetail(QString::number(attempt));
+            }
+            if (backend->setDefaultEndpoint(entry.endpoint)) {
+                return;
             }
         }
 
-        if (deviceFound) {
+        // With notifications an absent endpoint is simply waited for; otherwise, or when
+        // it is there but refused, only a retry later can help.
+        Clock::time_point until = deadline;
+        if (!watching || matched) {
+            until = std::min(deadline, Clock::now() + std::chrono::milliseconds(RETRY_DELAY_MS));
+        }
+        if (!waitForChange(seen, until, cancelled) && Clock::now() >= deadline) {
             break;
         }
-
-        ++retryCount;
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
     }
 
-    if (!deviceFound) {
-        throw std::runtime_error("Failed to set the audio device after "
-                                 + std::to_string(maxRetries) + " attempts.");
-    }
+    throw std::runtime_error("Audio device \"" + deviceName + "\" did not become available within "
+                             + std::to_string(SWITCH_TIMEOUT_MS) + " ms.");
 }
@@ -1,29 +1,75 @@
 #ifndef AUDIOMANAGER_H
 #define AUDIOMANAGER_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
 #include <string>
 #include <vector>
-
-struct Device
-{
-    int index;
-    std::string name;
-    std::string type;
-};
+#include "audiobackend.h"
 
 class AudioManager
 {
 public:
+    // Switches through the Windows endpoint API, or AudioDeviceCmdlets where it cannot.
     AudioManager();
+    // Takes ownership. The default device name is always read from native; createFallback
+    // is only called, once, when native cannot switch.
+    AudioManager(AudioBackend *native, const std::function<AudioBackend *()> &createFallback);
     ~AudioManager();
 
-    void setAudioDevice(const std::string &deviceName);
+    // Starts the fallback's PowerShell host early, so the first switch does not wait for it.
+    void prepare();
+
+    // Waits up to SWITCH_TIMEOUT_MS for a matching endpoint, e.g. the TV's HDMI output
+    // appearing after a display switch. Gives up quietly once cancelled is set; call
+    // cancelWaits() after setting it to end a wait right away. Among several matches,
+    // the one with preferredId is tried first.
+    void setAudioDevice(const std::string &deviceName,
+                        const std::atomic<bool> *cancelled = nullptr,
+                        const std::string &preferredId = std::string());
+    // Wakes every setAudioDevice() waiting for endpoints, so they see their flag.
+    void cancelWaits();
+    // Matches deviceName against the endpoints present now. Only answers from the cache
+    // kept by notifications, so it never waits on the PowerShell fallback.
+    bool resolveDevice(const std::string &deviceName, AudioEndpoint &endpoint);
+    // Moves whenever endpoints appear, disappear or change state.
+    unsigned long long endpointGeneration();
+    // Asks the audio endpoint API directly, no PowerShell involved.
+    std::string getDefaultDeviceName();
 
 private:
-    bool checkDevice(const std::string &deviceName);
-    std::string executeCommand(const std::string &command);
-    std::vector<Device> parseDevices(const std::string &output);
-    bool containsIgnoreCase(const std::string &str, const std::string &substr);
+    typedef std::chrono::steady_clock Clock;
+
+    // Names are folded once when listed, so lookups only fold the query.
+    struct Entry
+    {
+        AudioEndpoint endpoint;
+        std::string foldedName;
+    };
+
+    static std::string foldCase(const std::string &text);
+    void onEndpointsChanged();
+    std::vector<Entry> currentEndpoints(unsigned long long &generation);
+    bool waitForChange(unsigned long long generation, Clock::time_point until, const std::atomic<bool> *cancelled);
+
+    static const int SWITCH_TIMEOUT_MS;
+    static const int RETRY_DELAY_MS;
+
+    AudioBackend *native;
+    AudioBackend *fallback;
+    AudioBackend *backend;
+
+    // Refreshed lazily: notifications only bump the generation, the next reader lists
+    // the endpoints again. Without notifications every read lists them.
+    bool watching;
+    std::mutex mutex;
+    std::condition_variable changedCondition;
+    unsigned long long generation;
+    unsigned long long cachedGeneration;
+    std::vector<Entry> cachedEndpoints;
 };
 
 #endif // AUDIOMANAGER_H
@@ -3,43 +3,84 @@
 #include <QMessageBox>
 #include <QStandardPaths>
 #include <QJsonParseError>
-#include <QTimer>
+#include <QThread>
+#include <QDateTime>
 #include <QDir>
 #include <QFileInfo>
 
 const QString BigPictureTV::settingsFile = QStandardPaths::writableLocation(
                                                QStandardPaths::AppDataLocation)
                                            + "/BigPictureTV/settings.json";
+const QString BigPictureTV::tracesDir = QStandardPaths::writableLocation(
+                                            QStandardPaths::AppDataLocation)
+                                        + "/BigPictureTV/traces";
+
+// A Big Picture window that is briefly minimized or re-created should not trigger a
+// full round trip of display, audio and power plan changes.
+const int BigPictureTV::DEFAULT_ENTER_CONFIRM_MS = 0;
+const int BigPictureTV::DEFAULT_EXIT_CONFIRM_MS = 2000;
+const int BigPictureTV::DEFAULT_MIN_DWELL_MS = 5000;
+const int BigPictureTV::DEFAULT_CHECKRATE_MS = 1000;
+
+const QString BigPictureTV::BALANCED_POWER_PLAN = "381b4222-f694-41f0-9685-ff5bb260df2e";
+const QString BigPictureTV::PERFORMANCE_POWER_PLAN = "8c5e7fda-e8bf-4a96-9a85-a6e23a8c635c";
 
 BigPictureTV::BigPictureTV(QObject *parent)
     : QObject(parent)
     , utils(new Utils())
-    , steamWindowManager(new SteamWindowManager())
     , audioManager(new AudioManager())
     , nightLightSwitcher(new NightLightSwitcher())
     , configurator(nullptr)
     , activePowerPlan("")
     , nightLightState(false)
     , discordState(false)
-    , windowCheckTimer(new QTimer(this))
+    , detectionThread(new QThread(this))
+    , detectionWorker(new DetectionWorker())
+    , gamemodeApplied(false)
+    , transitionExecutor(new TransitionExecutor())
+    , transitionStartUs(0)
+    , transitionCancelled(false)
+    , restorePointTaken(false)
 {
+    TraceRecorder::instance()->setThreadName("gui");
+
+    // The worker creates its hooks and timers once its thread runs, before any of the
+    // calls queued below are delivered.
+    detectionWorker->moveToThread(detectionThread);
+    connect(detectionThread, &QThread::started, detectionWorker, &DetectionWorker::initialize);
+    connect(detectionThread, &QThread::finished, detectionWorker, &QObject::deleteLater);
+    connect(detectionWorker, &DetectionWorker::eventsAvailable, this, &BigPictureTV::onDetectionEvents);
+    detectionThread->start();
+    connect(transitionExecutor, &TransitionExecutor::finished, this, &BigPictureTV::onTransitionFinished);
+    // An audio switch waiting for its endpoint would otherwise sit out the timeout.
+    connect(transitionExecutor, &TransitionExecutor::cancelling, this, [this]() { audioManager->cancelWaits(); });
+
     loadSettings();
-    windowCheckTimer->setInterval(window_checkrate);
-    connect(windowCheckTimer, &QTimer::timeout, this, &BigPictureTV::checkWindowTitle);
-    windowCheckTimer->start();
+    onRegistryValueChanged(RegistryWatcher::SteamLanguage);
+    if (!configurator) {
+        startDetection();
+    }
     createTrayIcon();
+    connect(RegistryWatcher::instance(), &RegistryWatcher::valueChanged, this, &BigPictureTV::onRegistryValueChanged);
 }
 
 BigPictureTV::~BigPictureTV()
 {
+    // The worker deletes itself on its own thread once the event loop exits.
+    detectionThread->quit();
+    detectionThread->wait();
+
+    // Kills children that are still running, then waits for the actions using them.
+    ProcessRunner::instance()->shutdown();
+    delete transitionExecutor;
     delete utils;
-    delete steamWindowManager;
     delete audioManager;
     delete nightLightSwitcher;
-    delete windowCheckTimer;
     delete trayIcon;
     delete trayIconMenu;
     delete configAction;
+    delete saveTraceAction;
+    delete showPlanAction;
     delete quitAction;
     delete configurator;
 }
@@ -49,12 +90,19 @@ void BigPictureTV::createTrayIcon()
     trayIcon = new QSystemTrayIcon(utils->getIconForTheme(), this);
     trayIconMenu = new QMenu();
     configAction = new QAction(tr("Settings"), this);
+    saveTraceAction = new QAction(tr("Save Trace"), this);
+    showPlanAction = new QAction(tr("Transition Plan"), this);
     quitAction = new QAction(tr("Quit"), this);
 
     connect(configAction, &QAction::triggered, this, &BigPictureTV::showSettings);
+    connect(saveTraceAction, &QAction::triggered, this, &BigPictureTV::onSaveTraceTriggered);
+    connect(showPlanAction, &QAction::triggered, this, &BigPictureTV::onShowPlanTriggered);
     connect(quitAction, &QAction::triggered, this, &QApplication::quit);
 
+    saveTraceAction->setVisible(trace_transitions);
     trayIconMenu->addAction(configAction);
+    trayIconMenu->addAction(saveTraceAction);
+    trayIconMenu->addAction(showPlanAction);
     trayIconMenu->addAction(quitAction);
     trayIcon->setContextMenu(trayIconMenu);
 
@@ -62,100 +110,231 @@ void BigPictureTV::createTrayIcon()
     trayIcon->show();
 }
 
-void BigPictureTV::checkWindowTitle()
+void BigPictureTV::onRegistryValueChanged(RegistryWatcher::Value value)
 {
-    if (target_window_mode == 1 && custom_window_title == "") {
-        return;
+    if (value == RegistryWatcher::AppsUseLightTheme) {
+        trayIcon->setIcon(utils->getIconForTheme());
+    } else if (value == RegistryWatcher::SteamLanguage) {
+        QString language = getSteamLanguage();
+        QMetaObject::invokeMethod(detectionWorker, [this, language]() {
+            detectionWorker->setSteamLanguage(language);
+        }, Qt::QueuedConnection);
     }
+}
 
-    if (utils->isSunshineStreaming()) {
-        return;
-    }
+void BigPictureTV::startDetection()
+{
+    QMetaObject::invokeMethod(detectionWorker, [this]() { detectionWorker->start(); }, Qt::QueuedConnection);
+}
 
-    bool disableVideo = disable_monitor_switch;
-    bool disableAudio = disable_audio_switch;
-    bool isRunning;
-    if (target_window_mode == 0) {
-        isRunning = steamWindowManager->isBigPictureRunning();
-    } else {
-        isRunning = steamWindowManager->isCustomWindowRunning(custom_window_title);
-    }
+void BigPictureTV::stopDetection()
+{
+    QMetaObject::invokeMethod(detectionWorker, [this]() { detectionWorker->stop(); }, Qt::QueuedConnection);
+}
 
-    if (isRunning && !gamemodeActive) {
-        gamemodeActive = true;
-        handleActions(false);
-        handleMonitorChanges(false, disableVideo);
-        handleAudioChanges(false, disableAudio);
-    } else if (!isRunning && gamemodeActive) {
-        gamemodeActive = false;
-        handleActions(true);
-        handleMonitorChanges(true, disableVideo);
-        handleAudioChanges(true, disableAudio);
+void BigPictureTV::onDetectionEvents()
+{
+    detectionWorker->rearm();
+
+    DetectionWorker::Event event;
+    while (detectionWorker->takeEvent(event)) {
+        if (!event.detail.isEmpty()) {
+            qDebug() << event.detail;
+        }
     }
+
+    // Only the latest state is acted on, so a burst like enter, exit, enter costs at
+    // most one transition.
+    applyGamemode(detectionWorker->isGamemodeActive());
 }
 
-void BigPictureTV::handleMonitorChanges(bool isDesktopMode, bool disableVideo)
+void BigPictureTV::applyGamemode(bool active)
 {
-    if (disableVideo)
+    // A newer target supersedes the running transition. It stops at the next action
+    // boundary or retry, and its finish handler heads for whatever is current then.
+    if (transitionExecutor->isRunning()) {
+        if (active != gamemodeApplied) {
+            transitionExecutor->cancel();
+        }
         return;
+    }
+    // A cancelled transition left its target half applied; going there again only
+    // runs what is missing, since actions skip states that are already in place.
+    if (active == gamemodeApplied && !transitionCancelled) {
+        return;
+    }
+    gamemodeApplied = active;
+    transitionCancelled = false;
+
+    // The state to come back to is taken when leaving the desktop, not when
+    // re-entering after an interrupted exit, which would find it half undone.
+    if (active && !restorePointTaken) {
+        restorePointTaken = true;
+        discordState = false;
+        nightLightState = false;
+        activePowerPlan = utils->getActivePowerPlan();
+    }
+    transitionStartUs = TraceRecorder::instance()->now();
+
+    const TransitionPlan::Step &step = plan.step(!active);
+    transitionExecutor->clear();
+    handleActions(!active, step);
+    handleMonitorChanges(step);
+    handleAudioChanges(step);
+    transitionExecutor->start();
+}
 
-    int index = isDesktopMode ? desktop_monitor_mode
-                              : gamemode_monitor_mode;
+void BigPictureTV::onTransitionFinished()
+{
+    qDebug() << "Transition finished:" << transitionExecutor->report();
+    qDebug() << "Child processes:" << ProcessRunner::instance()->takeSummary();
+    transitionCancelled = transitionExecutor->wasCancelled();
+    if (!gamemodeApplied && !transitionCancelled) {
+        restorePointTaken = false;
+    }
 
-    const char *command = nullptr;
+    // Switching displays makes audio endpoints come and go, so the resolved devices are
+    // likely stale now; resolving them here keeps that work off the next transition.
+    if (audioManager->endpointGeneration() != plan.endpointGeneration) {
+        buildTransitionPlan();
+    }
 
-    if (index == 0) {
-        command = isDesktopMode ? "/internal" : "/external";
-    } else if (index == 1) {
-        command = isDesktopMode ? "/extend" : "/clone";
+    TraceRecorder *recorder = TraceRecorder::instance();
+    if (recorder->isEnabled()) {
+        recorder->record(gamemodeApplied ? QStringLiteral("enter gamemode") : QStringLiteral("exit gamemode"),
+                         "transition",
+                         transitionStartUs,
+                         recorder->now() - transitionStartUs);
+        // Each file holds the detection leading up to one transition and the transition itself.
+        QString path = saveTrace("transition");
+        if (!path.isEmpty()) {
+            qDebug() << "Transition trace written to" << path;
+            recorder->clear();
+        }
     }
 
-    if (command) {
-        utils->runEnhancedDisplayswitch(command);
+    applyGamemode(detectionWorker->isGamemodeActive());
+}
+
+void BigPictureTV::onSaveTraceTriggered()
+{
+    QString path = saveTrace("trace");
+    if (!path.isEmpty()) {
+        trayIcon->showMessage("BigPictureTV", tr("Trace saved to %1").arg(QDir::toNativeSeparators(path)));
     }
 }
 
-void BigPictureTV::handleAudioChanges(bool isDesktopMode, bool disableAudio)
+void BigPictureTV::onShowPlanTriggered()
 {
-    if (disableAudio)
+    if (audioManager->endpointGeneration() != plan.endpointGeneration) {
+        buildTransitionPlan();
+    }
+    QMessageBox::information(nullptr, tr("Transition Plan"), plan.describe());
+}
+
+QString BigPictureTV::saveTrace(const QString &prefix)
+{
+    QString path = QString("%1/%2-%3.json")
+                       .arg(tracesDir, prefix, QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss-zzz"));
+    return TraceRecorder::instance()->writeChromeTrace(path) ? path : QString();
+}
+
+void BigPictureTV::handleMonitorChanges(const TransitionPlan::Step &step)
+{
+    if (step.displayCommand.isEmpty())
         return;
 
-    QString audioDevice = isDesktopMode ? desktop_audio_device
-                                            : gamemode_audio_device;
+    QString command = step.displayCommand;
+    TransitionExecutor::StateCheck check;
+    check.currentState = [this]() { return utils->getDisplayTopology(); };
+    check.desiredState = command;
+    transitionExecutor->addAction("display", {}, [this, command]() {
+        utils->runEnhancedDisplayswitch(command);
+    }, TransitionExecutor::Pool, check);
+}
 
-    audioManager->setAudioDevice(audioDevice.toStdString());
+void BigPictureTV::handleAudioChanges(const TransitionPlan::Step &step)
+{
+    if (step.audioDevice.isEmpty())
+        return;
 
-    try {
-        audioManager->setAudioDevice(audioDevice.toStdString());
-    } catch (const std::runtime_error &e) {
-        qDebug() << "Error: " << e.what();
-    }
+    QString audioDevice = step.audioDevice;
+    std::string preferredId = step.audioEndpointId.toStdString();
+
+    // Devices are matched by name fragment, so a default endpoint containing the
+    // configured name already counts as switched.
+    TransitionExecutor::StateCheck check;
+    check.currentState = [this, audioDevice]() {
+        QString current = QString::fromStdString(audioManager->getDefaultDeviceName());
+        return current.contains(audioDevice, Qt::CaseInsensitive) ? audioDevice : current;
+    };
+    check.desiredState = audioDevice;
+
+    // The target endpoint may only appear once the display has switched.
+    transitionExecutor->addAction("audio", {"display"}, [this, audioDevice, preferredId]() {
+        try {
+            audioManager->setAudioDevice(audioDevice.toStdString(), transitionExecutor->cancellationFlag(), preferredId);
+        } catch (const std::runtime_error &e) {
+            qDebug() << "Error: " << e.what();
+        }
+    }, TransitionExecutor::Pool, check);
 }
 
-void BigPictureTV::handleActions(bool isDesktopMode)
+void BigPictureTV::handleActions(bool isDesktopMode, const TransitionPlan::Step &step)
 {
-    if (close_discord_action) {
-        handleDiscordAction(isDesktopMode);
+    // Leaving gamemode only restores what entering it changed, so the checks that
+    // run on the way in also record the state to come back to. They run on the
+    // action's thread; the recorded state is only read again between transitions.
+    if (step.closeDiscord && (!isDesktopMode || discordState)) {
+        TransitionExecutor::StateCheck check;
+        check.currentState = [this, isDesktopMode]() {
+            bool running = utils->isDiscordRunning();
+            if (!isDesktopMode) {
+                discordState = discordState || running;
+            }
+            return QString(running ? "running" : "stopped");
+        };
+        check.desiredState = isDesktopMode ? "running" : "stopped";
+        transitionExecutor->addAction("discord", {}, [this, isDesktopMode]() {
+            handleDiscordAction(isDesktopMode);
+        }, TransitionExecutor::Pool, check);
     }
-    if (disable_nightlight_action) {
-        handleNightLightAction(isDesktopMode);
+    if (step.nightLight && (!isDesktopMode || nightLightState)) {
+        TransitionExecutor::StateCheck check;
+        check.currentState = [this, isDesktopMode]() {
+            bool enabled = nightLightSwitcher->enabled();
+            if (!isDesktopMode) {
+                nightLightState = nightLightState || enabled;
+            }
+            return QString(enabled ? "on" : "off");
+        };
+        check.desiredState = isDesktopMode ? "on" : "off";
+        // Reads the state through RegistryWatcher, which lives on this thread.
+        transitionExecutor->addAction("nightlight", {}, [this, isDesktopMode]() {
+            handleNightLightAction(isDesktopMode);
+        }, TransitionExecutor::OwnerThread, check);
     }
-    if (performance_powerplan_action) {
-        handlePowerPlanAction(isDesktopMode);
+    if (step.powerPlan) {
+        TransitionExecutor::StateCheck check;
+        // Runs on a pool thread, where RegistryWatcher must not be used.
+        check.currentState = [this]() { return utils->readActivePowerPlan(); };
+        check.desiredState = step.powerPlanGuid.isEmpty() ? desktopPowerPlan() : step.powerPlanGuid;
+        transitionExecutor->addAction("powerplan", {}, [this, isDesktopMode]() {
+            handlePowerPlanAction(isDesktopMode);
+        }, TransitionExecutor::Pool, check);
     }
-    if (pause_media_action) {
-        handleMediaAction(isDesktopMode);
+    if (step.pauseMedia) {
+        transitionExecutor->addAction("media", {}, [this, isDesktopMode]() {
+            handleMediaAction(isDesktopMode);
+        });
     }
 }
 
 void BigPictureTV::handleDiscordAction(bool isDesktopMode)
 {
     if (isDesktopMode) {
-        if (discordState) {
-            utils->startDiscord();
-        }
+        utils->startDiscord();
     } else {
-        discordState = utils->isDiscordRunning();
         utils->closeDiscord();
     }
 }
@@ -163,11 +342,8 @@ void BigPictureTV::handleDiscordAction(bool isDesktopMode)
 void BigPictureTV::handleNightLightAction(bool isDesktopMode)
 {
     if (isDesktopMode) {
-        if (nightLightState) {
-            nightLightSwitcher->enable();
-        }
+        nightLightSwitcher->enable();
     } else {
-        nightLightState = nightLightSwitcher->enabled();
         nightLightSwitcher->disable();
     }
 }
@@ -179,22 +355,42 @@ void BigPictureTV::handleMediaAction(bool isDesktopMode)
     }
 }
 
+QString BigPictureTV::desktopPowerPlan() const
+{
+    return activePowerPlan.isEmpty() ? BALANCED_POWER_PLAN : activePowerPlan;
+}
+
 void BigPictureTV::handlePowerPlanAction(bool isDesktopMode)
 {
-    if (isDesktopMode) {
-        if (!activePowerPlan.isEmpty()) {
-            utils->setPowerPlan(activePowerPlan);
-        } else {
-            utils->setPowerPlan("381b4222-f694-41f0-9685-ff5bb260df2e");
-        }
-    } else {
-        activePowerPlan = utils->getActivePowerPlan();
-        utils->setPowerPlan("8c5e7fda-e8bf-4a96-9a85-a6e23a8c635c");
-    }
+    utils->setPowerPlan(isDesktopMode ? desktopPowerPlan() : PERFORMANCE_POWER_PLAN);
 }
 
 void BigPictureTV::loadSettings()
 {
+    // Used while there is no readable settings file: detection runs, but nothing is
+    // switched until the settings are saved.
+    settings = QJsonObject();
+    gamemode_audio_device.clear();
+    desktop_audio_device.clear();
+    disable_audio_switch = true;
+    window_checkrate = DEFAULT_CHECKRATE_MS;
+    close_discord_action = false;
+    performance_powerplan_action = false;
+    pause_media_action = false;
+    gamemode_monitor_mode = 0;
+    desktop_monitor_mode = 0;
+    disable_monitor_switch = true;
+    disable_nightlight_action = false;
+    target_window_mode = 0;
+    custom_window_title.clear();
+    custom_process.clear();
+    custom_window_class.clear();
+    custom_window_rules = QJsonArray();
+    enter_confirm_ms = DEFAULT_ENTER_CONFIRM_MS;
+    exit_confirm_ms = DEFAULT_EXIT_CONFIRM_MS;
+    min_dwell_ms = DEFAULT_MIN_DWELL_MS;
+    trace_transitions = false;
+
     QDir settingsDir(QFileInfo(settingsFile).absolutePath());
     if (!settingsDir.exists()) {
         settingsDir.mkpath(settingsDir.absolutePath());
@@ -214,7 +410,7 @@ void BigPictureTV::loadSettings()
                 gamemode_audio_device = settings.value("gamemode_audio_device").toString();
                 desktop_audio_device = settings.value("desktop_audio_device").toString();
                 disable_audio_switch = settings.value("disable_audio_switch").toBool();
-                window_checkrate = settings.value("window_checkrate").toInt();
+                window_checkrate = settings.value("window_checkrate").toInt(DEFAULT_CHECKRATE_MS);
                 close_discord_action = settings.value("close_discord_action").toBool();
                 performance_powerplan_action = settings.value("performance_powerplan_action").toBool();
                 pause_media_action = settings.value("pause_media_action").toBool();
@@ -224,10 +420,109 @@ void BigPictureTV::loadSettings()
                 disable_nightlight_action = settings.value("disable_nightlight_action").toBool();
                 target_window_mode = settings.value("target_window_mode").toInt();
                 custom_window_title = settings.value("custom_window_title").toString();
+                custom_process = settings.value("custom_process").toString();
+                custom_window_class = settings.value("custom_window_class").toString();
+                custom_window_rules = settings.value("custom_window_rules").toArray();
+                enter_confirm_ms = settings.value("enter_confirm_ms").toInt(DEFAULT_ENTER_CONFIRM_MS);
+                exit_confirm_ms = settings.value("exit_confirm_ms").toInt(DEFAULT_EXIT_CONFIRM_MS);
+                min_dwell_ms = settings.value("min_dwell_ms").toInt(DEFAULT_MIN_DWELL_MS);
+                trace_transitions = settings.value("trace_transitions").toBool();
             }
             file.close();
         }
     }
+
+    TraceRecorder::instance()->setEnabled(trace_transitions);
+    if (!disable_audio_switch) {
+        audioManager->prepare();
+    }
+    buildTransitionPlan();
+
+    DetectionWorker::Config config;
+    config.targetMode = target_window_mode;
+    config.checkrate = window_checkrate;
+    config.customWindowClasses = custom_window_class.split(',', Qt::SkipEmptyParts);
+    config.customProcess = custom_process;
+    config.enterConfirmMs = enter_confirm_ms;
+    config.exitConfirmMs = exit_confirm_ms;
+    config.minDwellMs = min_dwell_ms;
+
+    // The configured title keeps its plain word-set meaning; extra rules are given as
+    // "pattern" or {"match": "pattern", "process": "image.exe"}.
+    if (!custom_window_title.isEmpty()) {
+        RuleMatcher::Rule titleRule;
+        titleRule.pattern = custom_window_title;
+        config.customRules.append(titleRule);
+    }
+    for (const QJsonValue &value : std::as_const(custom_window_rules)) {
+        if (value.isObject()) {
+            QJsonObject rule = value.toObject();
+            config.customRules.append(
+                RuleMatcher::parseRule(rule.value("match").toString(), rule.value("process").toString()));
+        } else {
+            config.customRules.append(RuleMatcher::parseRule(value.toString()));
+        }
+    }
+
+    QMetaObject::invokeMethod(detectionWorker, [this, config]() {
+        detectionWorker->configure(config);
+    }, Qt::QueuedConnection);
+}
+
+void BigPictureTV::buildTransitionPlan()
+{
+    TransitionPlan next;
+    // Read before resolving, so a change in the middle leaves the plan marked stale.
+    next.endpointGeneration = audioManager->endpointGeneration();
+
+    next.enter.closeDiscord = next.exit.closeDiscord = close_discord_action;
+    next.enter.nightLight = next.exit.nightLight = disable_nightlight_action && nightLightSwitcher->supported();
+    next.enter.pauseMedia = pause_media_action;
+
+    if (performance_powerplan_action) {
+        if (!utils->powerPlanExists(PERFORMANCE_POWER_PLAN)) {
+            next.warnings << "High performance power plan not found, power plan switching is off";
+        } else {
+            next.enter.powerPlan = next.exit.powerPlan = true;
+            next.enter.powerPlanGuid = PERFORMANCE_POWER_PLAN;
+            if (!utils->powerPlanExists(BALANCED_POWER_PLAN)) {
+                next.warnings << "Balanced power plan not found, it is the fallback when leaving gamemode";
+            }
+        }
+    }
+
+    if (!disable_monitor_switch) {
+        const QString enterCommands[] = {"/external", "/clone"};
+        const QString exitCommands[] = {"/internal", "/extend"};
+        if (gamemode_monitor_mode == 0 || gamemode_monitor_mode == 1) {
+            next.enter.displayCommand = enterCommands[gamemode_monitor_mode];
+        }
+        if (desktop_monitor_mode == 0 || desktop_monitor_mode == 1) {
+            next.exit.displayCommand = exitCommands[desktop_monitor_mode];
+        }
+    }
+
+    if (!disable_audio_switch) {
+        next.enter.audioDevice = gamemode_audio_device;
+        next.exit.audioDevice = desktop_audio_device;
+        for (TransitionPlan::Step *step : {&next.enter, &next.exit}) {
+            AudioEndpoint endpoint;
+            // Only a head start: the switch itself looks the device up again.
+            try {
+                if (audioManager->resolveDevice(step->audioDevice.toStdString(), endpoint)) {
+                    step->audioEndpointId = QString::fromStdString(endpoint.id);
+                    step->audioEndpointName = QString::fromStdString(endpoint.name);
+                }
+            } catch (const std::runtime_error &e) {
+                next.warnings << QString("Could not look up audio device %1: %2").arg(step->audioDevice, QString::fromLocal8Bit(e.what()));
+            }
+        }
+    }
+
+    plan = next;
+    for (const QString &warning : std::as_const(plan.warnings)) {
+        qWarning() << warning;
+    }
 }
 
 void BigPictureTV::showSettings()
@@ -239,7 +534,7 @@ void BigPictureTV::showSettings()
         return;
     }
 
-    windowCheckTimer->stop();
+    stopDetection();
     configurator = new Configurator;
     configurator->setAttribute(Qt::WA_DeleteOnClose);
     connect(configurator, &Configurator::closed, this, &BigPictureTV::onConfiguratorClosed);
@@ -250,6 +545,6 @@ void BigPictureTV::onConfiguratorClosed()
 {
     configurator = nullptr;
     loadSettings();
-    windowCheckTimer->setInterval(window_checkrate);
-    windowCheckTimer->start();
+    saveTraceAction->setVisible(trace_transitions);
+    startDetection();
 }
@@ -4,12 +4,19 @@
 #include <QSystemTrayIcon>
 #include <QMenu>
 #include <QAction>
+#include <QJsonArray>
 #include <QJsonObject>
+#include <QThread>
 #include "utils.h"
-#include "steamwindowmanager.h"
 #include "audiomanager.h"
 #include "NightLightSwitcher.h"
 #include "configurator.h"
+#include "registrywatcher.h"
+#include "detectionworker.h"
+#include "processrunner.h"
+#include "transitionexecutor.h"
+#include "transitionplan.h"
+#include "tracerecorder.h"
 
 class BigPictureTV : public QObject
 {
@@ -21,10 +28,14 @@ public:
 
 private slots:
     void onConfiguratorClosed();
+    void onRegistryValueChanged(RegistryWatcher::Value value);
+    void onDetectionEvents();
+    void onTransitionFinished();
+    void onSaveTraceTriggered();
+    void onShowPlanTriggered();
 
 private:
     Utils* utils;
-    SteamWindowManager* steamWindowManager;
     AudioManager* audioManager;
     NightLightSwitcher* nightLightSwitcher;
     Configurator* configurator;
@@ -34,25 +45,42 @@ private:
     bool discordState;
 
     QSystemTrayIcon *trayIcon;
-    QTimer *windowCheckTimer;
+    QThread *detectionThread;
+    DetectionWorker *detectionWorker;
+    bool gamemodeApplied;
+    TransitionExecutor *transitionExecutor;
+    qint64 transitionStartUs;
+    bool transitionCancelled;
+    bool restorePointTaken;
+    TransitionPlan plan;
     QMenu *trayIconMenu;
     QAction *quitAction;
     QAction *configAction;
+    QAction *saveTraceAction;
+    QAction *showPlanAction;
     void loadSettings();
+    void buildTransitionPlan();
     void createTrayIcon();
     void handleMediaAction(bool isDesktopMode);
     void handlePowerPlanAction(bool isDesktopMode);
+    QString desktopPowerPlan() const;
     void handleNightLightAction(bool isDesktopMode);
     void handleDiscordAction(bool isDesktopMode);
-    void handleActions(bool isDesktopMode);
-    void handleAudioChanges(bool isDesktopMode, bool disableAudio);
-    void handleMonitorChanges(bool isDesktopMode, bool disableVideo);
-    void checkWindowTitle();
+    void handleActions(bool isDesktopMode, const TransitionPlan::Step &step);
+    void handleAudioChanges(const TransitionPlan::Step &step);
+    void handleMonitorChanges(const TransitionPlan::Step &step);
+    void applyGamemode(bool active);
+    void startDetection();
+    void stopDetection();
     void showSettings();
+    QString saveTrace(const QString &prefix);
 
     QString gamemode_audio_device;
     QString desktop_audio_device;
     QString custom_window_title;
+    QString custom_process;
+    QString custom_window_class;
+    QJsonArray custom_window_rules;
     bool disable_audio_switch;
     int window_checkrate;
     bool close_discord_action;
@@ -62,11 +90,21 @@ private:
     int desktop_monitor_mode;
     bool disable_monitor_switch;
     bool disable_nightlight_action;
-    bool target_window_mode;
+    int target_window_mode;
+    int enter_confirm_ms;
+    int exit_confirm_ms;
+    int min_dwell_ms;
+    bool trace_transitions;
 
-    bool gamemodeActive;
     QJsonObject settings;
     static const QString settingsFile;
+    static const QString tracesDir;
+    static const int DEFAULT_ENTER_CONFIRM_MS;
+    static const int DEFAULT_EXIT_CONFIRM_MS;
+    static const int DEFAULT_MIN_DWELL_MS;
+    static const int DEFAULT_CHECKRATE_MS;
+    static const QString BALANCED_POWER_PLAN;
+    static const QString PERFORMANCE_POWER_PLAN;
 
 };
 
@@ -4,19 +4,21 @@
 #include <QDesktopServices>
 #include <QJsonParseError>
 #include <QMessageBox>
-#include <QProcess>
 #include <QStandardPaths>
+#include "win32audiobackend.h"
 
 const QString Configurator::settingsFile = QStandardPaths::writableLocation(
                                                QStandardPaths::AppDataLocation)
                                            + "/BigPictureTV/settings.json";
+// Installing pulls the module from the PowerShell Gallery.
+const int Configurator::INSTALL_TIMEOUT_MS = 300000;
 
 Configurator::Configurator(QWidget *parent)
     : QMainWindow(parent)
     , utils(new Utils())
     , shortcutManager(new ShortcutManager())
-    , steamWindowManager(new SteamWindowManager())
     , ui(new Ui::Configurator)
+    , customTargetMode(0)
 {
     ui->setupUi(this);
     setupInfoTab();
@@ -32,7 +34,6 @@ Configurator::~Configurator()
     emit closed();
     delete shortcutManager;
     delete utils;
-    delete steamWindowManager;
     delete ui;
 }
 
@@ -67,18 +68,31 @@ void Configurator::initDiscordAction()
 
 void Configurator::getAudioCapabilities()
 {
-    if (!utils->isAudioDeviceCmdletsInstalled()) {
-        ui->disableAudioCheckBox->setChecked(true);
-        ui->disableAudioCheckBox->setEnabled(false);
-        toggleAudioSettings(false);
-    } else {
+    // The module is only needed when the endpoint API cannot switch devices itself.
+    if (Win32AudioBackend().isAvailable()) {
         ui->disableAudioCheckBox->setEnabled(true);
         ui->installAudioButton->setEnabled(false);
-        ui->installAudioButton->setText(tr("Audio module installed"));
+        ui->installAudioButton->setText(tr("Audio module not needed"));
         if (!ui->disableAudioCheckBox->isChecked()) {
             toggleAudioSettings(true);
         }
+        return;
     }
+
+    utils->isAudioDeviceCmdletsInstalled().then(this, [this](bool installed) {
+        if (!installed) {
+            ui->disableAudioCheckBox->setChecked(true);
+            ui->disableAudioCheckBox->setEnabled(false);
+            toggleAudioSettings(false);
+        } else {
+            ui->disableAudioCheckBox->setEnabled(true);
+            ui->installAudioButton->setEnabled(false);
+            ui->installAudioButton->setText(tr("Audio module installed"));
+            if (!ui->disableAudioCheckBox->isChecked()) {
+                toggleAudioSettings(true);
+            }
+        }
+    });
 }
 
 void Configurator::populateComboboxes()
@@ -90,6 +104,7 @@ void Configurator::populateComboboxes()
 
     ui->targetWindowComboBox->addItem(tr("Big Picture"));
     ui->targetWindowComboBox->addItem(tr("Custom"));
+    ui->targetWindowComboBox->addItem(tr("Process"));
 }
 
 void Configurator::onStartupCheckboxStateChanged()
@@ -111,32 +126,55 @@ void Configurator::onDisableMonitorCheckboxStateChanged(int state)
 
 void Configurator::onTargetWindowComboBoxIndexChanged(int index)
 {
-    if (index == 1) {
-        toggleCustomWindowTitle(true);
+    syncCustomTarget();
+    showCustomTarget(index);
+}
+
+void Configurator::syncCustomTarget()
+{
+    if (customTargetMode == 2) {
+        customProcess = ui->customWindowLineEdit->text();
     } else {
-        toggleCustomWindowTitle(false);
+        customWindowTitle = ui->customWindowLineEdit->text();
     }
 }
 
+void Configurator::showCustomTarget(int index)
+{
+    // The custom field holds a window title or, in process mode, "image.exe [arguments]".
+    customTargetMode = index;
+    bool processMode = (index == 2);
+    ui->customWindowLabel->setText(processMode ? tr("Custom process") : tr("Custom window title"));
+    ui->customWindowLineEdit->setPlaceholderText(processMode ? "steamwebhelper.exe -gamepadui" : QString());
+    ui->customWindowLineEdit->setText(processMode ? customProcess : customWindowTitle);
+    toggleCustomWindowTitle(index != 0);
+}
+
 void Configurator::onAudioButtonClicked()
 {
     ui->installAudioButton->setEnabled(false);
 
-    QProcess process;
-    process.start(
+    ProcessRunner::Request request{
         "powershell",
         QStringList() << "-NoProfile" << "-ExecutionPolicy" << "Bypass" << "-Command"
                       << "Install-PackageProvider -Name NuGet -Force -Scope CurrentUser; "
-                         "Install-Module -Name AudioDeviceCmdlets -Force -Scope CurrentUser");
+                         "Install-Module -Name AudioDeviceCmdlets -Force -Scope CurrentUser",
+        INSTALL_TIMEOUT_MS};
+    ProcessRunner::instance()->start(request).then(this, [this](const ProcessRunner::Result &result) {
+        onAudioModuleInstalled(result);
+    });
+}
 
-    if (!process.waitForFinished()) {
+void Configurator::onAudioModuleInstalled(const ProcessRunner::Result &result)
+{
+    if (!result.started || result.timedOut) {
         QString status = tr("Error");
         QString message = tr("Failed to execute the PowerShell commands.\n"
                              "Please check if PowerShell is installed and properly configured.");
         QMessageBox::critical(this, status, message);
     } else {
-        QString errorOutput = process.readAllStandardError();
-        int exitCode = process.exitCode();
+        QString errorOutput = result.standardError;
+        int exitCode = result.exitCode;
 
         QString status;
         QString message;
@@ -176,6 +214,8 @@ void Configurator::createDefaultSettings()
     ui->pauseMediaAction->setChecked(false);
     ui->disableAudioCheckBox->setChecked(false);
     ui->disableMonitorCheckBox->setChecked(false);
+    customWindowTitle.clear();
+    customProcess.clear();
     ui->customWindowLineEdit->setText("");
     ui->targetWindowComboBox->setCurrentIndex(0);
 
@@ -220,10 +260,11 @@ void Configurator::applySettings()
     ui->disableMonitorCheckBox->setChecked(settings.value("disable_monitor_switch").toBool());
     ui->disableNightLightCheckBox->setChecked(settings.value("disable_nightlight_action").toBool());
     ui->targetWindowComboBox->setCurrentIndex(settings.value("target_window_mode").toInt());
-    ui->customWindowLineEdit->setText(settings.value("custom_window_title").toString());
+    customWindowTitle = settings.value("custom_window_title").toString();
+    customProcess = settings.value("custom_process").toString();
+    showCustomTarget(ui->targetWindowComboBox->currentIndex());
     toggleAudioSettings(!ui->disableAudioCheckBox->isChecked());
     toggleMonitorSettings(!ui->disableMonitorCheckBox->isChecked());
-    toggleCustomWindowTitle(ui->targetWindowComboBox->currentIndex() == 1);
 
     if (ui->closeDiscordCheckBox->isChecked() && ui->disableNightLightCheckBox->isChecked()
         && ui->pauseMediaAction->isChecked() && ui->enablePerformancePowerPlan->isChecked()) {
@@ -246,7 +287,9 @@ void Configurator::saveSettings()
     settings["pause_media_action"] = ui->pauseMediaAction->isChecked();
     settings["disable_nightlight_action"] = ui->disableNightLightCheckBox->isChecked();
     settings["target_window_mode"] = ui->targetWindowComboBox->currentIndex();
-    settings["custom_window_title"] = ui->customWindowLineEdit->text();
+    syncCustomTarget();
+    settings["custom_window_title"] = customWindowTitle;
+    settings["custom_process"] = customProcess;
 
     QDir settingsDir(QFileInfo(settingsFile).absolutePath());
     if (!settingsDir.exists()) {
@@ -285,8 +328,8 @@ void Configurator::toggleCustomWindowTitle(bool state)
 
 void Configurator::setupInfoTab()
 {
-    ui->detectedSteamLanguage->setText(steamWindowManager->getSteamLanguage());
-    ui->targetWindowTitle->setText(steamWindowManager->getBigPictureWindowTitle());
+    ui->detectedSteamLanguage->setText(getSteamLanguage());
+    ui->targetWindowTitle->setText(getBigPictureWindowTitle());
     ui->repository->setText("<a href=\"https://github.com/odizinne/bigpicturetv/\">Odizinne/BigPictureTV</a>");
     ui->repository->setTextFormat(Qt::RichText);
     ui->repository->setTextInteractionFlags(Qt::TextBrowserInteraction);
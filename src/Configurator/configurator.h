@@ -9,9 +9,9 @@
 #include <QJsonValue>
 #include <QMainWindow>
 #include <QString>
+#include "processrunner.h"
 #include "shortcutmanager.h"
 #include "utils.h"
-#include "steamwindowmanager.h"
 
 namespace Ui {
 class Configurator;
@@ -37,14 +37,16 @@ private:
     void initDiscordAction();
     Utils* utils;
     ShortcutManager* shortcutManager;
-    SteamWindowManager* steamWindowManager;
     bool discordInstalled;
     void toggleAllActions();
     void getAudioCapabilities();
+    void onAudioModuleInstalled(const ProcessRunner::Result &result);
     void populateComboboxes();
     void toggleAudioSettings(bool state);
     void toggleMonitorSettings(bool state);
     void toggleCustomWindowTitle(bool state);
+    void syncCustomTarget();
+    void showCustomTarget(int index);
     void setupConnections();
     void setupInfoTab();
     void createDefaultSettings();
@@ -55,7 +57,11 @@ private:
     Ui::Configurator *ui;
     QString settingsFilePath;
     QJsonObject settings;
+    QString customWindowTitle;
+    QString customProcess;
+    int customTargetMode;
     static const QString settingsFile;
+    static const int INSTALL_TIMEOUT_MS;
 
 signals:
     void closed();
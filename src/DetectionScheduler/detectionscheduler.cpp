@@ -0,0 +1,120 @@
+#include "detectionscheduler.h"
+#include <QElapsedTimer>
+#include <QStringList>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+
+const int DetectionScheduler::HOT_INTERVAL = 100;
+const int DetectionScheduler::IDLE_INTERVAL = 5000;
+const int DetectionScheduler::EVENT_FALLBACK_INTERVAL = 5000;
+const int DetectionScheduler::SUSPENDED_INTERVAL = 15000;
+const int DetectionScheduler::HOT_WINDOW = 10000;
+
+DetectionScheduler::DetectionScheduler(Clock clock)
+    : clock(clock)
+    , baseInterval(1000)
+    , eventDriven(false)
+    , hostWasRunning(false)
+    , hotUntil(0)
+    , reason(Active)
+{
+    if (!this->clock) {
+        auto timer = std::make_shared<QElapsedTimer>();
+        timer->start();
+        this->clock = [timer]() { return timer->elapsed(); };
+    }
+    std::fill(std::begin(decisions), std::end(decisions), 0);
+}
+
+DetectionScheduler::~DetectionScheduler() {}
+
+void DetectionScheduler::setBaseInterval(int milliseconds)
+{
+    baseInterval = qMax(milliseconds, HOT_INTERVAL);
+}
+
+void DetectionScheduler::setEventDriven(bool eventDriven)
+{
+    this->eventDriven = eventDriven;
+}
+
+void DetectionScheduler::noteTransition()
+{
+    hotUntil = clock() + HOT_WINDOW;
+}
+
+int DetectionScheduler::nextInterval(const Inputs &inputs)
+{
+    qint64 now = clock();
+
+    // The target usually shows up shortly after its host process starts.
+    bool hostStarted = inputs.targetHostRunning && !hostWasRunning;
+    if (hostStarted) {
+        hotUntil = qMax(hotUntil, now + HOT_WINDOW);
+    }
+    hostWasRunning = inputs.targetHostRunning;
+
+    if (inputs.sessionLocked) {
+        reason = Locked;
+    } else if (inputs.displayOff) {
+        reason = DisplayOff;
+    } else if (hostStarted) {
+        reason = HostStarted;
+    } else if (now < hotUntil) {
+        reason = Transition;
+    } else if (!inputs.targetHostRunning) {
+        reason = Idle;
+    } else {
+        reason = Active;
+    }
+    ++decisions[reason];
+
+    int interval = intervalFor(reason);
+    if (inputs.onBattery && reason != Transition && reason != HostStarted) {
+        interval *= 2;
+    }
+    return interval;
+}
+
+int DetectionScheduler::intervalFor(Reason reason) const
+{
+    switch (reason) {
+    case Transition:
+    case HostStarted:
+        return eventDriven ? baseInterval : HOT_INTERVAL;
+    case Active:
+        return eventDriven ? qMax(baseInterval, EVENT_FALLBACK_INTERVAL) : baseInterval;
+    case Idle:
+        return eventDriven ? qMax(baseInterval, SUSPENDED_INTERVAL) : qMax(baseInterval, IDLE_INTERVAL);
+    case Locked:
+    case DisplayOff:
+    case ReasonCount:
+        break;
+    }
+    return qMax(baseInterval, SUSPENDED_INTERVAL);
+}
+
+DetectionScheduler::Reason DetectionScheduler::lastReason() const
+{
+    return reason;
+}
+
+quint64 DetectionScheduler::decisionCount(Reason reason) const
+{
+    return reason < ReasonCount ? decisions[reason] : 0;
+}
+
+QString DetectionScheduler::takeSummary()
+{
+    static const char *names[ReasonCount] = {"transition", "host started", "active", "idle", "locked", "display off"};
+
+    QStringList parts;
+    for (int i = 0; i < ReasonCount; ++i) {
+        if (decisions[i] > 0) {
+            parts << QString("%1: %2").arg(names[i]).arg(decisions[i]);
+        }
+        decisions[i] = 0;
+    }
+    return parts.join(", ");
+}
@@ -0,0 +1,61 @@
+#ifndef DETECTIONSCHEDULER_H
+#define DETECTIONSCHEDULER_H
+
+#include <QString>
+#include <functional>
+
+class DetectionScheduler
+{
+public:
+    struct Inputs
+    {
+        bool targetHostRunning = true;
+        bool sessionLocked = false;
+        bool displayOff = false;
+        bool onBattery = false;
+    };
+
+    enum Reason {
+        Transition,
+        HostStarted,
+        Active,
+        Idle,
+        Locked,
+        DisplayOff,
+        ReasonCount
+    };
+
+    using Clock = std::function<qint64()>;
+
+    explicit DetectionScheduler(Clock clock = Clock());
+    ~DetectionScheduler();
+
+    void setBaseInterval(int milliseconds);
+    void setEventDriven(bool eventDriven);
+    void noteTransition();
+
+    // Picks the delay before the next check and counts the reason behind it.
+    int nextInterval(const Inputs &inputs);
+    Reason lastReason() const;
+    quint64 decisionCount(Reason reason) const;
+    QString takeSummary();
+
+    static const int HOT_INTERVAL;
+    static const int IDLE_INTERVAL;
+    static const int EVENT_FALLBACK_INTERVAL;
+    static const int SUSPENDED_INTERVAL;
+    static const int HOT_WINDOW;
+
+private:
+    int intervalFor(Reason reason) const;
+
+    Clock clock;
+    int baseInterval;
+    bool eventDriven;
+    bool hostWasRunning;
+    qint64 hotUntil;
+    Reason reason;
+    quint64 decisions[ReasonCount];
+};
+
+#endif // DETECTIONSCHEDULER_H
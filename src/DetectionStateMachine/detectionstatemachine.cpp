@@ -0,0 +1,88 @@
+#include "detectionstatemachine.h"
+#include <QDebug>
+#include <limits>
+
+DetectionStateMachine::DetectionStateMachine()
+    : enterConfirmation(0)
+    , exitConfirmation(0)
+    , minimumDwell(0)
+    , active(false)
+    , pending(false)
+    , pendingSince(0)
+    , lastTransition(std::numeric_limits<qint64>::min() / 2)
+    , flaps(0)
+{}
+
+DetectionStateMachine::~DetectionStateMachine() {}
+
+void DetectionStateMachine::setEnterConfirmation(int milliseconds)
+{
+    enterConfirmation = qMax(milliseconds, 0);
+}
+
+void DetectionStateMachine::setExitConfirmation(int milliseconds)
+{
+    exitConfirmation = qMax(milliseconds, 0);
+}
+
+void DetectionStateMachine::setMinimumDwell(int milliseconds)
+{
+    minimumDwell = qMax(milliseconds, 0);
+}
+
+void DetectionStateMachine::reset(bool active)
+{
+    this->active = active;
+    pending = false;
+    lastTransition = std::numeric_limits<qint64>::min() / 2;
+}
+
+DetectionStateMachine::Transition DetectionStateMachine::feed(bool sample, qint64 now)
+{
+    if (sample == active) {
+        if (pending) {
+            pending = false;
+            ++flaps;
+            qDebug() << "Suppressed detection flap lasting" << (now - pendingSince) << "ms";
+        }
+        return None;
+    }
+
+    if (!pending) {
+        pending = true;
+        pendingSince = now;
+    }
+
+    if (now < pendingDeadline()) {
+        return None;
+    }
+
+    active = sample;
+    pending = false;
+    lastTransition = now;
+    return active ? EnterGamemode : ExitGamemode;
+}
+
+bool DetectionStateMachine::isActive() const
+{
+    return active;
+}
+
+bool DetectionStateMachine::isPending() const
+{
+    return pending;
+}
+
+qint64 DetectionStateMachine::pendingDeadline() const
+{
+    if (!pending) {
+        return -1;
+    }
+    int confirmation = active ? exitConfirmation : enterConfirmation;
+    return qMax(pendingSince + confirmation, lastTransition + minimumDwell);
+}
+
+quint64 DetectionStateMachine::suppressedFlaps() const
+{
+    return flaps;
+}
@@ -0,0 +1,45 @@
+#ifndef DETECTIONSTATEMACHINE_H
+#define DETECTIONSTATEMACHINE_H
+
+#include <QtGlobal>
+
+class DetectionStateMachine
+{
+public:
+    enum Transition {
+        None,
+        EnterGamemode,
+        ExitGamemode
+    };
+
+    DetectionStateMachine();
+    ~DetectionStateMachine();
+
+    void setEnterConfirmation(int milliseconds);
+    void setExitConfirmation(int milliseconds);
+    void setMinimumDwell(int milliseconds);
+    void reset(bool active = false);
+
+    // A sample that disagrees with the current state only causes a transition once it
+    // has held for the confirmation window and the current state has lasted the
+    // minimum dwell time. Shorter disagreements are counted as suppressed flaps.
+    Transition feed(bool sample, qint64 now);
+
+    bool isActive() const;
+    bool isPending() const;
+    // Time at which a pending transition can be confirmed, or -1 when nothing is pending.
+    qint64 pendingDeadline() const;
+    quint64 suppressedFlaps() const;
+
+private:
+    int enterConfirmation;
+    int exitConfirmation;
+    int minimumDwell;
+    bool active;
+    bool pending;
+    qint64 pendingSince;
+    qint64 lastTransition;
+    quint64 flaps;
+};
+
+#endif // DETECTIONSTATEMACHINE_H
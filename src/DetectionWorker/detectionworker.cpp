@@ -0,0 +1,195 @@
+#include "detectionworker.h"
+#include <QDebug>
+#include "tracerecorder.h"
+#include "wineventwindowsource.h"
+
+DetectionWorker::DetectionWorker(QObject *parent)
+    : QObject(parent)
+    , utils(nullptr)
+    , steamWindowManager(nullptr)
+    , windowCheckTimer(nullptr)
+    , windowEventSource(nullptr)
+    , detectionScheduler(nullptr)
+    , systemStateMonitor(nullptr)
+    , detectionStateMachine(nullptr)
+    , gamemodeActive(false)
+    , wakePending(false)
+{}
+
+DetectionWorker::~DetectionWorker()
+{
+    // Hooks and the message window have to be released by the thread that created them.
+    delete windowEventSource;
+    delete systemStateMonitor;
+    delete windowCheckTimer;
+    delete detectionStateMachine;
+    delete detectionScheduler;
+    delete steamWindowManager;
+    delete utils;
+}
+
+void DetectionWorker::initialize()
+{
+    TraceRecorder::instance()->setThreadName("detection");
+    utils = new Utils();
+    steamWindowManager = new SteamWindowManager();
+    windowCheckTimer = new QTimer(this);
+    windowEventSource = new WinEventWindowSource(this);
+    detectionScheduler = new DetectionScheduler();
+    systemStateMonitor = new SystemStateMonitor(this);
+    detectionStateMachine = new DetectionStateMachine();
+    detectionClock.start();
+
+    connect(windowCheckTimer, &QTimer::timeout, this, &DetectionWorker::onDetectionTick);
+    connect(windowEventSource, &WindowEventSource::windowsChanged, this, &DetectionWorker::onDetectionTick);
+    connect(windowEventSource, &WindowEventSource::windowEvent, this, &DetectionWorker::onWindowEvent);
+    connect(systemStateMonitor, &SystemStateMonitor::stateChanged, this, &DetectionWorker::scheduleNextCheck);
+}
+
+void DetectionWorker::configure(const Config &config)
+{
+    this->config = config;
+    steamWindowManager->setCustomWindowRules(config.customRules);
+    steamWindowManager->setCustomWindowClasses(config.customWindowClasses);
+    steamWindowManager->setCustomProcess(config.customProcess);
+    detectionStateMachine->setEnterConfirmation(config.enterConfirmMs);
+    detectionStateMachine->setExitConfirmation(config.exitConfirmMs);
+    detectionStateMachine->setMinimumDwell(config.minDwellMs);
+}
+
+void DetectionWorker::setSteamLanguage(const QString &language)
+{
+    steamWindowManager->setPreferredLanguage(language);
+}
+
+void DetectionWorker::start()
+{
+    bool eventsActive = windowEventSource->start();
+    steamWindowManager->setIncrementalSweeps(eventsActive);
+    detectionScheduler->setBaseInterval(config.checkrate);
+    detectionScheduler->setEventDriven(eventsActive);
+    windowCheckTimer->start(config.checkrate);
+    onDetectionTick();
+}
+
+void DetectionWorker::stop()
+{
+    windowCheckTimer->stop();
+    windowEventSource->stop();
+}
+
+void DetectionWorker::onWindowEvent(quintptr window, WindowEventSource::EventType type)
+{
+    // Handles can be reused by a new window, so creation also drops the cached title.
+    if (type == WindowEventSource::NameChanged || type == WindowEventSource::Created) {
+        steamWindowManager->invalidateWindow(window);
+    }
+}
+
+void DetectionWorker::onDetectionTick()
+{
+    checkWindowTitle();
+    scheduleNextCheck();
+}
+
+void DetectionWorker::scheduleNextCheck()
+{
+    if (!windowCheckTimer->isActive()) {
+        return;
+    }
+
+    DetectionScheduler::Inputs inputs;
+    inputs.targetHostRunning = (config.targetMode != 0) || steamWindowManager->isSteamRunning();
+    inputs.sessionLocked = systemStateMonitor->isSessionLocked();
+    inputs.displayOff = systemStateMonitor->isDisplayOff();
+    inputs.onBattery = systemStateMonitor->isOnBattery();
+
+    int interval = detectionScheduler->nextInterval(inputs);
+
+    // Come back in time to confirm a pending transition, even if no event arrives.
+    if (detectionStateMachine->isPending()) {
+        qint64 wait = detectionStateMachine->pendingDeadline() - detectionClock.elapsed();
+        interval = static_cast<int>(qBound<qint64>(1, wait, interval));
+    }
+
+    if (interval != windowCheckTimer->interval()) {
+        windowCheckTimer->setInterval(interval);
+    }
+}
+
+void DetectionWorker::checkWindowTitle()
+{
+    if (config.targetMode == 1 && !steamWindowManager->hasCustomWindowRules()) {
+        return;
+    }
+
+    if (config.targetMode == 2 && config.customProcess.isEmpty()) {
+        return;
+    }
+
+    if (utils->isSunshineStreaming()) {
+        return;
+    }
+
+    bool isRunning;
+    if (config.targetMode == 0) {
+        isRunning = steamWindowManager->isBigPictureRunning();
+    } else if (config.targetMode == 1) {
+        isRunning = steamWindowManager->isCustomWindowRunning();
+    } else {
+        isRunning = steamWindowManager->isCustomProcessRunning();
+    }
+
+    Event event;
+    event.transition = detectionStateMachine->feed(isRunning, detectionClock.elapsed());
+    if (event.transition == DetectionStateMachine::None) {
+        return;
+    }
+
+    // Saved with the trace, so they sit next to the spans of the transition they led to.
+    TraceRecorder *trace = TraceRecorder::instance();
+    if (trace->isEnabled()) {
+        trace->record(QStringLiteral("detection summary"), "detection", trace->now(), 0,
+                      steamWindowManager->takeDetectionStats() + "; scheduler: "
+                          + detectionScheduler->takeSummary());
+    }
+    detectionScheduler->noteTransition();
+
+    if (event.transition == DetectionStateMachine::EnterGamemode) {
+        if (config.targetMode == 0) {
+            event.detail = "Big Picture detected, language: " + steamWindowManager->getDetectedLanguage();
+        } else if (config.targetMode == 1) {
+            event.detail = "Custom window rule fired: " + steamWindowManager->getMatchedCustomRule();
+        }
+    }
+    publish(event);
+}
+
+void DetectionWorker::publish(const Event &event)
+{
+    // The state word is authoritative; the queue only carries the details, so a full
+    // queue loses log lines but never a transition.
+    if (!events.push(event)) {
+        qWarning() << "Detection event queue is full, dropping" << event.detail;
+    }
+    gamemodeActive.store(event.transition == DetectionStateMachine::EnterGamemode, std::memory_order_release);
+
+    if (!wakePending.exchange(true, std::memory_order_acq_rel)) {
+        emit eventsAvailable();
+    }
+}
+
+void DetectionWorker::rearm()
+{
+    wakePending.store(false, std::memory_order_release);
+}
+
+bool DetectionWorker::takeEvent(Event &event)
+{
+    return events.pop(event);
+}
+
+bool DetectionWorker::isGamemodeActive() const
+{
+    return gamemodeActive.load(std::memory_order_acquire);
+}
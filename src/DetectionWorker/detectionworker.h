@@ -0,0 +1,86 @@
+#ifndef DETECTIONWORKER_H
+#define DETECTIONWORKER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+#include <atomic>
+#include "detectionscheduler.h"
+#include "detectionstatemachine.h"
+#include "rulematcher.h"
+#include "spscqueue.h"
+#include "steamwindowmanager.h"
+#include "systemstatemonitor.h"
+#include "utils.h"
+#include "windoweventsource.h"
+
+// Runs window detection on its own thread. Transitions are handed to the GUI thread
+// through a lock-free queue plus an atomic state word, and the GUI is only signalled
+// when one was published. Everything but the GUI-side accessors runs on the worker
+// thread; call it there with QMetaObject::invokeMethod().
+class DetectionWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Config
+    {
+        int targetMode = 0;
+        int checkrate = 1000;
+        QList<RuleMatcher::Rule> customRules;
+        QStringList customWindowClasses;
+        QString customProcess;
+        int enterConfirmMs = 0;
+        int exitConfirmMs = 0;
+        int minDwellMs = 0;
+    };
+
+    struct Event
+    {
+        DetectionStateMachine::Transition transition = DetectionStateMachine::None;
+        QString detail;
+    };
+
+    explicit DetectionWorker(QObject *parent = nullptr);
+    ~DetectionWorker();
+
+    // Worker thread.
+    void initialize();
+    void configure(const DetectionWorker::Config &config);
+    void setSteamLanguage(const QString &language);
+    void start();
+    void stop();
+
+    // GUI thread. rearm() has to come before draining, so that an event published
+    // while draining raises eventsAvailable() again.
+    void rearm();
+    bool takeEvent(Event &event);
+    bool isGamemodeActive() const;
+
+signals:
+    void eventsAvailable();
+
+private:
+    void onDetectionTick();
+    void onWindowEvent(quintptr window, WindowEventSource::EventType type);
+    void checkWindowTitle();
+    void scheduleNextCheck();
+    void publish(const Event &event);
+
+    Utils *utils;
+    SteamWindowManager *steamWindowManager;
+    QTimer *windowCheckTimer;
+    WindowEventSource *windowEventSource;
+    DetectionScheduler *detectionScheduler;
+    SystemStateMonitor *systemStateMonitor;
+    DetectionStateMachine *detectionStateMachine;
+    QElapsedTimer detectionClock;
+    Config config;
+
+    SpscQueue<Event, 64> events;
+    std::atomic<bool> gamemodeActive;
+    std::atomic<bool> wakePending;
+};
+
+#endif // DETECTIONWORKER_H
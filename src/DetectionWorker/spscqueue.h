@@ -0,0 +1,47 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <QtGlobal>
+#include <atomic>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// A slot is published by the release store of head and handed back by the release
+// store of tail, so the element type does not need to be atomic itself.
+template<typename T, int Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer only. Returns false, leaving the queue untouched, when it is full.
+    bool push(const T &value)
+    {
+        quint32 position = head.load(std::memory_order_relaxed);
+        if (position - tail.load(std::memory_order_acquire) == quint32(Capacity)) {
+            return false;
+        }
+        buffer[position & (Capacity - 1)] = value;
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only.
+    bool pop(T &value)
+    {
+        quint32 position = tail.load(std::memory_order_relaxed);
+        if (position == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = buffer[position & (Capacity - 1)];
+        buffer[position & (Capacity - 1)] = T();
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T buffer[Capacity];
+    alignas(64) std::atomic<quint32> head{0};
+    alignas(64) std::atomic<quint32> tail{0};
+};
+
+#endif // SPSCQUEUE_H
@@ -5,6 +5,7 @@
 #include <iomanip>
 #include <vector>
 #include <Windows.h>
+#include "registrywatcher.h"
 
 const std::wstring NightLightSwitcher::keyPath = L"Software\\Microsoft\\Windows\\CurrentVersion\\CloudStore\\Store\\DefaultAccount\\Current\\default$windows.data.bluelightreduction.bluelightreductionstate\\windows.data.bluelightreduction.bluelightreductionstate";
 
@@ -27,16 +28,9 @@ bool NightLightSwitcher::supported() const {
 bool NightLightSwitcher::enabled() {
     if (!supported()) return false;
 
-    BYTE data[1024];
-    DWORD dataSize = sizeof(data);
-    if (RegQueryValueEx(hKey, L"Data", NULL, NULL, data, &dataSize) != ERROR_SUCCESS) {
-        qDebug() << "Failed to query registry value.";
-        return false;
-    }
-
-    std::vector<BYTE> bytes(data, data + dataSize);
-    if (bytes.size() < 19) return false; // Ensure enough data length
-    return bytes[18] == 0x15; // 21 in decimal
+    QByteArray data = RegistryWatcher::instance()->value(RegistryWatcher::NightLightState).toByteArray();
+    if (data.size() < 19) return false; // Ensure enough data length
+    return static_cast<BYTE>(data[18]) == 0x15; // 21 in decimal
 }
 
 void NightLightSwitcher::enable() {
@@ -63,7 +57,8 @@ void NightLightSwitcher::toggle() {
 
     std::vector<BYTE> newData;
 
-    bool currentlyEnabled = enabled();
+    // Read from the fresh data rather than the cache, which may lag behind our own writes
+    bool currentlyEnabled = dataSize >= 19 && data[18] == 0x15;
 
     if (currentlyEnabled) {
         // Allocate 41 bytes and modify the necessary fields
@@ -94,6 +89,7 @@ void NightLightSwitcher::toggle() {
     if (RegSetValueEx(hKey, L"Data", 0, REG_BINARY, newData.data(), newDataSize) != ERROR_SUCCESS) {
         qDebug() << "Failed to update registry value.";
     }
+    RegistryWatcher::instance()->refresh(RegistryWatcher::NightLightState);
 }
 
 std::vector<BYTE> NightLightSwitcher::hexToBytes(const std::wstring& hex) {
@@ -0,0 +1,192 @@
+#include "powershellhost.h"
+#include <QDebug>
+#include <QList>
+#include "tracerecorder.h"
+
+const int PowerShellHost::DEFAULT_TIMEOUT_MS = 15000;
+// Starting PowerShell and importing a module can take several seconds on a cold cache.
+const int PowerShellHost::START_TIMEOUT_MS = 20000;
+
+namespace {
+const QByteArray READY_LINE = "ready";
+
+// Reads requests until stdin closes. Scripts and answers are base64 encoded, so
+// neither can break the line framing. Errors become terminating, so a failing cmdlet
+// reports through the error field instead of leaking onto stdout.
+const char *const BOOTSTRAP = R"(
+$utf8 = [Text.Encoding]::UTF8
+%1
+$ErrorActionPreference = 'Stop'
+[Console]::Out.WriteLine('ready')
+[Console]::Out.Flush()
+while ($null -ne ($line = [Console]::In.ReadLine())) {
+    $id, $payload = $line.Split(' ', 2)
+    $out = ''
+    $err = ''
+    try {
+        $script = [ScriptBlock]::Create($utf8.GetString([Convert]::FromBase64String($payload)))
+        $out = & $script | Out-String -Width 4096
+    } catch {
+        $err = $_.ToString()
+    }
+    [Console]::Out.WriteLine($id + ' ' + [Convert]::ToBase64String($utf8.GetBytes($out)) + ' '
+                             + [Convert]::ToBase64String($utf8.GetBytes($err)))
+    [Console]::Out.Flush()
+}
+)";
+}
+
+PowerShellHost::PowerShellHost(const QString &program, const QStringList &arguments)
+    : QObject(nullptr)
+    , program(program)
+    , arguments(arguments)
+    , thread(new QThread())
+    , process(nullptr)
+    , nextId(1)
+{
+    moveToThread(thread);
+    thread->start();
+}
+
+PowerShellHost::~PowerShellHost()
+{
+    QMetaObject::invokeMethod(this, [this]() { stop(); }, Qt::BlockingQueuedConnection);
+    thread->quit();
+    thread->wait();
+    delete thread;
+}
+
+QStringList PowerShellHost::powerShellArguments(const QStringList &modules)
+{
+    QStringList imports;
+    for (const QString &module : modules) {
+        imports.append(QString("Import-Module %1 -ErrorAction SilentlyContinue").arg(module));
+    }
+    QString script = QString(BOOTSTRAP).arg(imports.join('\n'));
+
+    // -EncodedCommand takes UTF-16LE, which sidesteps Windows command line quoting.
+    QByteArray utf16(reinterpret_cast<const char *>(script.utf16()), script.size() * 2);
+    return QStringList() << "-NoLogo" << "-NoProfile" << "-NonInteractive" << "-ExecutionPolicy" << "Bypass"
+                         << "-EncodedCommand" << QString::fromLatin1(utf16.toBase64());
+}
+
+void PowerShellHost::prepare()
+{
+    QMetaObject::invokeMethod(this, [this]() { ensureStarted(); }, Qt::QueuedConnection);
+}
+
+PowerShellHost::Result PowerShellHost::execute(const QString &script, int timeoutMs)
+{
+    if (QThread::currentThread() == thread) {
+        return executeOnHost(script, timeoutMs);
+    }
+    Result result;
+    QMetaObject::invokeMethod(this, [&]() { result = executeOnHost(script, timeoutMs); }, Qt::BlockingQueuedConnection);
+    return result;
+}
+
+bool PowerShellHost::ensureStarted()
+{
+    if (process && process->state() == QProcess::Running) {
+        return true;
+    }
+    stop();
+
+    TraceRecorder::Span span(QStringLiteral("shell host start"), "process", program);
+    process = new QProcess();
+    process->start(program, arguments);
+    if (!process->waitForStarted(START_TIMEOUT_MS)) {
+        qWarning() << "Failed to start shell host:" << process->errorString();
+        stop();
+        return false;
+    }
+
+    // The module imports run first, and may write warnings before the ready line.
+    QDeadlineTimer deadline(START_TIMEOUT_MS);
+    QByteArray line;
+    bool ready = false;
+    while (!ready && readLine(line, deadline)) {
+        ready = line == READY_LINE;
+    }
+    if (!ready) {
+        qWarning() << "Shell host did not become ready:" << line << process->readAllStandardError();
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void PowerShellHost::stop()
+{
+    if (!process) {
+        return;
+    }
+    if (process->state() != QProcess::NotRunning) {
+        // Closing stdin ends the read loop; only a stuck host needs killing.
+        process->closeWriteChannel();
+        if (!process->waitForFinished(1000)) {
+            process->kill();
+            process->waitForFinished(1000);
+        }
+    }
+    delete process;
+    process = nullptr;
+}
+
+bool PowerShellHost::readLine(QByteArray &line, const QDeadlineTimer &deadline)
+{
+    while (!process->canReadLine()) {
+        if (process->state() != QProcess::Running || deadline.hasExpired()) {
+            return false;
+        }
+        process->waitForReadyRead(int(qMin<qint64>(deadline.remainingTime(), 100)));
+    }
+    line = process->readLine();
+    while (line.endsWith('\n') || line.endsWith('\r')) {
+        line.chop(1);
+    }
+    return true;
+}
+
+PowerShellHost::Result PowerShellHost::executeOnHost(const QString &script, int timeoutMs)
+{
+    Result result;
+    TraceRecorder::Span span(QStringLiteral("shell host command"), "process", script);
+    QDeadlineTimer deadline(timeoutMs);
+
+    // A host that died since the last command gets one fresh start.
+    for (int attempt = 0; attempt < 2 && !result.completed; ++attempt) {
+        if (!ensureStarted()) {
+            result.failure = "Shell host could not be started";
+            return result;
+        }
+
+        QByteArray id = QByteArray::number(nextId++);
+        process->write(id + ' ' + script.toUtf8().toBase64() + '\n');
+
+        QByteArray line;
+        while (readLine(line, deadline)) {
+            QList<QByteArray> fields = line.split(' ');
+            // Stray output, e.g. from a module writing to the console on import.
+            if (fields.size() != 3 || fields[0] != id) {
+                continue;
+            }
+            result.completed = true;
+            result.output = QByteArray::fromBase64(fields[1]);
+            result.error = QByteArray::fromBase64(fields[2]);
+            break;
+        }
+
+        if (!result.completed && deadline.hasExpired()) {
+            // Whatever it is stuck on would delay every later command as well.
+            result.failure = QString("Shell host did not answer within %1 ms").arg(timeoutMs);
+            stop();
+            return result;
+        }
+    }
+
+    if (!result.completed) {
+        result.failure = "Shell host exited while running the command";
+    }
+    return result;
+}
@@ -0,0 +1,58 @@
+#ifndef POWERSHELLHOST_H
+#define POWERSHELLHOST_H
+
+#include <QByteArray>
+#include <QDeadlineTimer>
+#include <QObject>
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+
+// Keeps one shell process alive and feeds it commands, so only the first command pays
+// for starting PowerShell and importing modules. Requests are single lines of
+// "<id> <base64 script>", answered by "<id> <base64 output> <base64 error>", one at a
+// time. The process lives on the host's own thread; execute() may be called from any
+// other thread and blocks until the answer arrives. A host that died or timed out is
+// restarted by the next command.
+class PowerShellHost : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Result
+    {
+        bool completed = false;
+        QByteArray output;
+        QByteArray error;
+        QString failure;
+    };
+
+    // Any program speaking the protocol works; powerShellArguments() sets up the
+    // PowerShell side of it. There is no parent, since the host moves to its own thread.
+    PowerShellHost(const QString &program, const QStringList &arguments);
+    ~PowerShellHost();
+
+    static QStringList powerShellArguments(const QStringList &modules);
+
+    Result execute(const QString &script, int timeoutMs = DEFAULT_TIMEOUT_MS);
+    // Starts the shell in the background, ahead of the first command.
+    void prepare();
+
+    static const int DEFAULT_TIMEOUT_MS;
+    static const int START_TIMEOUT_MS;
+
+private:
+    bool ensureStarted();
+    void stop();
+    Result executeOnHost(const QString &script, int timeoutMs);
+    bool readLine(QByteArray &line, const QDeadlineTimer &deadline);
+
+    QString program;
+    QStringList arguments;
+    QThread *thread;
+    QProcess *process;
+    quint64 nextId;
+};
+
+#endif // POWERSHELLHOST_H
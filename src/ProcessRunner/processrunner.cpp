@@ -0,0 +1,194 @@
+#include "processrunner.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QProcess>
+#include <QPromise>
+#include <QSemaphoreReleaser>
+#include <memory>
+#include "tracerecorder.h"
+
+// Qt's own default of 30 seconds is far longer than any of our commands should take.
+const int ProcessRunner::DEFAULT_TIMEOUT_MS = 10000;
+const int ProcessRunner::MAX_CONCURRENT = 4;
+const int ProcessRunner::POLL_MS = 100;
+const int ProcessRunner::KILL_WAIT_MS = 1000;
+
+bool ProcessRunner::Result::succeeded() const
+{
+    return started && !timedOut && !crashed && exitCode == 0;
+}
+
+ProcessRunner *ProcessRunner::instance()
+{
+    static ProcessRunner runner;
+    return &runner;
+}
+
+ProcessRunner::ProcessRunner()
+    : pool(new QThreadPool())
+    , capacity(MAX_CONCURRENT)
+    , stopping(false)
+{
+    pool->setMaxThreadCount(MAX_CONCURRENT);
+}
+
+ProcessRunner::~ProcessRunner()
+{
+    shutdown();
+    delete pool;
+}
+
+QFuture<ProcessRunner::Result> ProcessRunner::start(const Request &request)
+{
+    auto promise = std::make_shared<QPromise<Result>>();
+    QFuture<Result> future = promise->future();
+    promise->start();
+    pool->start([this, request, promise]() {
+        promise->addResult(run(request));
+        promise->finish();
+    });
+    return future;
+}
+
+ProcessRunner::Result ProcessRunner::run(const Request &request)
+{
+    Result result;
+    if (stopping.load(std::memory_order_acquire)) {
+        result.errorString = "Shutting down";
+        return result;
+    }
+
+    // Waits in slices, here and below, so a shutdown does not sit out the whole timeout.
+    QElapsedTimer clock;
+    clock.start();
+    while (!capacity.tryAcquire(1, int(qBound<qint64>(0, request.timeoutMs - clock.elapsed(), POLL_MS)))) {
+        if (stopping.load(std::memory_order_acquire)) {
+            result.errorString = "Shutting down";
+            return result;
+        }
+        if (clock.elapsed() >= request.timeoutMs) {
+            result.timedOut = true;
+            result.errorString = QString("Timed out after %1 ms waiting for a free slot").arg(request.timeoutMs);
+            record(request, result);
+            return result;
+        }
+    }
+    QSemaphoreReleaser releaser(capacity);
+    if (stopping.load(std::memory_order_acquire)) {
+        result.errorString = "Shutting down";
+        return result;
+    }
+    TraceRecorder::Span span(QStringLiteral("process"), "process");
+    if (span.isRecording()) {
+        span.setName(programName(request.program));
+        span.setDetail(request.arguments.join(' '));
+    }
+
+    qint64 queuedMs = clock.elapsed();
+    QProcess process;
+    process.start(request.program, request.arguments);
+    if (!process.waitForStarted(int(qMax<qint64>(1, request.timeoutMs - queuedMs)))) {
+        result.errorString = process.errorString();
+        record(request, result);
+        return result;
+    }
+    result.started = true;
+    result.spawnMs = clock.elapsed() - queuedMs;
+
+    bool stopped = false;
+    while (!process.waitForFinished(POLL_MS) && process.state() != QProcess::NotRunning) {
+        stopped = stopping.load(std::memory_order_acquire);
+        if (clock.elapsed() >= request.timeoutMs || stopped) {
+            result.timedOut = !stopped;
+            process.kill();
+            process.waitForFinished(KILL_WAIT_MS);
+            break;
+        }
+    }
+    result.runtimeMs = clock.elapsed() - queuedMs - result.spawnMs;
+
+    result.crashed = !result.timedOut && !stopped && process.exitStatus() == QProcess::CrashExit;
+    result.exitCode = process.exitCode();
+    result.standardOutput = process.readAllStandardOutput();
+    result.standardError = process.readAllStandardError();
+    if (stopped) {
+        result.errorString = "Killed on shutdown";
+    } else if (result.timedOut) {
+        result.errorString = QString("Timed out after %1 ms").arg(request.timeoutMs);
+        qWarning() << programName(request.program) << "killed:" << result.errorString;
+    } else if (result.crashed) {
+        result.errorString = process.errorString();
+    }
+
+    record(request, result);
+    return result;
+}
+
+bool ProcessRunner::startDetached(const Request &request)
+{
+    if (stopping.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+    Result result;
+    result.started = QProcess::startDetached(request.program, request.arguments);
+    result.spawnMs = clock.elapsed();
+    result.exitCode = result.started ? 0 : -1;
+    record(request, result);
+    return result.started;
+}
+
+void ProcessRunner::shutdown()
+{
+    stopping.store(true, std::memory_order_release);
+    pool->waitForDone();
+}
+
+QString ProcessRunner::programName(const QString &program)
+{
+    return QFileInfo(program).fileName();
+}
+
+void ProcessRunner::record(const Request &request, const Result &result)
+{
+    QMutexLocker locker(&mutex);
+    Metrics &entry = metrics[programName(request.program)];
+    ++entry.spawns;
+    entry.failures += result.started ? 0 : 1;
+    entry.timeouts += result.timedOut ? 1 : 0;
+    entry.spawnMs += result.spawnMs;
+    entry.maxSpawnMs = qMax(entry.maxSpawnMs, result.spawnMs);
+    entry.runtimeMs += result.runtimeMs;
+    entry.maxRuntimeMs = qMax(entry.maxRuntimeMs, result.runtimeMs);
+    entry.lastExitCode = result.exitCode;
+}
+
+QString ProcessRunner::takeSummary()
+{
+    QMutexLocker locker(&mutex);
+    QStringList parts;
+    for (auto it = metrics.cbegin(); it != metrics.cend(); ++it) {
+        const Metrics &entry = it.value();
+        QString part = QString("%1 %2x spawn %3/%4ms run %5/%6ms exit %7")
+                           .arg(it.key())
+                           .arg(entry.spawns)
+                           .arg(entry.spawnMs / entry.spawns)
+                           .arg(entry.maxSpawnMs)
+                           .arg(entry.runtimeMs / entry.spawns)
+                           .arg(entry.maxRuntimeMs)
+                           .arg(entry.lastExitCode);
+        if (entry.failures > 0) {
+            part += QString(", %1 failed to start").arg(entry.failures);
+        }
+        if (entry.timeouts > 0) {
+            part += QString(", %1 timed out").arg(entry.timeouts);
+        }
+        parts.append(part);
+    }
+    metrics.clear();
+    return parts.isEmpty() ? "none" : parts.join("; ");
+}
@@ -0,0 +1,90 @@
+#ifndef PROCESSRUNNER_H
+#define PROCESSRUNNER_H
+
+#include <QByteArray>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QSemaphore>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+
+// Runs every child process of the application. Each call has its own timeout, which
+// covers waiting for a free slot and after which the child is killed; at most
+// MAX_CONCURRENT children run at once, and spawn latency, runtime and exit codes are
+// accounted per program.
+class ProcessRunner
+{
+public:
+    struct Request
+    {
+        QString program;
+        QStringList arguments;
+        int timeoutMs = DEFAULT_TIMEOUT_MS;
+    };
+
+    struct Result
+    {
+        bool started = false;
+        bool timedOut = false;
+        bool crashed = false;
+        int exitCode = -1;
+        QByteArray standardOutput;
+        QByteArray standardError;
+        QString errorString;
+        qint64 spawnMs = 0;
+        qint64 runtimeMs = 0;
+
+        bool succeeded() const;
+    };
+
+    // The application shares instance(); tests make their own.
+    ProcessRunner();
+    ~ProcessRunner();
+    static ProcessRunner *instance();
+
+    // Runs on the runner's own threads; never blocks the caller.
+    QFuture<Result> start(const Request &request);
+    // Runs on the calling thread, so it must not be used from the GUI thread.
+    Result run(const Request &request);
+    bool startDetached(const Request &request);
+
+    // Kills whatever is still running and refuses new work; used on shutdown.
+    void shutdown();
+
+    // Per program since the last call: spawns, average/maximum spawn and run times
+    // and the last exit code.
+    QString takeSummary();
+
+    static const int DEFAULT_TIMEOUT_MS;
+    static const int MAX_CONCURRENT;
+
+private:
+    struct Metrics
+    {
+        int spawns = 0;
+        int failures = 0;
+        int timeouts = 0;
+        qint64 spawnMs = 0;
+        qint64 maxSpawnMs = 0;
+        qint64 runtimeMs = 0;
+        qint64 maxRuntimeMs = 0;
+        int lastExitCode = 0;
+    };
+
+    void record(const Request &request, const Result &result);
+    static QString programName(const QString &program);
+
+    static const int POLL_MS;
+    static const int KILL_WAIT_MS;
+
+    QThreadPool *pool;
+    QSemaphore capacity;
+    std::atomic<bool> stopping;
+    QMutex mutex;
+    QHash<QString, Metrics> metrics;
+};
+
+#endif // PROCESSRUNNER_H
@@ -0,0 +1,29 @@
+#ifndef PROCESSSOURCE_H
+#define PROCESSSOURCE_H
+
+#include <QString>
+#include <QStringView>
+
+class ProcessVisitor
+{
+public:
+    virtual ~ProcessVisitor() {}
+
+    // The image name only lives for the duration of the call.
+    virtual void visitProcess(quint32 processId, QStringView imageName) = 0;
+};
+
+// Lists running processes for ProcessTable.
+class ProcessSource
+{
+public:
+    virtual ~ProcessSource() {}
+
+    // Streams every running process to the visitor. Returns false if the list could not be read.
+    virtual bool visitProcesses(ProcessVisitor &visitor) const = 0;
+
+    // Empty if the process is gone or cannot be inspected.
+    virtual QString commandLine(quint32 processId) const = 0;
+};
+
+#endif // PROCESSSOURCE_H
@@ -0,0 +1,92 @@
+#include "processtable.h"
+
+ProcessTable::ProcessTable(const ProcessSource *source)
+    : source(source)
+    , generation(0)
+{}
+
+ProcessTable::~ProcessTable() {}
+
+void ProcessTable::watchImage(const QString &imageName)
+{
+    QString image = imageName.toLower();
+    if (watchedImages.contains(image)) {
+        return;
+    }
+    watchedImages.insert(image);
+
+    // Processes that were already known still need their command line.
+    for (auto it = processes.begin(); it != processes.end(); ++it) {
+        if (it->commandLine.isEmpty() && it->imageName.compare(image, Qt::CaseInsensitive) == 0) {
+            it->commandLine = source->commandLine(it.key());
+        }
+    }
+}
+
+void ProcessTable::clearWatchedImages()
+{
+    watchedImages.clear();
+}
+
+bool ProcessTable::refresh(int maxAgeMs)
+{
+    if (maxAgeMs > 0 && lastRefresh.isValid() && !lastRefresh.hasExpired(maxAgeMs)) {
+        return true;
+    }
+
+    ++generation;
+    if (!source->visitProcesses(*this)) {
+        return false;
+    }
+    lastRefresh.start();
+
+    for (auto it = processes.begin(); it != processes.end();) {
+        if (it->generation != generation) {
+            it = processes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return true;
+}
+
+void ProcessTable::visitProcess(quint32 processId, QStringView imageName)
+{
+    auto it = processes.find(processId);
+
+    // A reused process id shows up with a different image name.
+    if (it == processes.end() || imageName != it->imageName) {
+        Process process;
+        process.imageName = imageName.toString();
+        if (watchedImages.contains(process.imageName.toLower())) {
+            process.commandLine = source->commandLine(processId);
+        }
+        it = processes.insert(processId, process);
+    }
+    it->generation = generation;
+}
+
+bool ProcessTable::isRunning(const QString &imageName, const QString &commandLineFragment) const
+{
+    for (const auto &process : processes) {
+        if (process.imageName.compare(imageName, Qt::CaseInsensitive) != 0) {
+            continue;
+        }
+        if (commandLineFragment.isEmpty()
+            || process.commandLine.contains(commandLineFragment, Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString ProcessTable::imageName(quint32 processId) const
+{
+    auto it = processes.constFind(processId);
+    return it != processes.constEnd() ? it->imageName : QString();
+}
+
+int ProcessTable::size() const
+{
+    return processes.size();
+}
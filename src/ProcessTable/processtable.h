@@ -0,0 +1,44 @@
+#ifndef PROCESSTABLE_H
+#define PROCESSTABLE_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include "processsource.h"
+
+class ProcessTable : private ProcessVisitor
+{
+public:
+    ProcessTable(const ProcessSource *source);
+    ~ProcessTable();
+
+    // Command lines are only queried for processes running one of the watched images.
+    void watchImage(const QString &imageName);
+    void clearWatchedImages();
+
+    // Re-reads the process list unless the last refresh is younger than maxAgeMs.
+    bool refresh(int maxAgeMs = 0);
+    bool isRunning(const QString &imageName, const QString &commandLineFragment = QString()) const;
+    // Image name of a process from the last refresh, empty if it is not known.
+    QString imageName(quint32 processId) const;
+    int size() const;
+
+private:
+    struct Process
+    {
+        QString imageName;
+        QString commandLine;
+        quint32 generation = 0;
+    };
+
+    void visitProcess(quint32 processId, QStringView imageName) override;
+
+    const ProcessSource *source;
+    QHash<quint32, Process> processes;
+    QSet<QString> watchedImages;
+    quint32 generation;
+    QElapsedTimer lastRefresh;
+};
+
+#endif // PROCESSTABLE_H
@@ -0,0 +1,63 @@
+#include "win32processsource.h"
+#include <QByteArray>
+#include <QDebug>
+#include <windows.h>
+#include <tlhelp32.h>
+#include <winternl.h>
+
+namespace {
+typedef LONG(NTAPI *NtQueryInformationProcessFn)(HANDLE, ULONG, PVOID, ULONG, PULONG);
+const ULONG PROCESS_COMMAND_LINE_INFORMATION = 60;
+} // namespace
+
+Win32ProcessSource::Win32ProcessSource() {}
+
+Win32ProcessSource::~Win32ProcessSource() {}
+
+bool Win32ProcessSource::visitProcesses(ProcessVisitor &visitor) const
+{
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot == INVALID_HANDLE_VALUE) {
+        qWarning() << "Failed to snapshot the process list";
+        return false;
+    }
+
+    PROCESSENTRY32W entry;
+    entry.dwSize = sizeof(entry);
+
+    if (Process32FirstW(snapshot, &entry)) {
+        do {
+            visitor.visitProcess(entry.th32ProcessID, QStringView(reinterpret_cast<const char16_t *>(entry.szExeFile)));
+        } while (Process32NextW(snapshot, &entry));
+    }
+    CloseHandle(snapshot);
+    return true;
+}
+
+QString Win32ProcessSource::commandLine(quint32 processId) const
+{
+    static NtQueryInformationProcessFn queryInformationProcess = reinterpret_cast<NtQueryInformationProcessFn>(
+        GetProcAddress(GetModuleHandle(L"ntdll.dll"), "NtQueryInformationProcess"));
+    if (!queryInformationProcess) {
+        return QString();
+    }
+
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+    if (!process) {
+        return QString();
+    }
+
+    QString commandLine;
+    ULONG size = 0;
+    queryInformationProcess(process, PROCESS_COMMAND_LINE_INFORMATION, nullptr, 0, &size);
+    if (size > 0) {
+        QByteArray buffer(static_cast<qsizetype>(size), Qt::Uninitialized);
+        if (queryInformationProcess(process, PROCESS_COMMAND_LINE_INFORMATION, buffer.data(), size, &size) >= 0) {
+            const UNICODE_STRING *value = reinterpret_cast<const UNICODE_STRING *>(buffer.constData());
+            commandLine = QString::fromWCharArray(value->Buffer, value->Length / sizeof(WCHAR));
+        }
+    }
+
+    CloseHandle(process);
+    return commandLine;
+}
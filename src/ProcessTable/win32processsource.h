@@ -0,0 +1,16 @@
+#ifndef WIN32PROCESSSOURCE_H
+#define WIN32PROCESSSOURCE_H
+
+#include "processsource.h"
+
+class Win32ProcessSource : public ProcessSource
+{
+public:
+    Win32ProcessSource();
+    ~Win32ProcessSource();
+
+    bool visitProcesses(ProcessVisitor &visitor) const override;
+    QString commandLine(quint32 processId) const override;
+};
+
+#endif // WIN32PROCESSSOURCE_H
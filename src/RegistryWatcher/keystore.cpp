@@ -0,0 +1,7 @@
+#include "keystore.h"
+
+KeyStore::KeyStore(QObject *parent)
+    : QObject(parent)
+{}
+
+KeyStore::~KeyStore() {}
@@ -0,0 +1,40 @@
+#ifndef KEYSTORE_H
+#define KEYSTORE_H
+
+#include <QObject>
+#include <QString>
+#include <QVariant>
+
+// Where RegistryWatcher reads its values from and learns about changes.
+class KeyStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Root {
+        CurrentUser,
+        LocalMachine
+    };
+
+    struct Location
+    {
+        Root root;
+        QString keyPath;
+        QString valueName;
+    };
+
+    explicit KeyStore(QObject *parent = nullptr);
+    ~KeyStore();
+
+    // Starts watching the value at location, reported as id. Returns false when changes
+    // cannot be reported, in which case the caller has to read the value every time.
+    virtual bool watch(int id, const Location &location) = 0;
+    virtual QVariant read(int id) = 0;
+
+signals:
+    // Emitted after a watched value may have changed. watching is false if the store
+    // could not keep watching it.
+    void changed(int id, bool watching);
+};
+
+#endif // KEYSTORE_H
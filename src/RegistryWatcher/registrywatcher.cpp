@@ -0,0 +1,81 @@
+#include "registrywatcher.h"
+
+RegistryWatcher::RegistryWatcher(KeyStore *store, QObject *parent)
+    : QObject(parent)
+    , store(store)
+{
+    store->setParent(this);
+    connect(store, &KeyStore::changed, this, &RegistryWatcher::onStoreChanged);
+
+    addValue(SteamLanguage, KeyStore::CurrentUser, "Software\\Valve\\Steam\\steamglobal", "Language");
+    addValue(AppsUseLightTheme,
+             KeyStore::CurrentUser,
+             "Software\\Microsoft\\Windows\\CurrentVersion\\Themes\\Personalize",
+             "AppsUseLightTheme");
+    addValue(ActivePowerScheme,
+             KeyStore::LocalMachine,
+             "SYSTEM\\CurrentControlSet\\Control\\Power\\User\\PowerSchemes",
+             "ActivePowerScheme");
+    addValue(NightLightState,
+             KeyStore::CurrentUser,
+             "Software\\Microsoft\\Windows\\CurrentVersion\\CloudStore\\Store\\DefaultAccount\\Current\\"
+             "default$windows.data.bluelightreduction.bluelightreductionstate\\"
+             "windows.data.bluelightreduction.bluelightreductionstate",
+             "Data");
+}
+
+RegistryWatcher::~RegistryWatcher() {}
+
+void RegistryWatcher::addValue(Value value, KeyStore::Root root, const QString &keyPath, const QString &valueName)
+{
+    WatchedValue watched;
+    watched.location = {root, keyPath, valueName};
+    values.insert(value, watched);
+}
+
+QVariant RegistryWatcher::value(Value value)
+{
+    auto it = values.find(value);
+    if (it == values.end()) {
+        return QVariant();
+    }
+
+    WatchedValue &watched = it.value();
+    if (watched.loaded) {
+        return watched.cached;
+    }
+
+    bool watching = store->watch(value, watched.location);
+    watched.cached = store->read(value);
+    // Without a change notification the value cannot be trusted later, so read it again next time.
+    watched.loaded = watching;
+    return watched.cached;
+}
+
+void RegistryWatcher::refresh(Value value)
+{
+    auto it = values.find(value);
+    if (it == values.end()) {
+        return;
+    }
+
+    QVariant current = store->read(value);
+    if (current != it->cached) {
+        it->cached = current;
+        emit valueChanged(value);
+    }
+}
+
+void RegistryWatcher::onStoreChanged(int id, bool watching)
+{
+    Value value = static_cast<Value>(id);
+    auto it = values.find(value);
+    if (it == values.end()) {
+        return;
+    }
+
+    if (!watching) {
+        it->loaded = false;
+    }
+    refresh(value);
+}
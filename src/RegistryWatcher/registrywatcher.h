@@ -0,0 +1,50 @@
+#ifndef REGISTRYWATCHER_H
+#define REGISTRYWATCHER_H
+
+#include <QMap>
+#include <QObject>
+#include <QVariant>
+#include "keystore.h"
+
+class RegistryWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Value {
+        SteamLanguage,
+        AppsUseLightTheme,
+        ActivePowerScheme,
+        NightLightState
+    };
+    Q_ENUM(Value)
+
+    // The shared watcher reads the Windows registry.
+    static RegistryWatcher *instance();
+
+    // Takes ownership of store.
+    explicit RegistryWatcher(KeyStore *store, QObject *parent = nullptr);
+    ~RegistryWatcher();
+
+    QVariant value(Value value);
+    void refresh(Value value);
+
+signals:
+    void valueChanged(RegistryWatcher::Value value);
+
+private:
+    struct WatchedValue
+    {
+        KeyStore::Location location;
+        QVariant cached;
+        bool loaded = false;
+    };
+
+    void addValue(Value value, KeyStore::Root root, const QString &keyPath, const QString &valueName);
+    void onStoreChanged(int id, bool watching);
+
+    KeyStore *store;
+    QMap<Value, WatchedValue> values;
+};
+
+#endif // REGISTRYWATCHER_H
@@ -0,0 +1,132 @@
+#include "win32keystore.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include "registrywatcher.h"
+
+// Defined here rather than in registrywatcher.cpp so the watcher builds without windows.h.
+RegistryWatcher *RegistryWatcher::instance()
+{
+    static RegistryWatcher *watcher = new RegistryWatcher(new Win32KeyStore(), QCoreApplication::instance());
+    return watcher;
+}
+
+Win32KeyStore::Win32KeyStore(QObject *parent)
+    : KeyStore(parent)
+{}
+
+Win32KeyStore::~Win32KeyStore()
+{
+    for (auto &entry : entries) {
+        delete entry.notifier;
+        if (entry.event) {
+            CloseHandle(entry.event);
+        }
+        if (entry.key) {
+            RegCloseKey(entry.key);
+        }
+    }
+}
+
+bool Win32KeyStore::arm(Entry &entry)
+{
+    if (!entry.key) {
+        if (RegOpenKeyEx(entry.root, entry.keyPath.c_str(), 0, KEY_READ | KEY_NOTIFY, &entry.key)
+            != ERROR_SUCCESS) {
+            entry.key = nullptr;
+            return false;
+        }
+    }
+
+    if (!entry.event) {
+        entry.event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (!entry.event) {
+            return false;
+        }
+    }
+
+    // Notifications are one-shot and have to be re-armed after every change.
+    LONG result = RegNotifyChangeKeyValue(entry.key,
+                                          FALSE,
+                                          REG_NOTIFY_CHANGE_LAST_SET | REG_NOTIFY_THREAD_AGNOSTIC,
+                                          entry.event,
+                                          TRUE);
+    return result == ERROR_SUCCESS;
+}
+
+bool Win32KeyStore::watch(int id, const Location &location)
+{
+    auto it = entries.find(id);
+    if (it == entries.end()) {
+        Entry entry;
+        entry.root = location.root == LocalMachine ? HKEY_LOCAL_MACHINE : HKEY_CURRENT_USER;
+        entry.keyPath = location.keyPath.toStdWString();
+        entry.valueName = location.valueName.toStdWString();
+        it = entries.insert(id, entry);
+    }
+
+    Entry &entry = it.value();
+    bool watching = arm(entry);
+    if (watching && !entry.notifier) {
+        entry.notifier = new QWinEventNotifier(entry.event, this);
+        connect(entry.notifier, &QWinEventNotifier::activated, this, [this, id]() { onKeyChanged(id); });
+    }
+    return watching;
+}
+
+QVariant Win32KeyStore::read(int id)
+{
+    auto it = entries.constFind(id);
+    if (it == entries.constEnd() || !it->key) {
+        return QVariant();
+    }
+    return readValue(it->key, it->valueName);
+}
+
+void Win32KeyStore::onKeyChanged(int id)
+{
+    auto it = entries.find(id);
+    if (it == entries.end()) {
+        return;
+    }
+
+    bool watching = arm(it.value());
+    if (!watching) {
+        qWarning() << "Failed to re-arm registry notification for" << QString::fromStdWString(it->keyPath);
+    }
+    emit changed(id, watching);
+}
+
+QVariant Win32KeyStore::readValue(HKEY key, const std::wstring &valueName)
+{
+    DWORD type = 0;
+    DWORD size = 0;
+    if (RegQueryValueEx(key, valueName.c_str(), nullptr, &type, nullptr, &size) != ERROR_SUCCESS) {
+        return QVariant();
+    }
+
+    QByteArray data(static_cast<qsizetype>(size), Qt::Uninitialized);
+    if (RegQueryValueEx(key,
+                        valueName.c_str(),
+                        nullptr,
+                        &type,
+                        reinterpret_cast<LPBYTE>(data.data()),
+                        &size)
+        != ERROR_SUCCESS) {
+        return QVariant();
+    }
+    data.resize(static_cast<qsizetype>(size));
+
+    switch (type) {
+    case REG_SZ:
+    case REG_EXPAND_SZ:
+        return QString::fromWCharArray(reinterpret_cast<const wchar_t *>(data.constData()),
+                                       static_cast<int>(wcsnlen(reinterpret_cast<const wchar_t *>(data.constData()),
+                                                                data.size() / sizeof(wchar_t))));
+    case REG_DWORD:
+        return data.size() >= static_cast<qsizetype>(sizeof(DWORD))
+                   ? QVariant(static_cast<uint>(*reinterpret_cast<const DWORD *>(data.constData())))
+                   : QVariant();
+    default:
+        return data;
+    }
+}
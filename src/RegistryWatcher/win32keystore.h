@@ -0,0 +1,40 @@
+#ifndef WIN32KEYSTORE_H
+#define WIN32KEYSTORE_H
+
+#include <QMap>
+#include <QWinEventNotifier>
+#include <string>
+#include <windows.h>
+#include "keystore.h"
+
+// Reads registry values and watches their keys with RegNotifyChangeKeyValue.
+class Win32KeyStore : public KeyStore
+{
+    Q_OBJECT
+
+public:
+    explicit Win32KeyStore(QObject *parent = nullptr);
+    ~Win32KeyStore();
+
+    bool watch(int id, const Location &location) override;
+    QVariant read(int id) override;
+
+private:
+    struct Entry
+    {
+        HKEY root = nullptr;
+        std::wstring keyPath;
+        std::wstring valueName;
+        HKEY key = nullptr;
+        HANDLE event = nullptr;
+        QWinEventNotifier *notifier = nullptr;
+    };
+
+    static bool arm(Entry &entry);
+    void onKeyChanged(int id);
+    static QVariant readValue(HKEY key, const std::wstring &valueName);
+
+    QMap<int, Entry> entries;
+};
+
+#endif // WIN32KEYSTORE_H
@@ -0,0 +1,378 @@
+#include "rulematcher.h"
+#include <QDebug>
+#include <QStringList>
+#include <QVarLengthArray>
+#include <algorithm>
+
+bool RuleMatcher::Rule::operator==(const Rule &other) const
+{
+    return kind == other.kind && pattern == other.pattern
+           && processImage.compare(other.processImage, Qt::CaseInsensitive) == 0;
+}
+
+bool RuleMatcher::Rule::operator!=(const Rule &other) const
+{
+    return !(*this == other);
+}
+
+RuleMatcher::RuleMatcher(const ProcessTable *processes)
+    : processes(processes)
+    , processFilters(false)
+{
+    clear();
+}
+
+RuleMatcher::~RuleMatcher() {}
+
+RuleMatcher::Rule RuleMatcher::parseRule(const QString &pattern, const QString &processImage)
+{
+    Rule rule;
+    QString trimmed = pattern.trimmed();
+    if (trimmed.startsWith("re:")) {
+        rule.kind = Regex;
+        rule.pattern = trimmed.mid(3);
+    } else {
+        rule.kind = trimmed.contains('*') || trimmed.contains('?') ? Glob : Words;
+        rule.pattern = trimmed;
+    }
+    rule.processImage = processImage.trimmed();
+    return rule;
+}
+
+void RuleMatcher::clear()
+{
+    ruleList.clear();
+    processFilters = false;
+    words.clear();
+    wordRules.clear();
+    globs.clear();
+    literalFreeGlobs.clear();
+    nodes.clear();
+    nodes.append(Node());
+    transitions.clear();
+    combinedRegex = QRegularExpression();
+    regexRules.clear();
+    regexGroups.clear();
+    combinedRegexes.clear();
+    regexes.clear();
+}
+
+void RuleMatcher::setRules(const QList<Rule> &rules)
+{
+    clear();
+
+    for (const Rule &rule : rules) {
+        if (rule.pattern.isEmpty()) {
+            continue;
+        }
+        int index = ruleList.size();
+
+        if (rule.kind == Words) {
+            int target = words.addTarget(rule.pattern);
+            if (target == wordRules.size()) {
+                wordRules.append(QList<int>());
+            }
+            wordRules[target].append(index);
+        } else if (rule.kind == Glob) {
+            QString folded(rule.pattern.size(), Qt::Uninitialized);
+            TitleMatcher::fold(reinterpret_cast<const char16_t *>(rule.pattern.utf16()),
+                               rule.pattern.size(),
+                               reinterpret_cast<char16_t *>(folded.data()));
+            globs.append({index, folded});
+        } else {
+            QRegularExpression regex(rule.pattern, QRegularExpression::CaseInsensitiveOption);
+            if (!regex.isValid()) {
+                qWarning() << "Ignoring invalid window rule regex" << rule.pattern << regex.errorString();
+                continue;
+            }
+            regexRules.append(index);
+            regexes.append(regex);
+        }
+
+        processFilters = processFilters || !rule.processImage.isEmpty();
+        ruleList.append(rule);
+    }
+
+    compileGlobs();
+    compileRegexes();
+}
+
+quint64 RuleMatcher::transitionKey(int state, char16_t unit)
+{
+    return (quint64(state) << 16) | unit;
+}
+
+QStringView RuleMatcher::requiredLiteral(QStringView glob)
+{
+    QStringView longest;
+    qsizetype start = 0;
+    for (qsizetype i = 0; i <= glob.size(); ++i) {
+        if (i == glob.size() || glob[i] == u'*' || glob[i] == u'?') {
+            if (i - start > longest.size()) {
+                longest = glob.sliced(start, i - start);
+            }
+            start = i + 1;
+        }
+    }
+    return longest;
+}
+
+void RuleMatcher::compileGlobs()
+{
+    // The longest literal of each glob goes into the automaton; a glob is only checked
+    // in full once its literal has been seen in the title.
+    QList<QList<QPair<char16_t, int>>> children(1);
+    for (int i = 0; i < globs.size(); ++i) {
+        QStringView literal = requiredLiteral(globs[i].folded);
+        if (literal.isEmpty()) {
+            literalFreeGlobs.append(i);
+            continue;
+        }
+
+        int state = 0;
+        for (QChar unit : literal) {
+            auto it = transitions.constFind(transitionKey(state, unit.unicode()));
+            if (it != transitions.constEnd()) {
+                state = it.value();
+                continue;
+            }
+            int next = nodes.size();
+            nodes.append(Node());
+            children.append(QList<QPair<char16_t, int>>());
+            transitions.insert(transitionKey(state, unit.unicode()), next);
+            children[state].append(qMakePair(unit.unicode(), next));
+            state = next;
+        }
+        nodes[state].globs.append(i);
+    }
+
+    // Breadth-first, so every failure target is complete before its dependents.
+    QList<int> queue;
+    for (const auto &child : std::as_const(children[0])) {
+        queue.append(child.second);
+    }
+    for (int head = 0; head < queue.size(); ++head) {
+        int state = queue[head];
+        for (const auto &child : std::as_const(children[state])) {
+            int fail = nodes[state].fail;
+            int target = step(fail, child.first);
+            nodes[child.second].fail = target == child.second ? 0 : target;
+            nodes[child.second].globs += nodes[nodes[child.second].fail].globs;
+            queue.append(child.second);
+        }
+    }
+}
+
+bool RuleMatcher::refersToGroupNumbers(QStringView pattern)
+{
+    // Errs on the side of running a regex alone: \N, \g..., (?N), (?+N), (?-N), (?R)
+    // and conditions on a group number all count, wherever they appear.
+    for (qsizetype i = 0; i + 1 < pattern.size(); ++i) {
+        QChar next = pattern[i + 1];
+        if (pattern[i] == u'\\') {
+            if ((next >= u'1' && next <= u'9') || next == u'g') {
+                return true;
+            }
+            ++i;
+        } else if (pattern[i] == u'(' && next == u'?' && i + 2 < pattern.size()) {
+            qsizetype at = i + 2;
+            if (pattern[at] == u'(' && at + 1 < pattern.size()) {
+                ++at;
+            }
+            if (pattern[at] == u'+' || pattern[at] == u'-') {
+                ++at;
+            }
+            if (at < pattern.size() && (pattern[at].isDigit() || pattern[at] == u'R')) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void RuleMatcher::compileRegexes()
+{
+    // Each rule is wrapped in its own group, so the last group that captured tells
+    // which alternative fired.
+    QStringList alternatives;
+    int group = 1;
+    for (int i = 0; i < regexes.size(); ++i) {
+        if (refersToGroupNumbers(regexes[i].pattern())) {
+            continue;
+        }
+        combinedRegexes.append(i);
+        regexGroups.append(group);
+        alternatives.append("(" + regexes[i].pattern() + ")");
+        group += 1 + regexes[i].captureCount();
+    }
+    if (alternatives.isEmpty()) {
+        return;
+    }
+
+    combinedRegex = QRegularExpression(alternatives.join('|'), QRegularExpression::CaseInsensitiveOption);
+    if (!combinedRegex.isValid()) {
+        // E.g. the same group name used in two rules; each regex then runs on its own.
+        qWarning() << "Window rule regexes could not be combined:" << combinedRegex.errorString();
+        combinedRegex = QRegularExpression();
+        combinedRegexes.clear();
+        return;
+    }
+    combinedRegex.optimize();
+}
+
+int RuleMatcher::step(int state, char16_t unit) const
+{
+    while (true) {
+        auto it = transitions.constFind(transitionKey(state, unit));
+        if (it != transitions.constEnd()) {
+            return it.value();
+        }
+        if (state == 0) {
+            return 0;
+        }
+        state = nodes[state].fail;
+    }
+}
+
+bool RuleMatcher::globMatches(QStringView glob, QStringView text)
+{
+    qsizetype g = 0;
+    qsizetype t = 0;
+    qsizetype star = -1;
+    qsizetype resume = 0;
+    while (t < text.size()) {
+        if (g < glob.size() && (glob[g] == u'?' || glob[g] == text[t])) {
+            ++g;
+            ++t;
+        } else if (g < glob.size() && glob[g] == u'*') {
+            star = g++;
+            resume = t;
+        } else if (star >= 0) {
+            g = star + 1;
+            t = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (g < glob.size() && glob[g] == u'*') {
+        ++g;
+    }
+    return g == glob.size();
+}
+
+bool RuleMatcher::acceptsProcess(int rule, quint32 processId) const
+{
+    const QString &image = ruleList[rule].processImage;
+    if (image.isEmpty()) {
+        return true;
+    }
+    return processes && processes->imageName(processId).compare(image, Qt::CaseInsensitive) == 0;
+}
+
+int RuleMatcher::matchWindow(QStringView title, quint32 processId)
+{
+    if (ruleList.isEmpty() || title.isEmpty()) {
+        return -1;
+    }
+    int best = ruleList.size();
+
+    if (!words.isEmpty()) {
+        wordHits.clear();
+        words.matchAll(title, wordHits);
+        for (int target : std::as_const(wordHits)) {
+            for (int rule : wordRules[target]) {
+                if (rule < best && acceptsProcess(rule, processId)) {
+                    best = rule;
+                }
+            }
+        }
+    }
+
+    if (!globs.isEmpty()) {
+        QVarLengthArray<char16_t, 256> foldedBuffer(title.size());
+        TitleMatcher::fold(title.utf16(), title.size(), foldedBuffer.data());
+        QStringView folded(foldedBuffer.constData(), foldedBuffer.size());
+
+        auto check = [&](int glob) {
+            int rule = globs[glob].rule;
+            if (rule < best && globMatches(globs[glob].folded, folded) && acceptsProcess(rule, processId)) {
+                best = rule;
+            }
+        };
+
+        for (int glob : literalFreeGlobs) {
+            check(glob);
+        }
+        int state = 0;
+        for (QChar unit : folded) {
+            state = step(state, unit.unicode());
+            for (int glob : nodes[state].globs) {
+                check(glob);
+            }
+        }
+    }
+
+    if (!regexes.isEmpty()) {
+        int first = best;
+        bool combinedMissed = false;
+        if (combinedRegex.isValid()) {
+            QRegularExpressionMatch match = combinedRegex.matchView(title);
+            if (match.hasMatch()) {
+                int alternative = int(std::upper_bound(regexGroups.cbegin(), regexGroups.cend(),
+                                                       match.lastCapturedIndex())
+                                      - regexGroups.cbegin())
+                                  - 1;
+                int rule = regexRules[combinedRegexes[alternative]];
+                if (rule < best && acceptsProcess(rule, processId)) {
+                    best = rule;
+                }
+                // The alternation reports the leftmost match, which is not necessarily
+                // the first rule; only then are earlier regexes run on their own.
+                first = best;
+            } else {
+                combinedMissed = true;
+            }
+        }
+        for (int i = 0; i < regexes.size() && regexRules[i] < first; ++i) {
+            // A miss of the alternation rules out every regex in it.
+            if (combinedMissed && std::binary_search(combinedRegexes.cbegin(), combinedRegexes.cend(), i)) {
+                continue;
+            }
+            if (acceptsProcess(regexRules[i], processId) && regexes[i].matchView(title).hasMatch()) {
+                best = regexRules[i];
+                break;
+            }
+        }
+    }
+
+    return best < ruleList.size() ? best : -1;
+}
+
+const QList<RuleMatcher::Rule> &RuleMatcher::rules() const
+{
+    return ruleList;
+}
+
+QString RuleMatcher::describeRule(int index) const
+{
+    if (index < 0 || index >= ruleList.size()) {
+        return QString();
+    }
+    const Rule &rule = ruleList[index];
+    static const char *const KIND_NAMES[] = {"words", "glob", "regex"};
+    QString description = QString("%1 \"%2\"").arg(KIND_NAMES[rule.kind], rule.pattern);
+    if (!rule.processImage.isEmpty()) {
+        description += QString(" in %1").arg(rule.processImage);
+    }
+    return description;
+}
+
+bool RuleMatcher::usesProcessFilters() const
+{
+    return processFilters;
+}
+
+bool RuleMatcher::isEmpty() const
+{
+    return ruleList.isEmpty();
+}
@@ -0,0 +1,92 @@
+#ifndef RULEMATCHER_H
+#define RULEMATCHER_H
+
+#include <QHash>
+#include <QList>
+#include <QRegularExpression>
+#include <QString>
+#include "processtable.h"
+#include "titlematcher.h"
+#include "windowmatcher.h"
+
+// Matches windows against a list of rules, each optionally tied to a process image.
+// The rules are compiled by kind into engines that each take one pass over the title
+// however many rules they hold: word sets share a TitleMatcher, the literal part of
+// every glob feeds one Aho-Corasick automaton and the regexes form one alternation.
+// Only rules one of those passes reports are checked in full. Regexes that refer to
+// groups by number would see other rules' groups in the alternation, so they run alone.
+class RuleMatcher : public WindowMatcher
+{
+public:
+    enum Kind { Words, Glob, Regex };
+
+    struct Rule
+    {
+        Kind kind = Words;
+        QString pattern;
+        QString processImage;
+
+        bool operator==(const Rule &other) const;
+        bool operator!=(const Rule &other) const;
+    };
+
+    RuleMatcher(const ProcessTable *processes);
+    ~RuleMatcher();
+
+    // "re:" starts a regex, a pattern containing * or ? is a glob matched against the
+    // whole title, anything else is a set of words that must all appear.
+    static Rule parseRule(const QString &pattern, const QString &processImage = QString());
+
+    void setRules(const QList<Rule> &rules);
+    const QList<Rule> &rules() const;
+    QString describeRule(int index) const;
+    bool usesProcessFilters() const;
+
+    bool isEmpty() const override;
+    // Returns the index of the first rule that fires for the window, or -1.
+    int matchWindow(QStringView title, quint32 processId) override;
+
+private:
+    struct GlobRule
+    {
+        int rule;
+        QString folded;
+    };
+
+    struct Node
+    {
+        int fail = 0;
+        QList<int> globs;
+    };
+
+    void clear();
+    void compileGlobs();
+    void compileRegexes();
+    int step(int state, char16_t unit) const;
+    bool acceptsProcess(int rule, quint32 processId) const;
+    static QStringView requiredLiteral(QStringView glob);
+    static bool globMatches(QStringView glob, QStringView text);
+    static bool refersToGroupNumbers(QStringView pattern);
+    static quint64 transitionKey(int state, char16_t unit);
+
+    const ProcessTable *processes;
+    QList<Rule> ruleList;
+    bool processFilters;
+
+    TitleMatcher words;
+    QList<QList<int>> wordRules;
+    QList<int> wordHits;
+
+    QList<GlobRule> globs;
+    QList<int> literalFreeGlobs;
+    QList<Node> nodes;
+    QHash<quint64, int> transitions;
+
+    QRegularExpression combinedRegex;
+    QList<int> regexRules;
+    QList<int> regexGroups;
+    QList<int> combinedRegexes;
+    QList<QRegularExpression> regexes;
+};
+
+#endif // RULEMATCHER_H
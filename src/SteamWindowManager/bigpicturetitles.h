@@ -0,0 +1,309 @@
+#ifndef BIGPICTURETITLES_H
+#define BIGPICTURETITLES_H
+
+#include <QStringView>
+#include <QtGlobal>
+#include "titlematcher.h"
+
+// Localized Big Picture window titles, folded, tokenized and hashed at compile time.
+// Everything here is constant-initialized, so nothing runs at process start.
+namespace BigPictureTitles {
+
+struct Entry
+{
+    const char16_t *language;
+    const char16_t *title;
+};
+
+// One line per language. Titles may only use characters foldUnit() knows about.
+inline constexpr Entry ENTRIES[] = {
+    {u"schinese", u"Steam 大屏幕模式"},
+    {u"tchinese", u"Steam Big Picture 模式"},
+    {u"japanese", u"Steam Big Pictureモード"},
+    {u"koreana", u"Steam Big Picture 모드"},
+    {u"thai", u"โหมด Big Picture บน Steam"},
+    {u"bulgarian", u"Steam режим „Голям екран“"},
+    {u"czech", u"Steam režim Big Picture"},
+    {u"danish", u"Steam Big Picture-tilstand"},
+    {u"german", u"Big-Picture-Modus"},
+    {u"english", u"Steam Big Picture mode"},
+    {u"spanish", u"Modo Big Picture de Steam"},
+    {u"latam", u"Modo Big Picture de Steam"},
+    {u"greek", u"Steam Λειτουργία Big Picture"},
+    {u"french", u"Steam mode Big Picture"},
+    {u"indonesian", u"Mode Big Picture Steam"},
+    {u"italian", u"Modalità Big Picture di Steam"},
+    {u"hungarian", u"Steam Nagy Kép mód"},
+    {u"dutch", u"Steam Big Picture-modus"},
+    {u"norwegian", u"Steam Big Picture-modus"},
+    {u"polish", u"Tryb Big Picture Steam"},
+    {u"portuguese", u"Steam Big Picture"},
+    {u"brazilian", u"Steam Modo Big Picture"},
+    {u"romanian", u"Steam modul Big Picture"},
+    {u"russian", u"Режим Big Picture"},
+    {u"finnish", u"Steamin televisiotila"},
+    {u"swedish", u"Steams Big Picture-läge"},
+    {u"turkish", u"Steam Geniş Ekran Modu"},
+    {u"vietnamese", u"Chế độ Big Picture trên Steam"},
+    {u"ukrainian", u"Steam у режимі Big Picture"},
+};
+
+inline constexpr int COUNT = int(sizeof(ENTRIES) / sizeof(ENTRIES[0]));
+inline constexpr int MAX_TITLE_LENGTH = 48;
+inline constexpr int MAX_TOKENS = 8;
+inline constexpr int LANGUAGE_BUCKETS = 128;
+inline constexpr quint8 NO_LANGUAGE = 0xFF;
+
+constexpr int length(const char16_t *text)
+{
+    int size = 0;
+    while (text[size] != 0) {
+        ++size;
+    }
+    return size;
+}
+
+// Scripts the compile-time fold handles: caseless ones and those with simple case pairs.
+constexpr bool isFoldable(char16_t unit)
+{
+    return unit < 0x0180                          // ASCII, Latin-1, Latin Extended-A
+           || (unit >= 0x0386 && unit <= 0x03CE)  // Greek
+           || (unit >= 0x0400 && unit <= 0x045F)  // Cyrillic
+           || (unit >= 0x0E00 && unit <= 0x0E7F)  // Thai
+           || (unit >= 0x1E00 && unit <= 0x1EFF)  // Latin Extended Additional
+           || (unit >= 0x2000 && unit <= 0x206F)  // General Punctuation
+           || (unit >= 0x3000 && unit <= 0x9FFF)  // CJK, kana
+           || (unit >= 0xAC00 && unit <= 0xD7AF); // Hangul
+}
+
+// Same result as TitleMatcher::fold() for every unit accepted by isFoldable().
+constexpr char16_t foldUnit(char16_t unit)
+{
+    if (unit >= u'A' && unit <= u'Z') {
+        return char16_t(unit + 0x20);
+    }
+    if (unit == 0x00A0) {
+        return u' ';
+    }
+    if (unit >= 0x00C0 && unit <= 0x00DE && unit != 0x00D7) {
+        return char16_t(unit + 0x20);
+    }
+    if (unit == 0x0130) {
+        return u'i';
+    }
+    if (unit == 0x0178) {
+        return 0x00FF;
+    }
+    if ((unit >= 0x0100 && unit <= 0x0137) || (unit >= 0x014A && unit <= 0x0177)) {
+        return char16_t(unit | 1);
+    }
+    if ((unit >= 0x0139 && unit <= 0x0148) || (unit >= 0x0179 && unit <= 0x017E)) {
+        return (unit & 1) ? char16_t(unit + 1) : unit;
+    }
+    if (unit == 0x0386) {
+        return 0x03AC;
+    }
+    if (unit >= 0x0388 && unit <= 0x038A) {
+        return char16_t(unit + 0x25);
+    }
+    if (unit == 0x038C) {
+        return 0x03CC;
+    }
+    if (unit == 0x038E || unit == 0x038F) {
+        return char16_t(unit + 0x3F);
+    }
+    if (unit >= 0x0391 && unit <= 0x03AB && unit != 0x03A2) {
+        return char16_t(unit + 0x20);
+    }
+    if (unit >= 0x0400 && unit <= 0x040F) {
+        return char16_t(unit + 0x50);
+    }
+    if (unit >= 0x0410 && unit <= 0x042F) {
+        return char16_t(unit + 0x20);
+    }
+    if (unit == 0x1E9E) {
+        return 0x00DF;
+    }
+    if ((unit >= 0x1E00 && unit <= 0x1E94) || (unit >= 0x1EA0 && unit <= 0x1EFF)) {
+        return char16_t(unit | 1);
+    }
+    return unit;
+}
+
+struct CompiledTitle
+{
+    char16_t folded[MAX_TITLE_LENGTH];
+    int length;
+    int tokenCount;
+    int tokenStart[MAX_TOKENS];
+    int tokenLength[MAX_TOKENS];
+    quint32 tokenHash[MAX_TOKENS];
+};
+
+struct CompiledTable
+{
+    CompiledTitle titles[COUNT];
+};
+
+// Splits on spaces exactly like TitleMatcher::nextToken().
+constexpr CompiledTitle compileTitle(const char16_t *title)
+{
+    CompiledTitle compiled{};
+    compiled.length = length(title);
+    for (int i = 0; i < compiled.length; ++i) {
+        compiled.folded[i] = foldUnit(title[i]);
+    }
+
+    int pos = 0;
+    while (pos < compiled.length) {
+        while (pos < compiled.length && compiled.folded[pos] == u' ') {
+            ++pos;
+        }
+        if (pos >= compiled.length) {
+            break;
+        }
+        int start = pos;
+        quint32 hash = TitleMatcher::HASH_SEED;
+        while (pos < compiled.length && compiled.folded[pos] != u' ') {
+            hash = TitleMatcher::hashStep(hash, compiled.folded[pos]);
+            ++pos;
+        }
+        compiled.tokenStart[compiled.tokenCount] = start;
+        compiled.tokenLength[compiled.tokenCount] = pos - start;
+        compiled.tokenHash[compiled.tokenCount] = hash;
+        ++compiled.tokenCount;
+    }
+    return compiled;
+}
+
+constexpr int countTokens(const char16_t *title)
+{
+    int count = 0;
+    bool inToken = false;
+    for (int i = 0; title[i] != 0; ++i) {
+        bool separator = foldUnit(title[i]) == u' ';
+        if (!separator && !inToken) {
+            ++count;
+        }
+        inToken = !separator;
+    }
+    return count;
+}
+
+constexpr bool titlesFit()
+{
+    for (const Entry &entry : ENTRIES) {
+        if (length(entry.title) > MAX_TITLE_LENGTH || countTokens(entry.title) > MAX_TOKENS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr bool titlesFoldable()
+{
+    for (const Entry &entry : ENTRIES) {
+        for (int i = 0; entry.title[i] != 0; ++i) {
+            if (!isFoldable(entry.title[i])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static_assert(COUNT < NO_LANGUAGE, "Too many languages for the language index");
+static_assert(titlesFit(), "Raise MAX_TITLE_LENGTH or MAX_TOKENS");
+static_assert(titlesFoldable(), "A title uses a character foldUnit() does not handle");
+
+constexpr CompiledTable compileTable()
+{
+    CompiledTable table{};
+    for (int i = 0; i < COUNT; ++i) {
+        table.titles[i] = compileTitle(ENTRIES[i].title);
+    }
+    return table;
+}
+
+inline constexpr CompiledTable TABLE = compileTable();
+
+constexpr quint32 languageHash(quint32 seed, const char16_t *language, int size)
+{
+    quint32 hash = TitleMatcher::HASH_SEED ^ seed;
+    for (int i = 0; i < size; ++i) {
+        hash = TitleMatcher::hashStep(hash, language[i]);
+    }
+    return hash;
+}
+
+// FNV's low bits only depend on the low bits of the input, so fold the high half in.
+constexpr int languageBucket(quint32 hash)
+{
+    return int((hash ^ (hash >> 16)) % LANGUAGE_BUCKETS);
+}
+
+struct LanguageIndex
+{
+    quint32 seed;
+    quint8 buckets[LANGUAGE_BUCKETS];
+};
+
+// Searches for a seed under which every language lands in its own bucket.
+constexpr LanguageIndex buildLanguageIndex()
+{
+    for (quint32 seed = 1; seed < 0x10000; ++seed) {
+        LanguageIndex index{};
+        index.seed = seed;
+        for (quint8 &bucket : index.buckets) {
+            bucket = NO_LANGUAGE;
+        }
+
+        bool collision = false;
+        for (int i = 0; i < COUNT && !collision; ++i) {
+            int bucket = languageBucket(
+                languageHash(seed, ENTRIES[i].language, length(ENTRIES[i].language)));
+            collision = index.buckets[bucket] != NO_LANGUAGE;
+            index.buckets[bucket] = quint8(i);
+        }
+        if (!collision) {
+            return index;
+        }
+    }
+    return LanguageIndex{};
+}
+
+inline constexpr LanguageIndex LANGUAGE_INDEX = buildLanguageIndex();
+static_assert(LANGUAGE_INDEX.seed != 0, "No perfect hash seed found, raise LANGUAGE_BUCKETS");
+
+// Returns the ENTRIES index of a lowercase Steam language name, or -1.
+inline int findLanguage(QStringView language)
+{
+    int bucket = languageBucket(
+        languageHash(LANGUAGE_INDEX.seed, language.utf16(), int(language.size())));
+    int index = LANGUAGE_INDEX.buckets[bucket];
+    if (index == NO_LANGUAGE || language != QStringView(ENTRIES[index].language)) {
+        return -1;
+    }
+    return index;
+}
+
+inline QStringView foldedToken(int entry, int token)
+{
+    const CompiledTitle &title = TABLE.titles[entry];
+    return QStringView(title.folded + title.tokenStart[token], title.tokenLength[token]);
+}
+
+// Adds the precompiled title of an entry to matcher and returns its target index.
+inline int addTitle(TitleMatcher &matcher, int entry)
+{
+    const CompiledTitle &compiled = TABLE.titles[entry];
+    TitleMatcher::FoldedToken tokens[MAX_TOKENS];
+    for (int token = 0; token < compiled.tokenCount; ++token) {
+        tokens[token] = {foldedToken(entry, token), compiled.tokenHash[token]};
+    }
+    return matcher.addFoldedTarget(QString::fromUtf16(ENTRIES[entry].title), tokens, compiled.tokenCount);
+}
+
+} // namespace BigPictureTitles
+
+#endif // BIGPICTURETITLES_H
@@ -1,137 +1,268 @@
 #include "SteamWindowManager.h"
 #include <QDebug>
+#include "bigpicturetitles.h"
+#include "tracerecorder.h"
+#include <QElapsedTimer>
 
-const QMap<QString, QString> SteamWindowManager::BIG_PICTURE_WINDOW_TITLES
-    = {{"schinese", "Steam 大屏幕模式"},
-       {"tchinese", "Steam Big Picture 模式"},
-       {"japanese", "Steam Big Pictureモード"},
-       {"koreana", "Steam Big Picture 모드"},
-       {"thai", "โหมด Big Picture บน Steam"},
-       {"bulgarian", "Steam режим „Голям екран“"},
-       {"czech", "Steam režim Big Picture"},
-       {"danish", "Steam Big Picture-tilstand"},
-       {"german", "Big-Picture-Modus"},
-       {"english", "Steam Big Picture mode"},
-       {"spanish", "Modo Big Picture de Steam"},
-       {"latam", "Modo Big Picture de Steam"},
-       {"greek", "Steam Λειτουργία Big Picture"},
-       {"french", "Steam mode Big Picture"},
-       {"indonesian", "Mode Big Picture Steam"},
-       {"italian", "Modalità Big Picture di Steam"},
-       {"hungarian", "Steam Nagy Kép mód"},
-       {"dutch", "Steam Big Picture-modus"},
-       {"norwegian", "Steam Big Picture-modus"},
-       {"polish", "Tryb Big Picture Steam"},
-       {"portuguese", "Steam Big Picture"},
-       {"brazilian", "Steam Modo Big Picture"},
-       {"romanian", "Steam modul Big Picture"},
-       {"russian", "Режим Big Picture"},
-       {"finnish", "Steamin televisiotila"},
-       {"swedish", "Steams Big Picture-läge"},
-       {"turkish", "Steam Geniş Ekran Modu"},
-       {"vietnamese", "Chế độ Big Picture trên Steam"},
-       {"ukrainian", "Steam у режимі Big Picture"}};
-
-const QChar SteamWindowManager::NON_BREAKING_SPACE = QChar(0x00A0);
-
-SteamWindowManager::SteamWindowManager() {}
+namespace {
+class FirstMatchVisitor : public WindowVisitor
+{
+public:
+    FirstMatchVisitor(WindowMatcher &matcher, const WindowFilter *filter, SweepStats &stats)
+        : matcher(matcher)
+        , filter(filter)
+        , stats(stats)
+        , result(-1)
+    {}
 
-SteamWindowManager::~SteamWindowManager() {}
+    bool acceptWindow(quintptr window, const WindowAttributes &attributes) override
+    {
+        Q_UNUSED(window)
+        ++stats.windowsVisited;
+        if (filter && !filter->accepts(attributes)) {
+            ++stats.windowsFiltered;
+            return false;
+        }
+        // The class name buffer stays valid until visitWindow() returns.
+        current = attributes;
+        return true;
+    }
+
+    bool visitWindow(quintptr window, QStringView title) override
+    {
+        Q_UNUSED(window)
+        ++stats.titleReads;
+        result = matcher.matchWindow(title, current.processId);
+        if (result >= 0) {
+            matchedClassName = current.className.toString();
+            matchedProcessId = current.processId;
+        }
+        return result < 0;
+    }
 
-QString SteamWindowManager::getRegistryValue(const std::wstring &keyPath, const std::wstring &valueName) const
+    WindowMatcher &matcher;
+    const WindowFilter *filter;
+    SweepStats &stats;
+    WindowAttributes current;
+    int result;
+    QString matchedClassName;
+    quint32 matchedProcessId = 0;
+};
+} // namespace
+
+const QString SteamWindowManager::STEAM_PROCESS_NAME = "steam.exe";
+const QStringList SteamWindowManager::BIG_PICTURE_CLASS_NAMES = {"SDL_app"};
+const QStringList SteamWindowManager::BIG_PICTURE_PROCESS_IMAGES = {"steamwebhelper.exe"};
+const int SteamWindowManager::STEAM_CHECK_INTERVAL_MS = 2000;
+
+SteamWindowManager::SteamWindowManager()
+    : customMatcher(&processTable)
+    , windowTable(&windowEnumerator, &sweepStats)
+    , incrementalSweeps(false)
+    , processTable(&processSource)
+    , bigPictureFilter(&processTable)
+    , customFilter(&processTable)
 {
-    HKEY hKey;
-    WCHAR value[256];
-    DWORD valueLength = sizeof(value);
-    QString result;
+    // Big Picture is an SDL window owned by the Steam web helper. Anything else it
+    // turns out to use is learned the first time it matches.
+    bigPictureFilter.setClassNames(BIG_PICTURE_CLASS_NAMES);
+    bigPictureFilter.setProcessImages(BIG_PICTURE_PROCESS_IMAGES);
+    bigPictureFilter.setSkipToolWindows(true);
+    customFilter.setSkipToolWindows(true);
+
+    // Every localized title is matched at once, so detection does not depend on the
+    // registry language being present or up to date. The titles were folded and
+    // tokenized at compile time; only the matcher's index is built here.
+    for (int entry = 0; entry < BigPictureTitles::COUNT; ++entry) {
+#ifndef QT_NO_DEBUG
+        const BigPictureTitles::CompiledTitle &compiled = BigPictureTitles::TABLE.titles[entry];
+        QString title = QString::fromUtf16(BigPictureTitles::ENTRIES[entry].title);
+        QString folded(title.size(), Qt::Uninitialized);
+        TitleMatcher::fold(reinterpret_cast<const char16_t *>(title.utf16()),
+                           title.size(),
+                           reinterpret_cast<char16_t *>(folded.data()));
+        Q_ASSERT(folded == QStringView(compiled.folded, compiled.length));
+#endif
 
-    if (RegOpenKeyEx(HKEY_CURRENT_USER, keyPath.c_str(), 0, KEY_READ, &hKey) == ERROR_SUCCESS) {
-        if (RegQueryValueEx(hKey, valueName.c_str(), NULL, NULL, (LPBYTE)value, &valueLength)
-            == ERROR_SUCCESS) {
-            result = QString::fromWCharArray(value).toLower();
+        int index = BigPictureTitles::addTitle(bigPictureMatcher, entry);
+        if (index == bigPictureLanguages.size()) {
+            bigPictureLanguages.append(QStringList());
         }
-        RegCloseKey(hKey);
+        bigPictureLanguages[index].append(QString::fromUtf16(BigPictureTitles::ENTRIES[entry].language));
     }
-
-    return result;
 }
 
-QString SteamWindowManager::getSteamLanguage() const
+SteamWindowManager::~SteamWindowManager() {}
+
+void SteamWindowManager::setCustomWindowRules(const QList<RuleMatcher::Rule> &rules)
 {
-    return getRegistryValue(L"Software\\Valve\\Steam\\steamglobal", L"Language");
+    if (rules != customMatcher.rules()) {
+        customMatcher.setRules(rules);
+        customFilter.clearLearned();
+        windowTable.invalidateVerdicts();
+    }
 }
 
-QString SteamWindowManager::cleanString(const QString &str) const
+bool SteamWindowManager::hasCustomWindowRules() const
 {
-    QString cleanedStr = str;
-    return cleanedStr.replace(NON_BREAKING_SPACE, ' ');
+    return !customMatcher.isEmpty();
 }
 
-QString SteamWindowManager::getBigPictureWindowTitle() const
+void SteamWindowManager::setCustomWindowClasses(const QStringList &classNames)
 {
-    QString language = getSteamLanguage().toLower();
-    return BIG_PICTURE_WINDOW_TITLES.value(language, BIG_PICTURE_WINDOW_TITLES.value("english"));
+    customFilter.setClassNames(classNames);
 }
 
-QVector<QString> SteamWindowManager::getAllWindowTitles() const
+void SteamWindowManager::setCustomProcess(const QString &processSpec)
 {
-    QVector<QString> windowTitles;
+    // "image.exe [command line fragment]", e.g. "steamwebhelper.exe -gamepadui"
+    QString spec = processSpec.trimmed();
+    int space = spec.indexOf(' ');
+    customProcessImage = space < 0 ? spec : spec.left(space);
+    customProcessArguments = space < 0 ? QString() : spec.mid(space + 1).trimmed();
+    if (!customProcessImage.isEmpty() && !customProcessImage.endsWith(".exe", Qt::CaseInsensitive)) {
+        customProcessImage += ".exe";
+    }
 
-    EnumWindows(
-        [](HWND hwnd, LPARAM lParam) -> BOOL {
-            QVector<QString> *titles = reinterpret_cast<QVector<QString> *>(lParam);
+    processTable.clearWatchedImages();
+    if (!customProcessArguments.isEmpty()) {
+        processTable.watchImage(customProcessImage);
+    }
+}
 
-            if (IsWindowVisible(hwnd) && !(GetWindowLong(hwnd, GWL_STYLE) & WS_MINIMIZE)) {
-                WCHAR windowTitle[256];
-                if (GetWindowText(hwnd, windowTitle, sizeof(windowTitle) / sizeof(WCHAR)) > 0) {
-                    titles->append(QString::fromWCharArray(windowTitle));
-                }
-            }
-            return TRUE;
-        },
-        reinterpret_cast<LPARAM>(&windowTitles));
+void SteamWindowManager::setIncrementalSweeps(bool enabled)
+{
+    // Events may have been missed while sweeps were not incremental.
+    incrementalSweeps = enabled;
+    windowTable.invalidateAll();
+}
 
-    return windowTitles;
+void SteamWindowManager::invalidateWindow(quintptr window)
+{
+    windowTable.invalidate(window);
 }
 
-bool SteamWindowManager::isBigPictureRunning() const
+int SteamWindowManager::findMatchingWindow(WindowMatcher &matcher, WindowFilter &filter)
 {
-    QString bigPictureTitle = cleanString(getBigPictureWindowTitle().toLower());
-    QStringList bigPictureWords = bigPictureTitle.split(' ', Qt::SkipEmptyParts);
+    if (matcher.isEmpty()) {
+        return -1;
+    }
 
-    QVector<QString> currentWindowTitles = getAllWindowTitles();
-    for (const auto &windowTitle : currentWindowTitles) {
-        QString cleanedTitle = cleanString(windowTitle.toLower());
-        QStringList windowWords = cleanedTitle.split(' ', Qt::SkipEmptyParts);
+    bool filtered = filter.shouldFilter();
+    TraceRecorder::Span span(QStringLiteral("window sweep"), "detection",
+                             filtered ? QStringLiteral("filtered") : QStringLiteral("full"));
+    int index = -1;
+    QString className;
+    quint32 processId = 0;
 
-        if (std::all_of(bigPictureWords.begin(),
-                        bigPictureWords.end(),
-                        [&windowWords](const QString &word) {
-                            return windowWords.contains(word);
-                        })) {
-            return true;
+    // Without window events there is no way to know which titles changed, so the
+    // titles are matched straight from the enumeration and it stops at the first hit.
+    if (!incrementalSweeps) {
+        QElapsedTimer timer;
+        timer.start();
+        FirstMatchVisitor visitor(matcher, filtered ? &filter : nullptr, sweepStats);
+        windowEnumerator.visitWindows(visitor);
+        ++sweepStats.sweeps;
+        sweepStats.sweepNanoseconds += timer.nsecsElapsed();
+        index = visitor.result;
+        className = visitor.matchedClassName;
+        processId = visitor.matchedProcessId;
+    } else {
+        windowTable.setMatcher(&matcher);
+        windowTable.setFilter(filtered ? &filter : nullptr);
+        windowTable.sweep();
+        quintptr window = 0;
+        index = windowTable.matchingTarget(&window);
+        WindowAttributes attributes;
+        if (index >= 0 && windowTable.windowAttributes(window, attributes)) {
+            className = attributes.className.toString();
+            processId = attributes.processId;
         }
     }
-    return false;
+
+    if (index >= 0) {
+        filter.learn(className, processId);
+    }
+    filter.recordSweep(filtered, index >= 0);
+    return index;
 }
 
-bool SteamWindowManager::isCustomWindowRunning(const QString &windowTitle) const
+bool SteamWindowManager::isBigPictureRunning()
 {
-    QString cleanedWindowTitle = cleanString(windowTitle.toLower());
-    QStringList customWindowTitleWords = cleanedWindowTitle.split(' ', Qt::SkipEmptyParts);
+    // Big Picture cannot be up without the Steam client, and the process list is far
+    // cheaper to check than every window title. Steam does not come and go often, so
+    // one snapshot is reused across fast ticks.
+    if (processTable.refresh(STEAM_CHECK_INTERVAL_MS) && !processTable.isRunning(STEAM_PROCESS_NAME)) {
+        return false;
+    }
 
-    QVector<QString> currentWindowTitles = getAllWindowTitles();
-    for (const auto &windowTitle : currentWindowTitles) {
-        QString cleanedTitle = cleanString(windowTitle.toLower());
-        QStringList windowWords = cleanedTitle.split(' ', Qt::SkipEmptyParts);
+    int index = findMatchingWindow(bigPictureMatcher, bigPictureFilter);
+    if (index < 0) {
+        return false;
+    }
 
-        if (std::all_of(customWindowTitleWords.begin(),
-                        customWindowTitleWords.end(),
-                        [&windowWords](const QString &word) {
-                            return windowWords.contains(word);
-                        })) {
-            return true;
-        }
+    const QStringList &languages = bigPictureLanguages[index];
+    detectedLanguage = languages.contains(preferredLanguage) ? preferredLanguage : languages.first();
+    return true;
+}
+
+bool SteamWindowManager::isCustomWindowRunning()
+{
+    if (customFilter.usesProcessImages() || customMatcher.usesProcessFilters()) {
+        processTable.refresh();
+    }
+    int rule = findMatchingWindow(customMatcher, customFilter);
+    if (rule >= 0) {
+        matchedCustomRule = customMatcher.describeRule(rule);
     }
-    return false;
+    return rule >= 0;
+}
+
+bool SteamWindowManager::isCustomProcessRunning()
+{
+    if (customProcessImage.isEmpty() || !processTable.refresh()) {
+        return false;
+    }
+    return processTable.isRunning(customProcessImage, customProcessArguments);
+}
+
+bool SteamWindowManager::isSteamRunning() const
+{
+    // Reflects the last refresh, done by isBigPictureRunning().
+    return processTable.isRunning(STEAM_PROCESS_NAME);
+}
+
+void SteamWindowManager::setPreferredLanguage(const QString &language)
+{
+    preferredLanguage = language.toLower();
+}
+
+QString SteamWindowManager::getDetectedLanguage() const
+{
+    return detectedLanguage;
+}
+
+QString SteamWindowManager::getMatchedCustomRule() const
+{
+    return matchedCustomRule;
+}
+
+QString SteamWindowManager::takeDetectionStats()
+{
+    const SweepStats &stats = sweepStats;
+    if (stats.sweeps == 0) {
+        return QString();
+    }
+
+    QString summary = QString("%1 sweeps, %2 ns/sweep, %3 windows/sweep, %4 title reads/sweep, "
+                              "%5 filtered/sweep, %6 title copies (%7 bytes)")
+                          .arg(stats.sweeps)
+                          .arg(stats.sweepNanoseconds / qint64(stats.sweeps))
+                          .arg(double(stats.windowsVisited) / stats.sweeps, 0, 'f', 1)
+                          .arg(double(stats.titleReads) / stats.sweeps, 0, 'f', 1)
+                          .arg(double(stats.windowsFiltered) / stats.sweeps, 0, 'f', 1)
+                          .arg(stats.titleCopies)
+                          .arg(stats.titleBytesCopied);
+    sweepStats = SweepStats();
+    return summary;
 }
@@ -1,26 +1,61 @@
 #ifndef STEAMWINDOWMANAGER_H
 #define STEAMWINDOWMANAGER_H
 
-#include <QMap>
 #include <QStringList>
 #include <QVector>
 #include <windows.h>
+#include "processtable.h"
+#include "rulematcher.h"
+#include "titlematcher.h"
+#include "win32processsource.h"
+#include "win32windowenumerator.h"
+#include "windowfilter.h"
+#include "windowtable.h"
 
 class SteamWindowManager {
 public:
     SteamWindowManager();
     ~SteamWindowManager();
-    bool isBigPictureRunning() const;
-    bool isCustomWindowRunning(const QString &windowTitle) const;
-    QString getSteamLanguage() const;
-    QString getBigPictureWindowTitle() const;
+    bool isBigPictureRunning();
+    bool isCustomWindowRunning();
+    bool isCustomProcessRunning();
+    bool isSteamRunning() const;
+    void setCustomWindowRules(const QList<RuleMatcher::Rule> &rules);
+    bool hasCustomWindowRules() const;
+    // Restricts custom title matching to these window classes; empty learns them.
+    void setCustomWindowClasses(const QStringList &classNames);
+    void setCustomProcess(const QString &processSpec);
+    void setIncrementalSweeps(bool enabled);
+    void invalidateWindow(quintptr window);
+    // Language reported when a title is shared by several, normally the client language.
+    // It is passed in so detection can run off the thread that owns the registry watcher.
+    void setPreferredLanguage(const QString &language);
+    QString getDetectedLanguage() const;
+    QString getMatchedCustomRule() const;
+    QString takeDetectionStats();
 
 private:
-    QString getRegistryValue(const std::wstring &keyPath, const std::wstring &valueName) const;
-    QString cleanString(const QString &str) const;
-    QVector<QString> getAllWindowTitles() const;
-    static const QMap<QString, QString> BIG_PICTURE_WINDOW_TITLES;
-    static const QChar NON_BREAKING_SPACE;
+    int findMatchingWindow(WindowMatcher &matcher, WindowFilter &filter);
+    TitleMatcher bigPictureMatcher;
+    QList<QStringList> bigPictureLanguages;
+    QString detectedLanguage;
+    QString preferredLanguage;
+    RuleMatcher customMatcher;
+    QString matchedCustomRule;
+    Win32WindowEnumerator windowEnumerator;
+    SweepStats sweepStats;
+    WindowTable windowTable;
+    bool incrementalSweeps;
+    Win32ProcessSource processSource;
+    ProcessTable processTable;
+    QString customProcessImage;
+    QString customProcessArguments;
+    WindowFilter bigPictureFilter;
+    WindowFilter customFilter;
+    static const QString STEAM_PROCESS_NAME;
+    static const QStringList BIG_PICTURE_CLASS_NAMES;
+    static const QStringList BIG_PICTURE_PROCESS_IMAGES;
+    static const int STEAM_CHECK_INTERVAL_MS;
 };
 
 #endif // STEAMWINDOWMANAGER_H
@@ -0,0 +1,93 @@
+#include "systemstatemonitor.h"
+#include <QDebug>
+#include <wtsapi32.h>
+
+namespace {
+const wchar_t *WINDOW_CLASS_NAME = L"BigPictureTVSystemStateMonitor";
+}
+
+SystemStateMonitor::SystemStateMonitor(QObject *parent)
+    : QObject(parent)
+    , messageWindow(nullptr)
+    , displayNotification(nullptr)
+    , sessionLocked(false)
+    , displayOff(false)
+{
+    WNDCLASSEX windowClass = {};
+    windowClass.cbSize = sizeof(windowClass);
+    windowClass.lpfnWndProc = windowProc;
+    windowClass.hInstance = GetModuleHandle(nullptr);
+    windowClass.lpszClassName = WINDOW_CLASS_NAME;
+    RegisterClassEx(&windowClass);
+
+    // Session and power notifications are delivered to a window, and Qt's event loop
+    // dispatches messages for every window owned by this thread.
+    messageWindow = CreateWindowEx(0, WINDOW_CLASS_NAME, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr,
+                                   windowClass.hInstance, nullptr);
+    if (!messageWindow) {
+        qWarning() << "Failed to create the system state window";
+        return;
+    }
+    SetWindowLongPtr(messageWindow, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
+
+    if (!WTSRegisterSessionNotification(messageWindow, NOTIFY_FOR_THIS_SESSION)) {
+        qWarning() << "Failed to register for session notifications";
+    }
+    displayNotification = RegisterPowerSettingNotification(messageWindow,
+                                                           &GUID_CONSOLE_DISPLAY_STATE,
+                                                           DEVICE_NOTIFY_WINDOW_HANDLE);
+}
+
+SystemStateMonitor::~SystemStateMonitor()
+{
+    if (displayNotification) {
+        UnregisterPowerSettingNotification(displayNotification);
+    }
+    if (messageWindow) {
+        WTSUnRegisterSessionNotification(messageWindow);
+        DestroyWindow(messageWindow);
+    }
+}
+
+bool SystemStateMonitor::isSessionLocked() const
+{
+    return sessionLocked;
+}
+
+bool SystemStateMonitor::isDisplayOff() const
+{
+    return displayOff;
+}
+
+bool SystemStateMonitor::isOnBattery() const
+{
+    SYSTEM_POWER_STATUS status;
+    return GetSystemPowerStatus(&status) && status.ACLineStatus == 0;
+}
+
+LRESULT CALLBACK SystemStateMonitor::windowProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    SystemStateMonitor *monitor = reinterpret_cast<SystemStateMonitor *>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
+    if (monitor) {
+        monitor->handleMessage(message, wParam, lParam);
+    }
+    return DefWindowProc(hwnd, message, wParam, lParam);
+}
+
+void SystemStateMonitor::handleMessage(UINT message, WPARAM wParam, LPARAM lParam)
+{
+    if (message == WM_WTSSESSION_CHANGE) {
+        if (wParam == WTS_SESSION_LOCK || wParam == WTS_SESSION_UNLOCK) {
+            sessionLocked = (wParam == WTS_SESSION_LOCK);
+            emit stateChanged();
+        }
+    } else if (message == WM_POWERBROADCAST && wParam == PBT_POWERSETTINGCHANGE) {
+        const POWERBROADCAST_SETTING *setting = reinterpret_cast<const POWERBROADCAST_SETTING *>(lParam);
+        if (setting && IsEqualGUID(setting->PowerSetting, GUID_CONSOLE_DISPLAY_STATE)
+            && setting->DataLength >= sizeof(DWORD)) {
+            // 0 = off, 1 = on, 2 = dimmed
+            displayOff = (*reinterpret_cast<const DWORD *>(setting->Data) == 0);
+            emit stateChanged();
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef SYSTEMSTATEMONITOR_H
+#define SYSTEMSTATEMONITOR_H
+
+#include <QObject>
+#include <windows.h>
+
+class SystemStateMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SystemStateMonitor(QObject *parent = nullptr);
+    ~SystemStateMonitor();
+
+    bool isSessionLocked() const;
+    bool isDisplayOff() const;
+    bool isOnBattery() const;
+
+signals:
+    void stateChanged();
+
+private:
+    static LRESULT CALLBACK windowProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam);
+    void handleMessage(UINT message, WPARAM wParam, LPARAM lParam);
+
+    HWND messageWindow;
+    HPOWERNOTIFY displayNotification;
+    bool sessionLocked;
+    bool displayOff;
+};
+
+#endif // SYSTEMSTATEMONITOR_H
@@ -0,0 +1,267 @@
+#include "titlematcher.h"
+#include <QVarLengthArray>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TITLEMATCHER_SSE2
+#include <emmintrin.h>
+#endif
+
+TitleMatcher::TitleMatcher() {}
+
+TitleMatcher::~TitleMatcher() {}
+
+void TitleMatcher::foldScalar(const char16_t *source, qsizetype length, char16_t *destination)
+{
+    for (qsizetype i = 0; i < length; ++i) {
+        char16_t unit = source[i];
+        if (unit < 0x80) {
+            destination[i] = (unit >= u'A' && unit <= u'Z') ? char16_t(unit + 0x20) : unit;
+        } else if (unit == 0x00A0) {
+            destination[i] = u' ';
+        } else if (QChar::isHighSurrogate(unit) && i + 1 < length && QChar::isLowSurrogate(source[i + 1])) {
+            char32_t folded = QChar::toLower(QChar::surrogateToUcs4(unit, source[i + 1]));
+            destination[i] = QChar::highSurrogate(folded);
+            destination[i + 1] = QChar::lowSurrogate(folded);
+            ++i;
+        } else {
+            destination[i] = char16_t(QChar::toLower(char32_t(unit)));
+        }
+    }
+}
+
+void TitleMatcher::fold(const char16_t *source, qsizetype length, char16_t *destination)
+{
+    qsizetype i = 0;
+
+#ifdef TITLEMATCHER_SSE2
+    const __m128i nonAsciiBits = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i beforeA = _mm_set1_epi16('A' - 1);
+    const __m128i afterZ = _mm_set1_epi16('Z' + 1);
+    const __m128i caseBit = _mm_set1_epi16(0x20);
+
+    while (i + 8 <= length) {
+        __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+        __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(units, nonAsciiBits), zero);
+
+        if (_mm_movemask_epi8(ascii) != 0xFFFF) {
+            // Non-ASCII block: fold it with full Unicode rules, keeping a surrogate pair
+            // that straddles the block boundary together.
+            qsizetype end = i + 8;
+            while (end < length && QChar::isHighSurrogate(source[end - 1])) {
+                ++end;
+            }
+            foldScalar(source + i, end - i, destination + i);
+            i = end;
+            continue;
+        }
+
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi16(units, beforeA), _mm_cmplt_epi16(units, afterZ));
+        __m128i folded = _mm_add_epi16(units, _mm_and_si128(upper, caseBit));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), folded);
+        i += 8;
+    }
+#endif
+
+    foldScalar(source + i, length - i, destination + i);
+}
+
+bool TitleMatcher::nextToken(QStringView folded, qsizetype &pos, QStringView &token, quint32 &hash)
+{
+    while (pos < folded.size() && folded[pos] == u' ') {
+        ++pos;
+    }
+    if (pos >= folded.size()) {
+        return false;
+    }
+
+    qsizetype start = pos;
+    hash = HASH_SEED;
+    while (pos < folded.size() && folded[pos] != u' ') {
+        hash = hashStep(hash, folded[pos].unicode());
+        ++pos;
+    }
+    token = folded.sliced(start, pos - start);
+    return true;
+}
+
+int TitleMatcher::findToken(quint32 hash, QStringView foldedToken) const
+{
+    auto candidates = tokenIndex.equal_range(hash);
+    for (auto it = candidates.first; it != candidates.second; ++it) {
+        if (foldedToken == tokens[it.value()]) {
+            return it.value();
+        }
+    }
+    return -1;
+}
+
+void TitleMatcher::clear()
+{
+    targets.clear();
+    tokens.clear();
+    tokenTargets.clear();
+    tokenIndex.clear();
+    seenTokens.clear();
+    targetHits.clear();
+}
+
+int TitleMatcher::findTarget(const QString &title) const
+{
+    for (int i = 0; i < targets.size(); ++i) {
+        if (targets[i].title == title) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void TitleMatcher::addToken(Target &target, int targetIndex, QStringView foldedToken, quint32 hash)
+{
+    int token = findToken(hash, foldedToken);
+    if (token < 0) {
+        token = tokens.size();
+        tokens.append(foldedToken.toString());
+        tokenTargets.append(QList<int>());
+        tokenIndex.insert(hash, token);
+        seenTokens.append(false);
+    }
+    if (!target.tokens.contains(token)) {
+        target.tokens.append(token);
+        tokenTargets[token].append(targetIndex);
+    }
+}
+
+int TitleMatcher::addTarget(const QString &title)
+{
+    int existing = findTarget(title);
+    if (existing >= 0) {
+        return existing;
+    }
+
+    int targetIndex = targets.size();
+    Target target;
+    target.title = title;
+
+    QString folded(title.size(), Qt::Uninitialized);
+    fold(reinterpret_cast<const char16_t *>(title.utf16()),
+         title.size(),
+         reinterpret_cast<char16_t *>(folded.data()));
+
+    qsizetype pos = 0;
+    QStringView token;
+    quint32 hash = HASH_SEED;
+    while (nextToken(folded, pos, token, hash)) {
+        addToken(target, targetIndex, token, hash);
+    }
+
+    targets.append(target);
+    targetHits.append(0);
+    return targetIndex;
+}
+
+int TitleMatcher::addFoldedTarget(const QString &title, const FoldedToken *foldedTokens, int count)
+{
+    int existing = findTarget(title);
+    if (existing >= 0) {
+        return existing;
+    }
+
+    int targetIndex = targets.size();
+    Target target;
+    target.title = title;
+    for (int i = 0; i < count; ++i) {
+        addToken(target, targetIndex, foldedTokens[i].text, foldedTokens[i].hash);
+    }
+
+    targets.append(target);
+    targetHits.append(0);
+    return targetIndex;
+}
+
+void TitleMatcher::setTarget(const QString &title)
+{
+    clear();
+    addTarget(title);
+}
+
+QString TitleMatcher::target(int index) const
+{
+    return index >= 0 && index < targets.size() ? targets[index].title : QString();
+}
+
+int TitleMatcher::targetCount() const
+{
+    return targets.size();
+}
+
+bool TitleMatcher::isEmpty() const
+{
+    return tokens.isEmpty();
+}
+
+int TitleMatcher::match(QStringView title)
+{
+    return scan(title, nullptr);
+}
+
+void TitleMatcher::matchAll(QStringView title, QList<int> &matched)
+{
+    scan(title, &matched);
+}
+
+int TitleMatcher::matchWindow(QStringView title, quint32 processId)
+{
+    Q_UNUSED(processId)
+    return scan(title, nullptr);
+}
+
+int TitleMatcher::scan(QStringView title, QList<int> *matched)
+{
+    if (tokens.isEmpty() || title.isEmpty()) {
+        return -1;
+    }
+
+    // Window titles are capped at 256 code units, so this stays on the stack.
+    QVarLengthArray<char16_t, 256> foldedBuffer(title.size());
+    fold(title.utf16(), title.size(), foldedBuffer.data());
+    QStringView folded(foldedBuffer.constData(), foldedBuffer.size());
+
+    std::fill(seenTokens.begin(), seenTokens.end(), false);
+    std::fill(targetHits.begin(), targetHits.end(), 0);
+    int best = -1;
+
+    qsizetype pos = 0;
+    QStringView token;
+    quint32 hash = HASH_SEED;
+    while (nextToken(folded, pos, token, hash)) {
+        int tokenIndexValue = findToken(hash, token);
+        if (tokenIndexValue < 0 || seenTokens[tokenIndexValue]) {
+            continue;
+        }
+        seenTokens[tokenIndexValue] = true;
+
+        for (int targetIndex : tokenTargets[tokenIndexValue]) {
+            const Target &target = targets[targetIndex];
+            if (++targetHits[targetIndex] != target.tokens.size()) {
+                continue;
+            }
+            if (matched) {
+                matched->append(targetIndex);
+            }
+            if (best < 0 || target.tokens.size() > targets[best].tokens.size()) {
+                best = targetIndex;
+                if (targets.size() == 1) {
+                    return best;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+bool TitleMatcher::matches(QStringView title)
+{
+    return match(title) >= 0;
+}
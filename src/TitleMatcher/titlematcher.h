@@ -0,0 +1,72 @@
+#ifndef TITLEMATCHER_H
+#define TITLEMATCHER_H
+
+#include <QList>
+#include <QMultiHash>
+#include <QString>
+#include <QStringView>
+#include "windowmatcher.h"
+
+class TitleMatcher : public WindowMatcher
+{
+public:
+    struct FoldedToken
+    {
+        QStringView text;
+        quint32 hash;
+    };
+
+    // FNV-1a over folded UTF-16 code units, usable at compile time for generated tables.
+    static constexpr quint32 HASH_SEED = 2166136261u;
+    static constexpr quint32 hashStep(quint32 hash, char16_t unit) { return (hash ^ unit) * 16777619u; }
+
+    TitleMatcher();
+    ~TitleMatcher();
+
+    void clear();
+    int addTarget(const QString &title);
+    // Adds a target whose tokens were already folded and hashed, e.g. at compile time.
+    int addFoldedTarget(const QString &title, const FoldedToken *foldedTokens, int count);
+    void setTarget(const QString &title);
+    QString target(int index = 0) const;
+    int targetCount() const;
+    bool isEmpty() const override;
+
+    // Returns the index of the target whose words all appear in the title, or -1.
+    // When several targets match, the one with the most words wins.
+    // Does not allocate: the title is folded into a stack buffer and tokenized in place,
+    // and the per-scan counters are kept between calls.
+    int match(QStringView title);
+    bool matches(QStringView title);
+    // Appends every target whose words all appear in the title.
+    void matchAll(QStringView title, QList<int> &matched);
+    int matchWindow(QStringView title, quint32 processId) override;
+
+    // Lowercases and maps U+00A0 to a space, one UTF-16 code unit out for each one in.
+    // ASCII runs take a vectorized path; other code units get full Unicode lowercasing.
+    static void fold(const char16_t *source, qsizetype length, char16_t *destination);
+
+private:
+    struct Target
+    {
+        QString title;
+        QList<int> tokens;
+    };
+
+    static void foldScalar(const char16_t *source, qsizetype length, char16_t *destination);
+    static bool nextToken(QStringView folded, qsizetype &pos, QStringView &token, quint32 &hash);
+    int findToken(quint32 hash, QStringView foldedToken) const;
+    int findTarget(const QString &title) const;
+    int scan(QStringView title, QList<int> *matched);
+    void addToken(Target &target, int targetIndex, QStringView foldedToken, quint32 hash);
+
+    QList<Target> targets;
+    QList<QString> tokens;
+    QList<QList<int>> tokenTargets;
+    QMultiHash<quint32, int> tokenIndex;
+    // Scratch state for scan(), sized as tokens and targets are added.
+    QList<bool> seenTokens;
+    QList<int> targetHits;
+};
+
+#endif // TITLEMATCHER_H
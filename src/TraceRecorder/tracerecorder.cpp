@@ -0,0 +1,189 @@
+#include "tracerecorder.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QThread>
+
+// A transition produces a few dozen spans, so this holds many of them plus the
+// detection sweeps in between.
+const int TraceRecorder::CAPACITY = 8192;
+
+TraceRecorder::Span::Span(const QString &name, const char *category, const QString &detail)
+    : category(nullptr)
+    , startUs(0)
+{
+    TraceRecorder *recorder = TraceRecorder::instance();
+    if (!recorder->isEnabled()) {
+        return;
+    }
+    this->name = name;
+    this->category = category;
+    this->detail = detail;
+    startUs = recorder->now();
+}
+
+TraceRecorder::Span::~Span()
+{
+    if (!category) {
+        return;
+    }
+    TraceRecorder *recorder = TraceRecorder::instance();
+    recorder->record(name, category, startUs, recorder->now() - startUs, detail);
+}
+
+bool TraceRecorder::Span::isRecording() const
+{
+    return category != nullptr;
+}
+
+void TraceRecorder::Span::setName(const QString &name)
+{
+    if (category) {
+        this->name = name;
+    }
+}
+
+void TraceRecorder::Span::setDetail(const QString &detail)
+{
+    if (category) {
+        this->detail = detail;
+    }
+}
+
+TraceRecorder *TraceRecorder::instance()
+{
+    static TraceRecorder recorder;
+    return &recorder;
+}
+
+TraceRecorder::TraceRecorder()
+    : enabled(false)
+    , written(0)
+{
+    clock.start();
+}
+
+TraceRecorder::~TraceRecorder() {}
+
+quint32 TraceRecorder::currentThreadId()
+{
+    // The Win32 thread id on Windows, which is what other trace tools show.
+    return quint32(quintptr(QThread::currentThreadId()));
+}
+
+void TraceRecorder::setEnabled(bool enabled)
+{
+    if (enabled) {
+        QMutexLocker locker(&mutex);
+        if (events.isEmpty()) {
+            events.resize(CAPACITY);
+        }
+    }
+    this->enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool TraceRecorder::isEnabled() const
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+qint64 TraceRecorder::now() const
+{
+    return clock.nsecsElapsed() / 1000;
+}
+
+void TraceRecorder::record(const QString &name, const char *category, qint64 startUs, qint64 durationUs,
+                           const QString &detail)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    Event event;
+    event.name = name;
+    event.category = category;
+    event.detail = detail;
+    event.startUs = startUs;
+    event.durationUs = durationUs;
+    event.threadId = currentThreadId();
+
+    QMutexLocker locker(&mutex);
+    if (events.isEmpty()) {
+        return;
+    }
+    events[written % CAPACITY] = event;
+    ++written;
+}
+
+void TraceRecorder::setThreadName(const QString &name)
+{
+    QMutexLocker locker(&mutex);
+    threadNames.insert(currentThreadId(), name);
+}
+
+int TraceRecorder::size() const
+{
+    QMutexLocker locker(&mutex);
+    return int(qMin<qint64>(written, CAPACITY));
+}
+
+void TraceRecorder::clear()
+{
+    QMutexLocker locker(&mutex);
+    written = 0;
+}
+
+bool TraceRecorder::writeChromeTrace(const QString &path) const
+{
+    QJsonArray traceEvents;
+    {
+        QMutexLocker locker(&mutex);
+        qint64 pid = QCoreApplication::applicationPid();
+
+        for (auto it = threadNames.cbegin(); it != threadNames.cend(); ++it) {
+            QJsonObject metadata;
+            metadata["name"] = "thread_name";
+            metadata["ph"] = "M";
+            metadata["pid"] = pid;
+            metadata["tid"] = qint64(it.key());
+            metadata["args"] = QJsonObject{{"name", it.value()}};
+            traceEvents.append(metadata);
+        }
+
+        // Oldest first once the ring has wrapped.
+        qint64 first = qMax<qint64>(0, written - CAPACITY);
+        for (qint64 i = first; i < written; ++i) {
+            const Event &event = events[i % CAPACITY];
+            QJsonObject object;
+            object["name"] = event.name;
+            object["cat"] = event.category;
+            object["ph"] = "X";
+            object["ts"] = event.startUs;
+            object["dur"] = event.durationUs;
+            object["pid"] = pid;
+            object["tid"] = qint64(event.threadId);
+            if (!event.detail.isEmpty()) {
+                object["args"] = QJsonObject{{"detail", event.detail}};
+            }
+            traceEvents.append(object);
+        }
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write trace to" << path << file.errorString();
+        return false;
+    }
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return true;
+}
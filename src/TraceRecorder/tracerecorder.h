@@ -0,0 +1,80 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+
+// Keeps the most recent timing spans of all threads in a fixed ring and writes them
+// out in the Chrome trace event format, which chrome://tracing and Perfetto open.
+// While disabled, recording a span costs a single relaxed atomic load.
+class TraceRecorder
+{
+public:
+    // Records the time between construction and destruction on the current thread.
+    class Span
+    {
+    public:
+        Span(const QString &name, const char *category, const QString &detail = QString());
+        ~Span();
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+        // Names and details that take work to build should only be set while recording.
+        bool isRecording() const;
+        void setName(const QString &name);
+        void setDetail(const QString &detail);
+
+    private:
+        QString name;
+        const char *category;
+        QString detail;
+        qint64 startUs;
+    };
+
+    static TraceRecorder *instance();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    // Microseconds on the trace clock, for spans that begin and end in different places.
+    qint64 now() const;
+    void record(const QString &name, const char *category, qint64 startUs, qint64 durationUs,
+                const QString &detail = QString());
+    void setThreadName(const QString &name);
+
+    int size() const;
+    void clear();
+    bool writeChromeTrace(const QString &path) const;
+
+    static const int CAPACITY;
+
+private:
+    struct Event
+    {
+        QString name;
+        const char *category = nullptr;
+        QString detail;
+        qint64 startUs = 0;
+        qint64 durationUs = 0;
+        quint32 threadId = 0;
+    };
+
+    TraceRecorder();
+    ~TraceRecorder();
+
+    static quint32 currentThreadId();
+
+    std::atomic<bool> enabled;
+    QElapsedTimer clock;
+    mutable QMutex mutex;
+    QList<Event> events;
+    qint64 written;
+    QHash<quint32, QString> threadNames;
+};
+
+#endif // TRACERECORDER_H
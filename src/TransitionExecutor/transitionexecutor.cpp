@@ -0,0 +1,269 @@
+#include "transitionexecutor.h"
+#include <QDebug>
+#include <QHash>
+#include <exception>
+#include "tracerecorder.h"
+
+// Enough for every independent action of a transition; they mostly wait on processes.
+const int TransitionExecutor::MAX_THREADS = 4;
+
+TransitionExecutor::TransitionExecutor(QObject *parent)
+    : QObject(parent)
+    , pool(new QThreadPool())
+    , elapsedMs(0)
+    , remaining(0)
+    , inFlight(0)
+    , running(false)
+    , cancelled(false)
+{
+    pool->setMaxThreadCount(MAX_THREADS);
+}
+
+TransitionExecutor::~TransitionExecutor()
+{
+    // Actions use objects owned by our owner, so none may outlive us.
+    pool->waitForDone();
+    delete pool;
+}
+
+void TransitionExecutor::clear()
+{
+    if (running) {
+        qWarning() << "Cannot change a transition while it is running";
+        return;
+    }
+    actions.clear();
+    dependents.clear();
+    waitingOn.clear();
+    actionTimings.clear();
+    elapsedMs = 0;
+}
+
+void TransitionExecutor::addAction(const QString &name,
+                                   const QStringList &dependencies,
+                                   std::function<void()> run,
+                                   Affinity affinity,
+                                   const StateCheck &check)
+{
+    if (running) {
+        qWarning() << "Cannot add" << name << "to a running transition";
+        return;
+    }
+    Action action;
+    action.name = name;
+    action.dependencies = dependencies;
+    action.run = std::move(run);
+    action.affinity = affinity;
+    action.check = check;
+    actions.append(action);
+}
+
+bool TransitionExecutor::resolve()
+{
+    QHash<QString, int> indices;
+    for (int i = 0; i < actions.size(); ++i) {
+        indices.insert(actions[i].name, i);
+    }
+
+    dependents = QList<QList<int>>(actions.size());
+    waitingOn = QList<int>(actions.size(), 0);
+    for (int i = 0; i < actions.size(); ++i) {
+        for (const QString &dependency : std::as_const(actions[i].dependencies)) {
+            // Dependencies on actions that are not part of this transition are met.
+            auto it = indices.constFind(dependency);
+            if (it == indices.constEnd()) {
+                continue;
+            }
+            if (it.value() == i) {
+                qWarning() << "Transition action" << actions[i].name << "depends on itself";
+                return false;
+            }
+            dependents[it.value()].append(i);
+            ++waitingOn[i];
+        }
+    }
+
+    // Kahn's algorithm; anything left unvisited sits on a cycle.
+    QList<int> pending = waitingOn;
+    QList<int> queue;
+    for (int i = 0; i < actions.size(); ++i) {
+        if (pending[i] == 0) {
+            queue.append(i);
+        }
+    }
+    for (int head = 0; head < queue.size(); ++head) {
+        for (int dependent : std::as_const(dependents[queue[head]])) {
+            if (--pending[dependent] == 0) {
+                queue.append(dependent);
+            }
+        }
+    }
+    if (queue.size() != actions.size()) {
+        qWarning() << "Transition actions have a dependency cycle";
+        return false;
+    }
+    return true;
+}
+
+bool TransitionExecutor::start()
+{
+    if (running || actions.isEmpty() || !resolve()) {
+        return false;
+    }
+
+    running = true;
+    cancelled.store(false, std::memory_order_relaxed);
+    remaining = actions.size();
+    inFlight = 0;
+    actionTimings = QList<Timing>(actions.size());
+    for (int i = 0; i < actions.size(); ++i) {
+        actionTimings[i].name = actions[i].name;
+    }
+    clock.start();
+
+    for (int i = 0; i < actions.size(); ++i) {
+        if (waitingOn[i] == 0) {
+            dispatch(i);
+        }
+    }
+    return true;
+}
+
+void TransitionExecutor::dispatch(int index)
+{
+    ++inFlight;
+
+    // The clock is only written by start(), so pool threads may read it meanwhile.
+    std::function<void()> run = actions[index].run;
+    StateCheck check = actions[index].check;
+    QString name = actions[index].name;
+    auto task = [this, index, run, check, name]() {
+        qint64 started = clock.elapsed();
+        // Cancelled while queued behind other actions.
+        Status status = cancelled.load(std::memory_order_acquire) ? Cancelled : Done;
+        QString state;
+        if (status == Done) {
+            // An exception escaping a pool thread would end the process.
+            try {
+                TraceRecorder::Span span(name, "transition");
+                if (check.currentState) {
+                    state = check.currentState();
+                    if (state.compare(check.desiredState, Qt::CaseInsensitive) == 0) {
+                        status = Skipped;
+                        if (span.isRecording()) {
+                            span.setDetail("skipped, already " + state);
+                        }
+                    }
+                }
+                if (status == Done) {
+                    run();
+                }
+            } catch (const std::exception &e) {
+                qWarning() << "Transition action" << name << "failed:" << e.what();
+            }
+        }
+        qint64 duration = clock.elapsed() - started;
+        QMetaObject::invokeMethod(this, [this, index, status, started, duration, state]() {
+            onActionFinished(index, status, started, duration, state);
+        }, Qt::QueuedConnection);
+    };
+
+    // Owner-thread actions are queued as well, so pool actions that became ready at
+    // the same time are started before they run.
+    if (actions[index].affinity == OwnerThread) {
+        QMetaObject::invokeMethod(this, task, Qt::QueuedConnection);
+    } else {
+        pool->start(task);
+    }
+}
+
+void TransitionExecutor::onActionFinished(int index, Status status, qint64 startedMs, qint64 durationMs,
+                                          const QString &state)
+{
+    actionTimings[index].status = status;
+    actionTimings[index].state = state;
+    actionTimings[index].startedMs = startedMs;
+    actionTimings[index].durationMs = durationMs;
+    --remaining;
+    --inFlight;
+
+    bool stopping = cancelled.load(std::memory_order_relaxed);
+    if (!stopping) {
+        for (int dependent : std::as_const(dependents[index])) {
+            if (--waitingOn[dependent] == 0) {
+                dispatch(dependent);
+            }
+        }
+    }
+
+    // Once cancelled, whatever never got dispatched stays NotStarted.
+    if (remaining == 0 || (stopping && inFlight == 0)) {
+        elapsedMs = clock.elapsed();
+        running = false;
+        emit finished();
+    }
+}
+
+bool TransitionExecutor::isRunning() const
+{
+    return running;
+}
+
+void TransitionExecutor::cancel()
+{
+    if (running && !cancelled.load(std::memory_order_relaxed)) {
+        cancelled.store(true, std::memory_order_release);
+        emit cancelling();
+    }
+}
+
+bool TransitionExecutor::wasCancelled() const
+{
+    return cancelled.load(std::memory_order_relaxed);
+}
+
+const std::atomic<bool> *TransitionExecutor::cancellationFlag() const
+{
+    return &cancelled;
+}
+
+const QList<TransitionExecutor::Timing> &TransitionExecutor::timings() const
+{
+    return actionTimings;
+}
+
+qint64 TransitionExecutor::totalMs() const
+{
+    return elapsedMs;
+}
+
+int TransitionExecutor::count(Status status) const
+{
+    int matching = 0;
+    for (const Timing &timing : actionTimings) {
+        matching += timing.status == status ? 1 : 0;
+    }
+    return matching;
+}
+
+QString TransitionExecutor::report() const
+{
+    QStringList parts;
+    qint64 sum = 0;
+    for (const Timing &timing : actionTimings) {
+        if (timing.status == Skipped) {
+            parts.append(QString("%1 skipped, already %2").arg(timing.name, timing.state));
+        } else if (timing.status == Cancelled || timing.status == NotStarted) {
+            parts.append(QString("%1 cancelled").arg(timing.name));
+        } else {
+            parts.append(QString("%1 +%2ms %3ms").arg(timing.name).arg(timing.startedMs).arg(timing.durationMs));
+            sum += timing.durationMs;
+        }
+    }
+    return QString("%1%2ms wall, %3ms sequential, %4 skipped (%5)")
+        .arg(wasCancelled() ? QString("cancelled after ") : QString())
+        .arg(elapsedMs)
+        .arg(sum)
+        .arg(count(Skipped))
+        .arg(parts.join(", "));
+}
@@ -0,0 +1,116 @@
+#ifndef TRANSITIONEXECUTOR_H
+#define TRANSITIONEXECUTOR_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+#include <functional>
+
+// Runs the actions of one transition as a dependency graph. An action starts as soon
+// as everything it depends on has finished, so independent actions overlap on a small
+// thread pool and the transition takes as long as its longest chain. All bookkeeping
+// happens on the thread that owns the executor.
+class TransitionExecutor : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Affinity {
+        Pool,
+        // For actions that touch objects living on the owning thread, e.g. RegistryWatcher.
+        OwnerThread
+    };
+
+    // Lets an action be skipped when the system is already in the state it would set.
+    // currentState() runs right before the action, on the same thread, so it may block
+    // like the action itself; states are compared case-insensitively.
+    struct StateCheck
+    {
+        std::function<QString()> currentState;
+        QString desiredState;
+    };
+
+    enum Status {
+        NotStarted,
+        Done,
+        Skipped,
+        Cancelled
+    };
+
+    struct Timing
+    {
+        QString name;
+        qint64 startedMs = 0;
+        qint64 durationMs = 0;
+        Status status = NotStarted;
+        QString state;
+    };
+
+    explicit TransitionExecutor(QObject *parent = nullptr);
+    ~TransitionExecutor();
+
+    // Builds the next transition; only allowed while not running.
+    void clear();
+    void addAction(const QString &name,
+                   const QStringList &dependencies,
+                   std::function<void()> run,
+                   Affinity affinity = Pool,
+                   const StateCheck &check = StateCheck());
+
+    // Dependencies on actions that were not added count as met. Returns false if
+    // nothing was started: already running, no actions, or a dependency cycle.
+    bool start();
+    bool isRunning() const;
+
+    // Stops the running transition at the next action boundary: nothing that has not
+    // started yet will. Running actions finish, or give up early if they check
+    // cancellationFlag(), e.g. between retries; actions that block on something else
+    // are woken through cancelling(). finished() follows once they are done.
+    void cancel();
+    bool wasCancelled() const;
+    const std::atomic<bool> *cancellationFlag() const;
+
+    const QList<Timing> &timings() const;
+    qint64 totalMs() const;
+    int count(Status status) const;
+    QString report() const;
+
+    static const int MAX_THREADS;
+
+signals:
+    // Emitted by cancel() after the flag is set.
+    void cancelling();
+    void finished();
+
+private:
+    struct Action
+    {
+        QString name;
+        QStringList dependencies;
+        std::function<void()> run;
+        Affinity affinity = Pool;
+        StateCheck check;
+    };
+
+    bool resolve();
+    void dispatch(int index);
+    void onActionFinished(int index, Status status, qint64 startedMs, qint64 durationMs, const QString &state);
+
+    QThreadPool *pool;
+    QList<Action> actions;
+    QList<QList<int>> dependents;
+    QList<int> waitingOn;
+    QList<Timing> actionTimings;
+    QElapsedTimer clock;
+    qint64 elapsedMs;
+    int remaining;
+    int inFlight;
+    bool running;
+    std::atomic<bool> cancelled;
+};
+
+#endif // TRANSITIONEXECUTOR_H
@@ -0,0 +1,48 @@
+#include "transitionplan.h"
+
+TransitionPlan::TransitionPlan()
+    : endpointGeneration(0)
+{}
+
+const TransitionPlan::Step &TransitionPlan::step(bool isDesktopMode) const
+{
+    return isDesktopMode ? exit : enter;
+}
+
+QString TransitionPlan::describeStep(const QString &title, const Step &step, bool isDesktopMode)
+{
+    QStringList lines;
+    lines << title;
+    lines << QString("  display: %1").arg(step.displayCommand.isEmpty() ? "unchanged" : step.displayCommand);
+    if (step.audioDevice.isEmpty()) {
+        lines << "  audio: unchanged";
+    } else if (step.audioEndpointId.isEmpty()) {
+        lines << QString("  audio: \"%1\", not present yet, matched when switching").arg(step.audioDevice);
+    } else {
+        lines << QString("  audio: \"%1\" -> %2 (%3)").arg(step.audioDevice, step.audioEndpointName, step.audioEndpointId);
+    }
+    if (step.powerPlan) {
+        lines << QString("  power plan: %1").arg(step.powerPlanGuid.isEmpty() ? "restore previous" : step.powerPlanGuid);
+    }
+    if (step.closeDiscord) {
+        lines << QString("  discord: %1").arg(isDesktopMode ? "restart if it was running" : "close");
+    }
+    if (step.nightLight) {
+        lines << QString("  night light: %1").arg(isDesktopMode ? "restore if it was on" : "disable");
+    }
+    if (step.pauseMedia) {
+        lines << "  media: pause";
+    }
+    return lines.join('\n');
+}
+
+QString TransitionPlan::describe() const
+{
+    QStringList parts;
+    parts << describeStep("Enter gamemode:", enter, false);
+    parts << describeStep("Exit gamemode:", exit, true);
+    if (!warnings.isEmpty()) {
+        parts << "Warnings:\n  " + warnings.join("\n  ");
+    }
+    return parts.join("\n\n");
+}
@@ -0,0 +1,46 @@
+#ifndef TRANSITIONPLAN_H
+#define TRANSITIONPLAN_H
+
+#include <QString>
+#include <QStringList>
+
+// What a transition will do in each direction, worked out from the settings ahead of
+// time so a transition only has to run it. A plan is never changed once built; new
+// settings or a different set of audio endpoints produce a new one.
+class TransitionPlan
+{
+public:
+    struct Step
+    {
+        bool closeDiscord = false;
+        bool nightLight = false;
+        bool pauseMedia = false;
+        bool powerPlan = false;
+        // Empty on the way back, which restores the plan that was active before.
+        QString powerPlanGuid;
+        // Empty when the display is left alone.
+        QString displayCommand;
+        // The configured name fragment; empty when audio is left alone.
+        QString audioDevice;
+        // The endpoint the fragment matched when the plan was built, if any. Endpoints
+        // that only appear after the display switch are matched when switching.
+        QString audioEndpointId;
+        QString audioEndpointName;
+    };
+
+    TransitionPlan();
+
+    const Step &step(bool isDesktopMode) const;
+    QString describe() const;
+
+    Step enter;
+    Step exit;
+    // Audio endpoint generation the endpoints were resolved against.
+    unsigned long long endpointGeneration;
+    QStringList warnings;
+
+private:
+    static QString describeStep(const QString &title, const Step &step, bool isDesktopMode);
+};
+
+#endif // TRANSITIONPLAN_H
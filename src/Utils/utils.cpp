@@ -2,18 +2,28 @@
 #include <QDebug>
 #include <QDir>
 #include <QFile>
-#include <QProcess>
-#include <QSettings>
 #include <QStandardPaths>
 #include <QTextStream>
 #include <QCoreApplication>
 #include <QFileInfo>
+#include <vector>
+#include "bigpicturetitles.h"
+#include "processrunner.h"
+#include "processtable.h"
+#include "registrywatcher.h"
+#include "win32processsource.h"
 
 const QString DISCORD_EXECUTABLE_NAME = "Update.exe";
 const QString DISCORD_PROCESS_NAME = "Discord.exe";
 const QString SUNSHINE_STATUS_FILE = QStandardPaths::writableLocation(
                                                QStandardPaths::AppDataLocation)
                                            + "/sunshine-status/status.txt";
+// Switching displays waits for the new mode to settle; PowerShell itself takes seconds
+// to start on a cold cache.
+const int DISPLAY_SWITCH_TIMEOUT_MS = 15000;
+const int POWERCFG_TIMEOUT_MS = 5000;
+const int TASK_TIMEOUT_MS = 5000;
+const int MODULE_QUERY_TIMEOUT_MS = 20000;
 
 Utils::Utils() {}
 
@@ -21,19 +31,50 @@ Utils::~Utils() {}
 
 void Utils::runEnhancedDisplayswitch(const QString &command)
 {
-    QProcess process;
     QString executablePath = "dependencies/EnhancedDisplaySwitch.exe";
-    process.start(executablePath, QStringList() << command);
-    process.waitForFinished();
+    ProcessRunner::Result result = ProcessRunner::instance()->run(
+        {executablePath, QStringList() << command, DISPLAY_SWITCH_TIMEOUT_MS});
+    if (!result.succeeded()) {
+        qWarning() << "EnhancedDisplaySwitch" << command << "failed:" << result.errorString << result.exitCode;
+    }
+}
+
+QString Utils::getDisplayTopology()
+{
+    UINT32 pathCount = 0;
+    UINT32 modeCount = 0;
+    if (GetDisplayConfigBufferSizes(QDC_DATABASE_CURRENT, &pathCount, &modeCount) != ERROR_SUCCESS) {
+        return QString();
+    }
+
+    std::vector<DISPLAYCONFIG_PATH_INFO> paths(pathCount);
+    std::vector<DISPLAYCONFIG_MODE_INFO> modes(modeCount);
+    DISPLAYCONFIG_TOPOLOGY_ID topology = DISPLAYCONFIG_TOPOLOGY_ID(0);
+    if (QueryDisplayConfig(QDC_DATABASE_CURRENT, &pathCount, paths.data(), &modeCount, modes.data(), &topology)
+        != ERROR_SUCCESS) {
+        return QString();
+    }
+
+    // Named like the EnhancedDisplaySwitch commands that select them.
+    switch (topology) {
+    case DISPLAYCONFIG_TOPOLOGY_INTERNAL:
+        return "/internal";
+    case DISPLAYCONFIG_TOPOLOGY_CLONE:
+        return "/clone";
+    case DISPLAYCONFIG_TOPOLOGY_EXTEND:
+        return "/extend";
+    case DISPLAYCONFIG_TOPOLOGY_EXTERNAL:
+        return "/external";
+    default:
+        return QString();
+    }
 }
 
 QString Utils::getTheme()
 {
     // Determine the theme based on registry value
-    QSettings settings(
-        "HKEY_CURRENT_USER\\Software\\Microsoft\\Windows\\CurrentVersion\\Themes\\Personalize",
-        QSettings::NativeFormat);
-    int value = settings.value("AppsUseLightTheme", 1).toInt();
+    QVariant setting = RegistryWatcher::instance()->value(RegistryWatcher::AppsUseLightTheme);
+    int value = setting.isValid() ? setting.toInt() : 1;
 
     // Return the opposite to match icon (dark icon on light theme)
     return (value == 0) ? "light" : "dark";
@@ -48,13 +89,24 @@ QIcon Utils::getIconForTheme()
 
 QString Utils::getActivePowerPlan()
 {
-    QString regPath = "HKEY_LOCAL_MACHINE\\SYSTEM\\CurrentControlSet\\Control\\Power\\User\\PowerSchemes";
-    QString regKey = "ActivePowerScheme";
-
-    QSettings settings(regPath, QSettings::NativeFormat);
-    QString activeSchemeGuid = settings.value(regKey).toString();
+    return RegistryWatcher::instance()->value(RegistryWatcher::ActivePowerScheme).toString();
+}
 
-    return activeSchemeGuid;
+QString Utils::readActivePowerPlan()
+{
+    wchar_t guid[64];
+    DWORD size = sizeof(guid);
+    if (RegGetValue(HKEY_LOCAL_MACHINE,
+                    L"SYSTEM\\CurrentControlSet\\Control\\Power\\User\\PowerSchemes",
+                    L"ActivePowerScheme",
+                    RRF_RT_REG_SZ,
+                    nullptr,
+                    guid,
+                    &size)
+        != ERROR_SUCCESS) {
+        return QString();
+    }
+    return QString::fromWCharArray(guid);
 }
 
 void Utils::setPowerPlan(QString planGuid)
@@ -63,16 +115,27 @@ void Utils::setPowerPlan(QString planGuid)
     QStringList arguments;
     arguments << "/s" << planGuid;
 
-    QProcess process;
-    process.start(command, arguments);
-    if (!process.waitForFinished()) {
-        qWarning() << "Failed to execute powercfg command:" << process.errorString();
+    ProcessRunner::Result result = ProcessRunner::instance()->run({command, arguments, POWERCFG_TIMEOUT_MS});
+    if (!result.started || result.timedOut) {
+        qWarning() << "Failed to execute powercfg command:" << result.errorString;
         return;
     }
 
-    if (process.exitCode() != 0) {
-        qWarning() << "powercfg command failed with exit code:" << process.exitCode();
+    if (result.exitCode != 0) {
+        qWarning() << "powercfg command failed with exit code:" << result.exitCode;
+    }
+}
+
+bool Utils::powerPlanExists(const QString &planGuid)
+{
+    std::wstring keyPath = L"SYSTEM\\CurrentControlSet\\Control\\Power\\User\\PowerSchemes\\"
+                           + planGuid.toStdWString();
+    HKEY key;
+    if (RegOpenKeyEx(HKEY_LOCAL_MACHINE, keyPath.c_str(), 0, KEY_READ, &key) != ERROR_SUCCESS) {
+        return false;
     }
+    RegCloseKey(key);
+    return true;
 }
 
 QString Utils::getDiscordPath()
@@ -94,15 +157,22 @@ bool Utils::isDiscordInstalled()
 
 bool Utils::isDiscordRunning()
 {
-    QProcess process;
-    process.start("tasklist.exe", QStringList() << "/FI" << QString("IMAGENAME eq %1").arg(DISCORD_PROCESS_NAME));
+    // A process snapshot is far cheaper than spawning tasklist.
+    Win32ProcessSource source;
+    ProcessTable processes(&source);
+    if (processes.refresh()) {
+        return processes.isRunning(DISCORD_PROCESS_NAME);
+    }
 
-    if (!process.waitForFinished()) {
+    ProcessRunner::Result result = ProcessRunner::instance()->run(
+        {"tasklist.exe", QStringList() << "/FI" << QString("IMAGENAME eq %1").arg(DISCORD_PROCESS_NAME), TASK_TIMEOUT_MS});
+
+    if (!result.started || result.timedOut) {
         qWarning() << "Failed to execute tasklist command";
         return false;
     }
 
-    QString output = process.readAllStandardOutput();
+    QString output = result.standardOutput;
     return output.contains(DISCORD_PROCESS_NAME, Qt::CaseInsensitive);
 }
 
@@ -112,10 +182,9 @@ void Utils::closeDiscord()
     arguments << "/IM" << DISCORD_PROCESS_NAME
               << "/F";
 
-    QProcess process;
-    process.start("taskkill.exe", arguments);
+    ProcessRunner::Result result = ProcessRunner::instance()->run({"taskkill.exe", arguments, TASK_TIMEOUT_MS});
 
-    if (!process.waitForFinished()) {
+    if (!result.started || result.timedOut) {
         qWarning() << "Failed to execute taskkill command to kill Discord";
     } else {
         qDebug() << "Taskkill command executed successfully";
@@ -134,38 +203,38 @@ void Utils::startDiscord()
     arguments << "--processStart" << DISCORD_PROCESS_NAME << "--process-start-args"
               << "--start-minimized";
 
-    qint64 processId;
-    bool success = QProcess::startDetached(discordPath, arguments, QString(), &processId);
+    bool success = ProcessRunner::instance()->startDetached({discordPath, arguments});
 
     if (!success) {
         qWarning() << "Failed to start Discord with arguments";
     }
 }
 
-bool Utils::isAudioDeviceCmdletsInstalled()
+QFuture<bool> Utils::isAudioDeviceCmdletsInstalled()
 {
-    QProcess process;
-    process.setProgram("powershell");
-    process.setArguments({"-Command", "Get-Module -ListAvailable -Name AudioDeviceCmdlets"});
-    process.start();
-    if (!process.waitForStarted()) {
-        qWarning() << "Failed to start process.";
-        return false;
-    }
-
-    if (!process.waitForFinished()) {
-        qWarning() << "Process did not finish correctly.";
-        return false;
-    }
-
-    QString output = process.readAllStandardOutput();
-    QString error = process.readAllStandardError();
-
-    if (!error.isEmpty()) {
-        qWarning() << "Error:" << error;
-    }
-
-    return output.contains("AudioDeviceCmdlets", Qt::CaseInsensitive);
+    ProcessRunner::Request request{"powershell",
+                                   {"-Command", "Get-Module -ListAvailable -Name AudioDeviceCmdlets"},
+                                   MODULE_QUERY_TIMEOUT_MS};
+    return ProcessRunner::instance()->start(request).then([](const ProcessRunner::Result &result) {
+        if (!result.started) {
+            qWarning() << "Failed to start process.";
+            return false;
+        }
+
+        if (result.timedOut || result.crashed) {
+            qWarning() << "Process did not finish correctly.";
+            return false;
+        }
+
+        QString output = result.standardOutput;
+        QString error = result.standardError;
+
+        if (!error.isEmpty()) {
+            qWarning() << "Error:" << error;
+        }
+
+        return output.contains("AudioDeviceCmdlets", Qt::CaseInsensitive);
+    });
 }
 
 bool Utils::isSunshineStreaming()
@@ -188,3 +257,17 @@ void Utils::sendMediaKey(WORD keyCode) {
     ip.ki.dwFlags = KEYEVENTF_KEYUP;
     SendInput(1, &ip, sizeof(INPUT));
 }
+
+QString getSteamLanguage()
+{
+    return RegistryWatcher::instance()->value(RegistryWatcher::SteamLanguage).toString().toLower();
+}
+
+QString getBigPictureWindowTitle()
+{
+    int entry = BigPictureTitles::findLanguage(getSteamLanguage());
+    if (entry < 0) {
+        entry = BigPictureTitles::findLanguage(u"english");
+    }
+    return QString::fromUtf16(BigPictureTitles::ENTRIES[entry].title);
+}
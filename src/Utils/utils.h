@@ -1,6 +1,7 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <QFuture>
 #include <QIcon>
 #include <QString>
 #include <windows.h>
@@ -11,14 +12,20 @@ public:
     ~Utils();
 
     void runEnhancedDisplayswitch(const QString &command);
+    QString getDisplayTopology();
     QIcon getIconForTheme();
     QString getActivePowerPlan();
+    // Reads the registry itself instead of going through the watcher, so it is safe
+    // off the GUI thread.
+    QString readActivePowerPlan();
     void setPowerPlan(QString planGuid);
+    bool powerPlanExists(const QString &planGuid);
     bool isDiscordInstalled();
     bool isDiscordRunning();
     void closeDiscord();
     void startDiscord();
-    bool isAudioDeviceCmdletsInstalled();
+    // Resolves on a worker thread; continue with then(context, ...) for the GUI.
+    QFuture<bool> isAudioDeviceCmdletsInstalled();
     bool isSunshineStreaming();
     void sendMediaKey(WORD keyCode);
 
@@ -28,4 +35,8 @@ private:
 
 };
 
+// Read from the registry watcher, so they need neither a Utils nor a window scan.
+QString getSteamLanguage();
+QString getBigPictureWindowTitle();
+
 #endif // UTILS_H
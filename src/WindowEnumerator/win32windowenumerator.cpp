@@ -0,0 +1,74 @@
+#include "win32windowenumerator.h"
+#include <windows.h>
+
+static_assert(sizeof(WCHAR) == sizeof(char16_t), "Window titles are read as UTF-16");
+
+Win32WindowEnumerator::Win32WindowEnumerator() {}
+
+Win32WindowEnumerator::~Win32WindowEnumerator() {}
+
+void Win32WindowEnumerator::enumerateWindows(QVector<quintptr> &windows) const
+{
+    windows.clear();
+
+    EnumWindows(
+        [](HWND hwnd, LPARAM lParam) -> BOOL {
+            QVector<quintptr> *handles = reinterpret_cast<QVector<quintptr> *>(lParam);
+
+            if (IsWindowVisible(hwnd) && !(GetWindowLong(hwnd, GWL_STYLE) & WS_MINIMIZE)) {
+                handles->append(reinterpret_cast<quintptr>(hwnd));
+            }
+            return TRUE;
+        },
+        reinterpret_cast<LPARAM>(&windows));
+}
+
+int Win32WindowEnumerator::readTitle(quintptr window, char16_t *buffer, int capacity) const
+{
+    return GetWindowText(reinterpret_cast<HWND>(window), reinterpret_cast<WCHAR *>(buffer), capacity);
+}
+
+void Win32WindowEnumerator::readAttributes(quintptr window, char16_t *classBuffer, WindowAttributes &attributes) const
+{
+    HWND hwnd = reinterpret_cast<HWND>(window);
+    int length = GetClassName(hwnd, reinterpret_cast<WCHAR *>(classBuffer), CLASS_CAPACITY);
+    attributes.className = QStringView(classBuffer, length);
+
+    DWORD processId = 0;
+    GetWindowThreadProcessId(hwnd, &processId);
+    attributes.processId = processId;
+    attributes.toolWindow = (GetWindowLong(hwnd, GWL_EXSTYLE) & WS_EX_TOOLWINDOW) != 0;
+}
+
+void Win32WindowEnumerator::visitWindows(WindowVisitor &visitor) const
+{
+    struct Context
+    {
+        const Win32WindowEnumerator *enumerator;
+        WindowVisitor *visitor;
+    } context = {this, &visitor};
+
+    EnumWindows(
+        [](HWND hwnd, LPARAM lParam) -> BOOL {
+            Context *context = reinterpret_cast<Context *>(lParam);
+            WindowVisitor *windowVisitor = context->visitor;
+
+            if (IsWindowVisible(hwnd) && !(GetWindowLong(hwnd, GWL_STYLE) & WS_MINIMIZE)) {
+                // Class, process and style are read locally; GetWindowText may have to
+                // wait on the window's thread, so it is only called for accepted windows.
+                char16_t className[CLASS_CAPACITY];
+                WindowAttributes attributes;
+                context->enumerator->readAttributes(reinterpret_cast<quintptr>(hwnd), className, attributes);
+                if (!windowVisitor->acceptWindow(reinterpret_cast<quintptr>(hwnd), attributes)) {
+                    return TRUE;
+                }
+
+                WCHAR windowTitle[TITLE_CAPACITY];
+                int length = GetWindowText(hwnd, windowTitle, TITLE_CAPACITY);
+                QStringView title(reinterpret_cast<const char16_t *>(windowTitle), length);
+                return windowVisitor->visitWindow(reinterpret_cast<quintptr>(hwnd), title) ? TRUE : FALSE;
+            }
+            return TRUE;
+        },
+        reinterpret_cast<LPARAM>(&context));
+}
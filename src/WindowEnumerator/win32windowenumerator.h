@@ -0,0 +1,18 @@
+#ifndef WIN32WINDOWENUMERATOR_H
+#define WIN32WINDOWENUMERATOR_H
+
+#include "windowenumerator.h"
+
+class Win32WindowEnumerator : public WindowEnumerator
+{
+public:
+    Win32WindowEnumerator();
+    ~Win32WindowEnumerator();
+
+    void enumerateWindows(QVector<quintptr> &windows) const override;
+    int readTitle(quintptr window, char16_t *buffer, int capacity) const override;
+    void readAttributes(quintptr window, char16_t *classBuffer, WindowAttributes &attributes) const override;
+    void visitWindows(WindowVisitor &visitor) const override;
+};
+
+#endif // WIN32WINDOWENUMERATOR_H
@@ -0,0 +1,67 @@
+#ifndef WINDOWENUMERATOR_H
+#define WINDOWENUMERATOR_H
+
+#include <QStringView>
+#include <QVector>
+
+struct SweepStats
+{
+    quint64 sweeps = 0;
+    quint64 windowsVisited = 0;
+    quint64 windowsFiltered = 0;
+    quint64 titleReads = 0;
+    quint64 titleCopies = 0;
+    quint64 titleBytesCopied = 0;
+    qint64 sweepNanoseconds = 0;
+};
+
+// Attributes that can be read without sending a message to the window's thread.
+struct WindowAttributes
+{
+    QStringView className;
+    quint32 processId = 0;
+    bool toolWindow = false;
+};
+
+class WindowVisitor
+{
+public:
+    virtual ~WindowVisitor() {}
+
+    // Called before the title is read. Return false to skip the window without reading it.
+    virtual bool acceptWindow(quintptr window, const WindowAttributes &attributes)
+    {
+        Q_UNUSED(window)
+        Q_UNUSED(attributes)
+        return true;
+    }
+
+    // Called for each visible, non-minimized top-level window. The title only lives
+    // for the duration of the call. Return false to stop the enumeration.
+    virtual bool visitWindow(quintptr window, QStringView title) = 0;
+};
+
+class WindowEnumerator
+{
+public:
+    virtual ~WindowEnumerator() {}
+
+    // Lists the visible, non-minimized top-level windows. The vector is cleared first
+    // so callers can reuse its capacity between sweeps.
+    virtual void enumerateWindows(QVector<quintptr> &windows) const = 0;
+
+    // Copies the title of a window into buffer and returns its length, 0 if it has none.
+    virtual int readTitle(quintptr window, char16_t *buffer, int capacity) const = 0;
+
+    // Fills in the attributes of a window. The class name is stored in classBuffer,
+    // which must hold CLASS_CAPACITY code units.
+    virtual void readAttributes(quintptr window, char16_t *classBuffer, WindowAttributes &attributes) const = 0;
+
+    // Streams the windows and their titles to the visitor without copying them.
+    virtual void visitWindows(WindowVisitor &visitor) const = 0;
+
+    static const int TITLE_CAPACITY = 256;
+    static const int CLASS_CAPACITY = 256;
+};
+
+#endif // WINDOWENUMERATOR_H
@@ -0,0 +1,24 @@
+#include "windoweventsource.h"
+
+const int WindowEventSource::COALESCE_DELAY_MS = 50;
+
+WindowEventSource::WindowEventSource(QObject *parent)
+    : QObject(parent)
+    , coalesceTimer(new QTimer(this))
+{
+    // A window usually fires several events in a row (create, show, name change),
+    // so they are folded into a single re-evaluation.
+    coalesceTimer->setSingleShot(true);
+    coalesceTimer->setInterval(COALESCE_DELAY_MS);
+    connect(coalesceTimer, &QTimer::timeout, this, &WindowEventSource::windowsChanged);
+}
+
+WindowEventSource::~WindowEventSource() {}
+
+void WindowEventSource::publish(quintptr window, EventType type)
+{
+    emit windowEvent(window, type);
+    if (!coalesceTimer->isActive()) {
+        coalesceTimer->start();
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef WINDOWEVENTSOURCE_H
+#define WINDOWEVENTSOURCE_H
+
+#include <QObject>
+#include <QTimer>
+
+class WindowEventSource : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum EventType {
+        Created,
+        Destroyed,
+        Shown,
+        Hidden,
+        NameChanged,
+        Minimized,
+        Restored
+    };
+    Q_ENUM(EventType)
+
+    explicit WindowEventSource(QObject *parent = nullptr);
+    ~WindowEventSource();
+
+    virtual bool start() = 0;
+    virtual void stop() = 0;
+    virtual bool isActive() const = 0;
+
+signals:
+    void windowEvent(quintptr window, WindowEventSource::EventType type);
+    void windowsChanged();
+
+protected:
+    void publish(quintptr window, EventType type);
+
+private:
+    QTimer *coalesceTimer;
+    static const int COALESCE_DELAY_MS;
+};
+
+#endif // WINDOWEVENTSOURCE_H
@@ -0,0 +1,122 @@
+#include "wineventwindowsource.h"
+#include <QDebug>
+
+WinEventWindowSource *WinEventWindowSource::activeSource = nullptr;
+
+WinEventWindowSource::WinEventWindowSource(QObject *parent)
+    : WindowEventSource(parent)
+{}
+
+WinEventWindowSource::~WinEventWindowSource()
+{
+    stop();
+}
+
+bool WinEventWindowSource::start()
+{
+    if (isActive()) {
+        return true;
+    }
+    if (activeSource) {
+        qWarning() << "Another window event source is already active";
+        return false;
+    }
+
+    const DWORD ranges[][2] = {{EVENT_OBJECT_CREATE, EVENT_OBJECT_HIDE},
+                               {EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE},
+                               {EVENT_SYSTEM_MINIMIZESTART, EVENT_SYSTEM_MINIMIZEEND}};
+
+    for (const auto &range : ranges) {
+        HWINEVENTHOOK hook = SetWinEventHook(range[0],
+                                             range[1],
+                                             nullptr,
+                                             winEventProc,
+                                             0,
+                                             0,
+                                             WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+        if (!hook) {
+            qWarning() << "Failed to install window event hook, falling back to polling";
+            stop();
+            return false;
+        }
+        hooks.append(hook);
+    }
+
+    activeSource = this;
+    return true;
+}
+
+void WinEventWindowSource::stop()
+{
+    for (HWINEVENTHOOK hook : std::as_const(hooks)) {
+        UnhookWinEvent(hook);
+    }
+    hooks.clear();
+
+    if (activeSource == this) {
+        activeSource = nullptr;
+    }
+}
+
+bool WinEventWindowSource::isActive() const
+{
+    return activeSource == this;
+}
+
+bool WinEventWindowSource::isTopLevelWindow(HWND hwnd, DWORD event)
+{
+    if (event == EVENT_OBJECT_DESTROY) {
+        // The window is already gone by the time out-of-context events are delivered.
+        return !IsWindow(hwnd) || GetAncestor(hwnd, GA_ROOT) == hwnd;
+    }
+    return GetAncestor(hwnd, GA_ROOT) == hwnd;
+}
+
+void CALLBACK WinEventWindowSource::winEventProc(HWINEVENTHOOK hook,
+                                                 DWORD event,
+                                                 HWND hwnd,
+                                                 LONG idObject,
+                                                 LONG idChild,
+                                                 DWORD eventThread,
+                                                 DWORD eventTime)
+{
+    Q_UNUSED(hook)
+    Q_UNUSED(eventThread)
+    Q_UNUSED(eventTime)
+
+    if (!activeSource || !hwnd || idObject != OBJID_WINDOW || idChild != CHILDID_SELF) {
+        return;
+    }
+    if (!isTopLevelWindow(hwnd, event)) {
+        return;
+    }
+
+    EventType type;
+    switch (event) {
+    case EVENT_OBJECT_CREATE:
+        type = Created;
+        break;
+    case EVENT_OBJECT_DESTROY:
+        type = Destroyed;
+        break;
+    case EVENT_OBJECT_SHOW:
+        type = Shown;
+        break;
+    case EVENT_OBJECT_HIDE:
+        type = Hidden;
+        break;
+    case EVENT_OBJECT_NAMECHANGE:
+        type = NameChanged;
+        break;
+    case EVENT_SYSTEM_MINIMIZESTART:
+        type = Minimized;
+        break;
+    case EVENT_SYSTEM_MINIMIZEEND:
+        type = Restored;
+        break;
+    default:
+        return;
+    }
+
+    activeSource->publish(reinterpret_cast<quintptr>(hwnd), type);
+}
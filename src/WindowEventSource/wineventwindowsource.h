@@ -0,0 +1,34 @@
+#ifndef WINEVENTWINDOWSOURCE_H
+#define WINEVENTWINDOWSOURCE_H
+
+#include <QList>
+#include <windows.h>
+#include "windoweventsource.h"
+
+class WinEventWindowSource : public WindowEventSource
+{
+    Q_OBJECT
+
+public:
+    explicit WinEventWindowSource(QObject *parent = nullptr);
+    ~WinEventWindowSource();
+
+    bool start() override;
+    void stop() override;
+    bool isActive() const override;
+
+private:
+    static void CALLBACK winEventProc(HWINEVENTHOOK hook,
+                                      DWORD event,
+                                      HWND hwnd,
+                                      LONG idObject,
+                                      LONG idChild,
+                                      DWORD eventThread,
+                                      DWORD eventTime);
+    static bool isTopLevelWindow(HWND hwnd, DWORD event);
+
+    QList<HWINEVENTHOOK> hooks;
+    static WinEventWindowSource *activeSource;
+};
+
+#endif // WINEVENTWINDOWSOURCE_H
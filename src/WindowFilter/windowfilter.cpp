@@ -0,0 +1,137 @@
+#include "windowfilter.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <limits>
+#include <memory>
+
+namespace {
+const qint64 NEVER = std::numeric_limits<qint64>::min() / 2;
+} // namespace
+
+const int WindowFilter::FULL_SWEEP_INTERVAL_MS = 3000;
+
+WindowFilter::WindowFilter(const ProcessTable *processes, Clock clock)
+    : processes(processes)
+    , skipToolWindows(false)
+    , lastSweepMissed(false)
+    , clock(clock)
+    , lastFullSweep(NEVER)
+    , currentRevision(0)
+{
+    if (!this->clock) {
+        auto timer = std::make_shared<QElapsedTimer>();
+        timer->start();
+        this->clock = [timer]() { return timer->elapsed(); };
+    }
+}
+
+WindowFilter::~WindowFilter() {}
+
+bool WindowFilter::containsName(const QStringList &names, QStringView name)
+{
+    for (const QString &candidate : names) {
+        if (name.compare(candidate, Qt::CaseInsensitive) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WindowFilter::addName(QStringList &names, QStringView name)
+{
+    if (!name.isEmpty() && names.size() < MAX_NAMES && !containsName(names, name)) {
+        names.append(name.toString());
+    }
+}
+
+void WindowFilter::setClassNames(const QStringList &classNames)
+{
+    configuredClassNames.clear();
+    for (const QString &className : classNames) {
+        addName(configuredClassNames, QStringView(className).trimmed());
+    }
+    clearLearned();
+}
+
+void WindowFilter::setProcessImages(const QStringList &imageNames)
+{
+    configuredImageNames.clear();
+    for (const QString &imageName : imageNames) {
+        addName(configuredImageNames, QStringView(imageName).trimmed());
+    }
+    clearLearned();
+}
+
+void WindowFilter::setSkipToolWindows(bool skip)
+{
+    if (skipToolWindows != skip) {
+        skipToolWindows = skip;
+        ++currentRevision;
+    }
+}
+
+void WindowFilter::learn(QStringView className, quint32 processId)
+{
+    int classCount = classNames.size();
+    int imageCount = imageNames.size();
+    addName(classNames, className);
+    if (processes) {
+        addName(imageNames, processes->imageName(processId));
+    }
+
+    if (classNames.size() != classCount || imageNames.size() != imageCount) {
+        qDebug() << "Window filter learned" << classNames << imageNames;
+        ++currentRevision;
+    }
+}
+
+void WindowFilter::clearLearned()
+{
+    classNames = configuredClassNames;
+    imageNames = configuredImageNames;
+    // The new lists are unproven, so the first miss is checked with a full sweep.
+    lastSweepMissed = false;
+    lastFullSweep = NEVER;
+    ++currentRevision;
+}
+
+bool WindowFilter::accepts(const WindowAttributes &attributes) const
+{
+    if (skipToolWindows && attributes.toolWindow) {
+        return false;
+    }
+    if (!classNames.isEmpty() && !containsName(classNames, attributes.className)) {
+        return false;
+    }
+    if (!imageNames.isEmpty() && processes) {
+        // A process newer than the last refresh is let through rather than missed.
+        QString imageName = processes->imageName(attributes.processId);
+        if (!imageName.isEmpty() && !containsName(imageNames, imageName)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool WindowFilter::usesProcessImages() const
+{
+    return !imageNames.isEmpty();
+}
+
+quint32 WindowFilter::revision() const
+{
+    return currentRevision;
+}
+
+bool WindowFilter::shouldFilter() const
+{
+    return !lastSweepMissed || clock() - lastFullSweep < FULL_SWEEP_INTERVAL_MS;
+}
+
+void WindowFilter::recordSweep(bool filtered, bool matched)
+{
+    if (!filtered) {
+        lastFullSweep = clock();
+    }
+    lastSweepMissed = filtered && !matched;
+}
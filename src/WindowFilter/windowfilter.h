@@ -0,0 +1,58 @@
+#ifndef WINDOWFILTER_H
+#define WINDOWFILTER_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include "processtable.h"
+#include "windowenumerator.h"
+
+// Decides from cheap window attributes whether a window's title is worth reading.
+// Class names and process images come from configuration or are learned from
+// windows that matched; an empty list accepts anything.
+class WindowFilter
+{
+public:
+    using Clock = std::function<qint64()>;
+
+    explicit WindowFilter(const ProcessTable *processes, Clock clock = Clock());
+    ~WindowFilter();
+
+    void setClassNames(const QStringList &classNames);
+    void setProcessImages(const QStringList &imageNames);
+    void setSkipToolWindows(bool skip);
+    void learn(QStringView className, quint32 processId);
+    void clearLearned();
+
+    bool accepts(const WindowAttributes &attributes) const;
+    bool usesProcessImages() const;
+    // Changes whenever the set of accepted windows may have changed.
+    quint32 revision() const;
+
+    // A learned or configured list can go stale, so while filtered sweeps find nothing
+    // one that reads every title runs at least every FULL_SWEEP_INTERVAL_MS.
+    bool shouldFilter() const;
+    void recordSweep(bool filtered, bool matched);
+
+    static const int FULL_SWEEP_INTERVAL_MS;
+
+private:
+    static bool containsName(const QStringList &names, QStringView name);
+    static void addName(QStringList &names, QStringView name);
+
+    const ProcessTable *processes;
+    QStringList configuredClassNames;
+    QStringList configuredImageNames;
+    QStringList classNames;
+    QStringList imageNames;
+    bool skipToolWindows;
+    bool lastSweepMissed;
+    Clock clock;
+    qint64 lastFullSweep;
+    quint32 currentRevision;
+
+    static const int MAX_NAMES = 8;
+};
+
+#endif // WINDOWFILTER_H
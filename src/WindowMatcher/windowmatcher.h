@@ -0,0 +1,18 @@
+#ifndef WINDOWMATCHER_H
+#define WINDOWMATCHER_H
+
+#include <QStringView>
+
+class WindowMatcher
+{
+public:
+    virtual ~WindowMatcher() {}
+
+    virtual bool isEmpty() const = 0;
+
+    // Returns the index of the target the window matches, or -1. Not const: matchers
+    // keep scratch state between calls, so each thread needs its own.
+    virtual int matchWindow(QStringView title, quint32 processId) = 0;
+};
+
+#endif // WINDOWMATCHER_H
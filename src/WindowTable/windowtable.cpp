@@ -0,0 +1,204 @@
+#include "windowtable.h"
+#include <QElapsedTimer>
+
+WindowTable::WindowTable(const WindowEnumerator *enumerator, SweepStats *stats)
+    : enumerator(enumerator)
+    , matcher(nullptr)
+    , filter(nullptr)
+    , filterRevision(0)
+    , counters(stats)
+    , generation(0)
+    , verdictsStale(false)
+    , candidatesStale(false)
+{}
+
+WindowTable::~WindowTable() {}
+
+void WindowTable::setMatcher(WindowMatcher *matcher)
+{
+    if (this->matcher != matcher) {
+        this->matcher = matcher;
+        verdictsStale = true;
+    }
+}
+
+void WindowTable::setFilter(const WindowFilter *filter)
+{
+    if (this->filter != filter || (filter && filter->revision() != filterRevision)) {
+        this->filter = filter;
+        filterRevision = filter ? filter->revision() : 0;
+        candidatesStale = true;
+    }
+}
+
+void WindowTable::invalidate(quintptr window)
+{
+    auto it = entries.find(window);
+    if (it != entries.end()) {
+        it->dirty = true;
+    }
+}
+
+void WindowTable::invalidateAll()
+{
+    for (auto &entry : entries) {
+        entry.dirty = true;
+    }
+}
+
+void WindowTable::invalidateVerdicts()
+{
+    verdictsStale = true;
+}
+
+void WindowTable::clear()
+{
+    entries.clear();
+}
+
+int WindowTable::evaluate(const Entry &entry) const
+{
+    return matcher ? matcher->matchWindow(entry.title, entry.processId) : -1;
+}
+
+bool WindowTable::isCandidate(const Entry &entry) const
+{
+    if (!filter) {
+        return true;
+    }
+    WindowAttributes attributes;
+    attributes.className = entry.className;
+    attributes.processId = entry.processId;
+    attributes.toolWindow = entry.toolWindow;
+    return filter->accepts(attributes);
+}
+
+void WindowTable::readAttributes(quintptr window, Entry &entry)
+{
+    char16_t className[WindowEnumerator::CLASS_CAPACITY];
+    WindowAttributes attributes;
+    enumerator->readAttributes(window, className, attributes);
+    entry.className = attributes.className.toString();
+    entry.processId = attributes.processId;
+    entry.toolWindow = attributes.toolWindow;
+    entry.candidate = isCandidate(entry);
+}
+
+void WindowTable::readEntry(quintptr window, Entry &entry, bool isNew)
+{
+    // A filtered-out window stays dirty, so its title is read once the filter accepts it.
+    if (!entry.candidate) {
+        ++counters->windowsFiltered;
+        return;
+    }
+    entry.dirty = false;
+
+    char16_t buffer[WindowEnumerator::TITLE_CAPACITY];
+    int length = enumerator->readTitle(window, buffer, WindowEnumerator::TITLE_CAPACITY);
+    QStringView title(buffer, length);
+    ++counters->titleReads;
+
+    bool wasTitled = entry.titled;
+    entry.titled = true;
+    if (wasTitled && title == entry.title) {
+        return;
+    }
+
+    entry.title = title.toString();
+    ++counters->titleCopies;
+    counters->titleBytesCopied += length * sizeof(char16_t);
+    entry.verdict = evaluate(entry);
+    if (!isNew && wasTitled) {
+        delta.retitled.append(window);
+    }
+}
+
+const WindowTable::Delta &WindowTable::sweep()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    delta.arrived.clear();
+    delta.departed.clear();
+    delta.retitled.clear();
+    ++generation;
+
+    // Titles are kept, so a new matcher only needs the verdicts recomputed.
+    if (verdictsStale) {
+        for (auto &entry : entries) {
+            entry.verdict = evaluate(entry);
+        }
+        verdictsStale = false;
+    }
+
+    // Windows the filter now accepts get their title read below, the others keep
+    // theirs but cannot match.
+    if (candidatesStale) {
+        for (auto &entry : entries) {
+            entry.candidate = isCandidate(entry);
+            if (entry.candidate && !entry.titled) {
+                entry.dirty = true;
+            }
+        }
+        candidatesStale = false;
+    }
+
+    enumerator->enumerateWindows(handles);
+    for (quintptr window : std::as_const(handles)) {
+        auto it = entries.find(window);
+        if (it == entries.end()) {
+            it = entries.insert(window, Entry());
+            readAttributes(window, it.value());
+            readEntry(window, it.value(), true);
+            delta.arrived.append(window);
+        } else if (it->dirty) {
+            readEntry(window, it.value(), false);
+        }
+        it->generation = generation;
+    }
+
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->generation != generation) {
+            delta.departed.append(it.key());
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    ++counters->sweeps;
+    counters->windowsVisited += handles.size();
+    counters->sweepNanoseconds += timer.nsecsElapsed();
+    return delta;
+}
+
+int WindowTable::matchingTarget(quintptr *window) const
+{
+    int best = -1;
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        if (it->candidate && it->verdict >= 0 && (best < 0 || it->verdict < best)) {
+            best = it->verdict;
+            if (window) {
+                *window = it.key();
+            }
+        }
+    }
+    return best;
+}
+
+bool WindowTable::windowAttributes(quintptr window, WindowAttributes &attributes) const
+{
+    auto it = entries.constFind(window);
+    if (it == entries.constEnd()) {
+        return false;
+    }
+    attributes.className = it->className;
+    attributes.processId = it->processId;
+    attributes.toolWindow = it->toolWindow;
+    return true;
+}
+
+int WindowTable::size() const
+{
+    return entries.size();
+}
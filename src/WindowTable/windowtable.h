@@ -0,0 +1,70 @@
+#ifndef WINDOWTABLE_H
+#define WINDOWTABLE_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include "windowenumerator.h"
+#include "windowfilter.h"
+#include "windowmatcher.h"
+
+class WindowTable
+{
+public:
+    struct Delta
+    {
+        QVector<quintptr> arrived;
+        QVector<quintptr> departed;
+        QVector<quintptr> retitled;
+    };
+
+    WindowTable(const WindowEnumerator *enumerator, SweepStats *stats);
+    ~WindowTable();
+
+    void setMatcher(WindowMatcher *matcher);
+    // Titles are only read for windows the filter accepts; nullptr reads them all.
+    void setFilter(const WindowFilter *filter);
+    void invalidate(quintptr window);
+    void invalidateAll();
+    void invalidateVerdicts();
+    void clear();
+
+    // Re-enumerates the windows, reading titles only for new or invalidated candidates.
+    const Delta &sweep();
+    int matchingTarget(quintptr *window = nullptr) const;
+    bool windowAttributes(quintptr window, WindowAttributes &attributes) const;
+    int size() const;
+
+private:
+    struct Entry
+    {
+        QString title;
+        QString className;
+        quint32 processId = 0;
+        int verdict = -1;
+        quint32 generation = 0;
+        bool dirty = false;
+        bool toolWindow = false;
+        bool candidate = true;
+        bool titled = false;
+    };
+
+    void readAttributes(quintptr window, Entry &entry);
+    void readEntry(quintptr window, Entry &entry, bool isNew);
+    bool isCandidate(const Entry &entry) const;
+    int evaluate(const Entry &entry) const;
+
+    const WindowEnumerator *enumerator;
+    WindowMatcher *matcher;
+    const WindowFilter *filter;
+    quint32 filterRevision;
+    QHash<quintptr, Entry> entries;
+    QVector<quintptr> handles;
+    Delta delta;
+    SweepStats *counters;
+    quint32 generation;
+    bool verdictsStale;
+    bool candidatesStale;
+};
+
+#endif // WINDOWTABLE_H
@@ -0,0 +1,20 @@
+include(../tests.pri)
+
+TARGET = tst_audiomanager
+
+INCLUDEPATH += \
+    $$SRC_DIR/AudioBackend \
+    $$SRC_DIR/AudioManager \
+    $$SRC_DIR/TraceRecorder \
+
+SOURCES += \
+    $$SRC_DIR/AudioManager/audiomanager.cpp \
+    $$SRC_DIR/TraceRecorder/tracerecorder.cpp \
+    tst_audiomanager.cpp
+
+HEADERS += \
+    $$SHARED_DIR/fakeaudiobackend.h \
+    $$SRC_DIR/AudioBackend/audiobackend.h \
+    $$SRC_DIR/AudioBackend/win32audiobackend.h \
+    $$SRC_DIR/AudioManager/audiomanager.h \
+    $$SRC_DIR/TraceRecorder/tracerecorder.h
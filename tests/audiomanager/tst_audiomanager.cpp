@@ -0,0 +1,322 @@
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtTest>
+#include <stdexcept>
+#include <thread>
+#include "audiomanager.h"
+#include "fakeaudiobackend.h"
+#include "win32audiobackend.h"
+
+namespace {
+FakeAudioBackend *createdNative = nullptr;
+FakeAudioBackend *createdFallback = nullptr;
+} // namespace
+
+// Stand in for the Windows backends, so AudioManager() can be tested too.
+AudioBackend *createNativeAudioBackend()
+{
+    createdNative = new FakeAudioBackend();
+    createdNative->available = false;
+    return createdNative;
+}
+
+AudioBackend *createFallbackAudioBackend()
+{
+    createdFallback = new FakeAudioBackend();
+    createdFallback->addEndpoint("{tv}", "LG TV");
+    return createdFallback;
+}
+
+class TestAudioManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void switchesToMatchingEndpoint();
+    void matchesLocalizedNames();
+    void triesPreferredEndpointFirst();
+    void refusedEndpointFallsThrough();
+    void waitsForEndpointNotification();
+    void pollsWithoutNotifications();
+    void givesUpAfterTimeout();
+    void cancelledBeforeStart();
+    void cancelWakesWait();
+    void unrelatedChangeKeepsWaiting();
+    void resolvesFromCache();
+    void resolveNeedsNotifications();
+    void listingFailureReachesCaller();
+    void fallbackWhenNativeUnavailable();
+    void nativeKeptWhenAvailable();
+    void defaultConstructorUsesFactories();
+
+private:
+    static std::function<AudioBackend *()> noFallback();
+};
+
+std::function<AudioBackend *()> TestAudioManager::noFallback()
+{
+    return std::function<AudioBackend *()>();
+}
+
+void TestAudioManager::switchesToMatchingEndpoint()
+{
+    FakeAudioBackend *backend = new FakeAudioBackend();
+    backend->addEndpoint("{speakers}", "Speakers (Realtek Audio)");
+    backend->addEndpoint("{tv}", "LG TV (NVIDIA High Definition Audio)");
+    AudioManager manager(backend, noFallback());
+
+    manager.setAudioDevice("lg tv");
+    QCOMPARE(backend->defaultId(), std::string("{tv}"));
+    QCOMPARE(manager.getDefaultDeviceName(), std::string("LG TV (NVIDIA High Definition Audio)"));
+}
+
+void TestAudioManager::matchesLocalizedNames()
+{
+    FakeAudioBackend *backend = new FakeAudioBackend();
+    backend->addEndpoint("{tv}", "\u00C9CRAN TV (HDMI)");
+    AudioManager manager(backend, noFallback());
+
+    manager.setAudioDevice("\u00E9cran tv");
+    QCOMPARE(backend->defaultId(), std::string("{tv}"));
+}
+
+void TestAudioManager::triesPreferredEndpointFirst()
+{
+    FakeAudioBackend *backend = new FakeAudioBackend();
+    backend->addEndpoint("{monitor}", "HDMI (Monitor)");
+    backend->addEndpoint("{tv}", "HDMI (TV)");
+    AudioManager manager(backend, noFallback());
+
+    manager.setAudioDevice("hdmi", nullptr, "{tv}");
+    QCOMPARE(backend->defaultId(), std::string("{tv}"));
+    QCOMPARE(backend->switches.load(), 1);
+
+    manager.setAudioDevice("hdmi");
+    QCOMPARE(backend->defaultId(), std::string("{monitor}"));
+}
+
+void TestAudioManager::refusedEndpointFallsThrough()
+{
+    FakeAudioBackend *backend = new FakeAudioBackend();
+    backend->addEndpoint("{disabled}", "HDMI (Disabled)");
+    backend->addEndpoint("{tv}", "HDMI (TV)");
+    backend->refuse("{disabled}");
+    AudioManager manager(backend, noFallback());
+
+    manager.setAudioDevice("hdmi");
+    QCOMPARE(backend->defaultId(), std::string("{tv}"));
+    QCOMPARE(backend->switches.load(), 2);
+}
+
+void TestAudioManager::waitsForEndpointNotification()
+{
+    // The TV's output only appears once the display has switched.
+    FakeAudioBackend *backend = new FakeAudioBackend();
+    backend->addEndpoint("{speakers}", "Speakers");
+    AudioManager manager(backend, noFallback());
+
+    std::thread display([backend]() {
+        QThread::msleep(200);
+        backend->addEndpoint("{tv}", "LG TV");
+    });
+    QElapsedTimer timer;
+    timer.start();
+    manager.setAudioDevice("lg tv");
+    display.join();
+
+    QCOMPARE(backend->defaultId(), std::string("{tv}"));
+    QVERIFY(timer.elapsed() < 2000);
+    // Woken by the notification rather than listing the endpoints over and over.
+    QVERIFY(backend->listings.load() <= 3);
+}
+
+void TestAudioManager::pollsWithoutNotifications()
+{
+    FakeAudioBackend *backend = new FakeAudioBackend();
+    backend->notifies = false;
+    AudioManager manager(backend, noFallback());
+
+    std::thread display([backend]() {
+        QThread::msleep(200);
+        backend->addEndpoint("{tv}", "LG TV");
+    });
+    manager.setAudioDevice("lg tv");
+    display.join();
+
+    QCOMPARE(backend->defaultId(), std::string("{tv}"));
+    QVERIFY(backend->listings.load() >= 2);
+}
+
+void TestAudioManager::givesUpAfterTimeout()
+{
+    FakeAudioBackend *backend = new FakeAudioBackend();
+    backend->addEndpoint("{speakers}", "Speakers");
+    AudioManager manager(backend, noFallback());
+
+    bool threw = false;
+    try {
+        manager.setAudioDevice("lg tv");
+    } catch (const std::runtime_error &e) {
+        threw = QString(e.what()).contains("did not become available");
+    }
+    QVERIFY(threw);
+    QVERIFY(backend->defaultId().empty());
+}
+
+void TestAudioManager::cancelledBeforeStart()
+{
+    FakeAudioBackend *backend = new FakeAudioBackend();
+    backend->addEndpoint("{tv}", "LG TV");
+    AudioManager manager(backend, noFallback());
+
+    std::atomic<bool> cancelled{true};
+    manager.setAudioDevice("lg tv", &cancelled);
+    QVERIFY(backend->defaultId().empty());
+    QCOMPARE(backend->switches.load(), 0);
+}
+
+void TestAudioManager::cancelWakesWait()
+{
+    FakeAudioBackend *backend = new FakeAudioBackend();
+    backend->addEndpoint("{speakers}", "Speakers");
+    AudioManager manager(backend, noFallback());
+
+    std::atomic<bool> cancelled{false};
+    std::thread canceller([&manager, &cancelled]() {
+        QThread::msleep(200);
+        cancelled.store(true);
+        manager.cancelWaits();
+    });
+    QElapsedTimer timer;
+    timer.start();
+    manager.setAudioDevice("lg tv", &cancelled);
+    canceller.join();
+
+    // Returns quietly, well before the switch timeout.
+    QVERIFY(timer.elapsed() < 2000);
+    QVERIFY(backend->defaultId().empty());
+    QCOMPARE(backend->listings.load(), 1);
+}
+
+void TestAudioManager::unrelatedChangeKeepsWaiting()
+{
+    FakeAudioBackend *backend = new FakeAudioBackend();
+    backend->addEndpoint("{speakers}", "Speakers");
+    AudioManager manager(backend, noFallback());
+
+    std::thread display([backend]() {
+        QThread::msleep(100);
+        backend->removeEndpoint("{speakers}");
+        QThread::msleep(100);
+        backend->addEndpoint("{tv}", "LG TV");
+    });
+    manager.setAudioDevice("lg tv");
+    display.join();
+
+    QCOMPARE(backend->defaultId(), std::string("{tv}"));
+    QCOMPARE(backend->switches.load(), 1);
+}
+
+void TestAudioManager::resolvesFromCache()
+{
+    FakeAudioBackend *backend = new FakeAudioBackend();
+    backend->addEndpoint("{tv}", "LG TV");
+    AudioManager manager(backend, noFallback());
+    unsigned long long generation = manager.endpointGeneration();
+
+    AudioEndpoint endpoint;
+    QVERIFY(manager.resolveDevice("lg", endpoint));
+    QCOMPARE(endpoint.id, std::string("{tv}"));
+    QVERIFY(manager.resolveDevice("lg", endpoint));
+    QVERIFY(!manager.resolveDevice("speakers", endpoint));
+    QCOMPARE(backend->listings.load(), 1);
+
+    backend->addEndpoint("{speakers}", "Speakers");
+    QVERIFY(manager.endpointGeneration() != generation);
+    QVERIFY(manager.resolveDevice("speakers", endpoint));
+    QCOMPARE(endpoint.id, std::string("{speakers}"));
+    QCOMPARE(backend->listings.load(), 2);
+}
+
+void TestAudioManager::resolveNeedsNotifications()
+{
+    // Without them the cache cannot be trusted, and listing might mean PowerShell.
+    FakeAudioBackend *backend = new FakeAudioBackend();
+    backend->notifies = false;
+    backend->addEndpoint("{tv}", "LG TV");
+    AudioManager manager(backend, noFallback());
+
+    AudioEndpoint endpoint;
+    QVERIFY(!manager.resolveDevice("lg", endpoint));
+    QCOMPARE(backend->listings.load(), 0);
+}
+
+void TestAudioManager::listingFailureReachesCaller()
+{
+    FakeAudioBackend *backend = new FakeAudioBackend();
+    backend->failListing = true;
+    AudioManager manager(backend, noFallback());
+
+    AudioEndpoint endpoint;
+    bool threw = false;
+    try {
+        manager.resolveDevice("lg", endpoint);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    QVERIFY(threw);
+}
+
+void TestAudioManager::fallbackWhenNativeUnavailable()
+{
+    FakeAudioBackend *native = new FakeAudioBackend();
+    native->available = false;
+    native->addEndpoint("{speakers}", "Speakers");
+    FakeAudioBackend *fallback = nullptr;
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("unavailable"));
+    AudioManager manager(native, [&fallback]() -> AudioBackend * {
+        fallback = new FakeAudioBackend();
+        fallback->addEndpoint("{tv}", "LG TV");
+        return fallback;
+    });
+    QVERIFY(fallback != nullptr);
+
+    manager.prepare();
+    QCOMPARE(fallback->prepared.load(), 1);
+    manager.setAudioDevice("lg tv");
+    QCOMPARE(fallback->defaultId(), std::string("{tv}"));
+    QCOMPARE(native->switches.load(), 0);
+
+    // Reading the default still goes to the native API.
+    QCOMPARE(manager.getDefaultDeviceName(), std::string());
+    QCOMPARE(fallback->listings.load(), 1);
+}
+
+void TestAudioManager::nativeKeptWhenAvailable()
+{
+    FakeAudioBackend *native = new FakeAudioBackend();
+    bool created = false;
+    AudioManager manager(native, [&created]() -> AudioBackend * {
+        created = true;
+        return new FakeAudioBackend();
+    });
+    manager.prepare();
+    QVERIFY(!created);
+    QCOMPARE(native->prepared.load(), 0);
+}
+
+void TestAudioManager::defaultConstructorUsesFactories()
+{
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("unavailable"));
+    AudioManager manager;
+    QVERIFY(createdNative != nullptr);
+    QVERIFY(createdFallback != nullptr);
+
+    manager.setAudioDevice("lg tv");
+    QCOMPARE(createdFallback->defaultId(), std::string("{tv}"));
+    QCOMPARE(createdNative->switches.load(), 0);
+}
+
+QTEST_APPLESS_MAIN(TestAudioManager)
+#include "tst_audiomanager.moc"
@@ -0,0 +1,17 @@
+include(../tests.pri)
+
+TARGET = tst_bigpicturetitles
+
+INCLUDEPATH += \
+    $$SRC_DIR/SteamWindowManager \
+    $$SRC_DIR/TitleMatcher \
+    $$SRC_DIR/WindowMatcher \
+
+SOURCES += \
+    $$SRC_DIR/TitleMatcher/titlematcher.cpp \
+    tst_bigpicturetitles.cpp
+
+HEADERS += \
+    $$SRC_DIR/SteamWindowManager/bigpicturetitles.h \
+    $$SRC_DIR/TitleMatcher/titlematcher.h \
+    $$SRC_DIR/WindowMatcher/windowmatcher.h
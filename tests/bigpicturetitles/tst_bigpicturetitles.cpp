@@ -0,0 +1,119 @@
+#include <QtTest>
+#include "bigpicturetitles.h"
+
+class TestBigPictureTitles : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void compiledFoldMatchesRuntimeFold();
+    void everyLanguageIsFound();
+    void unknownLanguageIsRejected();
+    void everyTitleMatches();
+    void titlesDoNotMatchOtherWindows();
+    void benchmarkMatch_data();
+    void benchmarkMatch();
+
+private:
+    static TitleMatcher allLanguages();
+};
+
+TitleMatcher TestBigPictureTitles::allLanguages()
+{
+    TitleMatcher matcher;
+    for (int entry = 0; entry < BigPictureTitles::COUNT; ++entry) {
+        BigPictureTitles::addTitle(matcher, entry);
+    }
+    return matcher;
+}
+
+void TestBigPictureTitles::compiledFoldMatchesRuntimeFold()
+{
+    for (int entry = 0; entry < BigPictureTitles::COUNT; ++entry) {
+        const BigPictureTitles::CompiledTitle &compiled = BigPictureTitles::TABLE.titles[entry];
+        QString title = QString::fromUtf16(BigPictureTitles::ENTRIES[entry].title);
+        QString folded(title.size(), Qt::Uninitialized);
+        TitleMatcher::fold(reinterpret_cast<const char16_t *>(title.utf16()),
+                           title.size(),
+                           reinterpret_cast<char16_t *>(folded.data()));
+        QCOMPARE(QStringView(compiled.folded, compiled.length), QStringView(folded));
+
+        // The runtime matcher must split the title into the same tokens.
+        TitleMatcher runtime;
+        runtime.addTarget(title);
+        QVERIFY2(runtime.matches(folded), qPrintable(title));
+        QCOMPARE(compiled.tokenCount, int(folded.split(u' ', Qt::SkipEmptyParts).size()));
+    }
+}
+
+void TestBigPictureTitles::everyLanguageIsFound()
+{
+    for (int entry = 0; entry < BigPictureTitles::COUNT; ++entry) {
+        QStringView language(BigPictureTitles::ENTRIES[entry].language);
+        QCOMPARE(BigPictureTitles::findLanguage(language), entry);
+    }
+}
+
+void TestBigPictureTitles::unknownLanguageIsRejected()
+{
+    QCOMPARE(BigPictureTitles::findLanguage(u"klingon"), -1);
+    QCOMPARE(BigPictureTitles::findLanguage(u""), -1);
+    QCOMPARE(BigPictureTitles::findLanguage(u"English"), -1);
+}
+
+void TestBigPictureTitles::everyTitleMatches()
+{
+    TitleMatcher matcher = allLanguages();
+    for (int entry = 0; entry < BigPictureTitles::COUNT; ++entry) {
+        QString title = QString::fromUtf16(BigPictureTitles::ENTRIES[entry].title);
+        int target = matcher.match(title);
+        QVERIFY2(target >= 0, qPrintable(title));
+        // Shared titles (spanish and latam, dutch and norwegian) resolve to one target.
+        QCOMPARE(matcher.target(target), title);
+        QCOMPARE(matcher.match(title.toUpper()), target);
+    }
+}
+
+void TestBigPictureTitles::titlesDoNotMatchOtherWindows()
+{
+    TitleMatcher matcher = allLanguages();
+    QCOMPARE(matcher.match(u"Steam"), -1);
+    QCOMPARE(matcher.match(u"Big Picture - Google Search"), -1);
+    QCOMPARE(matcher.match(u"Untitled - Notepad"), -1);
+}
+
+void TestBigPictureTitles::benchmarkMatch_data()
+{
+    QTest::addColumn<bool>("everyLanguage");
+    QTest::addColumn<QString>("title");
+
+    const QString hit = QString::fromUtf16(BigPictureTitles::ENTRIES[BigPictureTitles::findLanguage(u"english")].title);
+    const QString miss = "Steam - Friends List";
+    QTest::newRow("english only, hit") << false << hit;
+    QTest::newRow("english only, miss") << false << miss;
+    QTest::newRow("all languages, hit") << true << hit;
+    QTest::newRow("all languages, miss") << true << miss;
+}
+
+void TestBigPictureTitles::benchmarkMatch()
+{
+    QFETCH(bool, everyLanguage);
+    QFETCH(QString, title);
+
+    TitleMatcher matcher;
+    if (everyLanguage) {
+        matcher = allLanguages();
+    } else {
+        BigPictureTitles::addTitle(matcher, BigPictureTitles::findLanguage(u"english"));
+    }
+
+    int result = -1;
+    QBENCHMARK {
+        result = matcher.match(title);
+    }
+    Q_UNUSED(result)
+}
+
+QTEST_APPLESS_MAIN(TestBigPictureTitles)
+
+#include "tst_bigpicturetitles.moc"
@@ -0,0 +1,13 @@
+include(../tests.pri)
+
+TARGET = tst_detectionscheduler
+
+INCLUDEPATH += \
+    $$SRC_DIR/DetectionScheduler \
+
+SOURCES += \
+    $$SRC_DIR/DetectionScheduler/detectionscheduler.cpp \
+    tst_detectionscheduler.cpp
+
+HEADERS += \
+    $$SRC_DIR/DetectionScheduler/detectionscheduler.h
@@ -0,0 +1,162 @@
+#include <QtTest>
+#include "detectionscheduler.h"
+
+class TestDetectionScheduler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void hostStartRunsHot();
+    void idleWithoutHost();
+    void transitionRunsHot();
+    void lockedAndDisplayOffSuspend();
+    void batteryOnlyStretchesCalmIntervals();
+    void eventDrivenFallsBack();
+    void baseIntervalHasAFloor();
+    void summaryCountsAndResets();
+
+private:
+    DetectionScheduler::Inputs running() const;
+    DetectionScheduler::Inputs stopped() const;
+
+    qint64 now;
+};
+
+void TestDetectionScheduler::init()
+{
+    now = 1000;
+}
+
+DetectionScheduler::Inputs TestDetectionScheduler::running() const
+{
+    DetectionScheduler::Inputs inputs;
+    inputs.targetHostRunning = true;
+    return inputs;
+}
+
+DetectionScheduler::Inputs TestDetectionScheduler::stopped() const
+{
+    DetectionScheduler::Inputs inputs;
+    inputs.targetHostRunning = false;
+    return inputs;
+}
+
+void TestDetectionScheduler::hostStartRunsHot()
+{
+    DetectionScheduler scheduler([this]() { return now; });
+    scheduler.setBaseInterval(1000);
+
+    QCOMPARE(scheduler.nextInterval(stopped()), DetectionScheduler::IDLE_INTERVAL);
+    now += 500;
+    QCOMPARE(scheduler.nextInterval(running()), DetectionScheduler::HOT_INTERVAL);
+    QCOMPARE(scheduler.lastReason(), DetectionScheduler::HostStarted);
+
+    now += DetectionScheduler::HOT_WINDOW - 1;
+    QCOMPARE(scheduler.nextInterval(running()), DetectionScheduler::HOT_INTERVAL);
+    QCOMPARE(scheduler.lastReason(), DetectionScheduler::Transition);
+
+    now += 1;
+    QCOMPARE(scheduler.nextInterval(running()), 1000);
+    QCOMPARE(scheduler.lastReason(), DetectionScheduler::Active);
+}
+
+void TestDetectionScheduler::idleWithoutHost()
+{
+    DetectionScheduler scheduler([this]() { return now; });
+    scheduler.setBaseInterval(1000);
+    QCOMPARE(scheduler.nextInterval(stopped()), DetectionScheduler::IDLE_INTERVAL);
+    QCOMPARE(scheduler.lastReason(), DetectionScheduler::Idle);
+
+    // A slower configured rate is kept.
+    scheduler.setBaseInterval(8000);
+    QCOMPARE(scheduler.nextInterval(stopped()), 8000);
+}
+
+void TestDetectionScheduler::transitionRunsHot()
+{
+    DetectionScheduler scheduler([this]() { return now; });
+    scheduler.setBaseInterval(2000);
+    scheduler.nextInterval(running());
+    now += DetectionScheduler::HOT_WINDOW;
+    QCOMPARE(scheduler.nextInterval(running()), 2000);
+
+    scheduler.noteTransition();
+    now += DetectionScheduler::HOT_WINDOW / 2;
+    QCOMPARE(scheduler.nextInterval(running()), DetectionScheduler::HOT_INTERVAL);
+    QCOMPARE(scheduler.lastReason(), DetectionScheduler::Transition);
+    now += DetectionScheduler::HOT_WINDOW / 2;
+    QCOMPARE(scheduler.nextInterval(running()), 2000);
+}
+
+void TestDetectionScheduler::lockedAndDisplayOffSuspend()
+{
+    DetectionScheduler scheduler([this]() { return now; });
+    scheduler.setBaseInterval(1000);
+    scheduler.noteTransition();
+
+    DetectionScheduler::Inputs locked = running();
+    locked.sessionLocked = true;
+    QCOMPARE(scheduler.nextInterval(locked), DetectionScheduler::SUSPENDED_INTERVAL);
+    QCOMPARE(scheduler.lastReason(), DetectionScheduler::Locked);
+
+    DetectionScheduler::Inputs dark = running();
+    dark.displayOff = true;
+    QCOMPARE(scheduler.nextInterval(dark), DetectionScheduler::SUSPENDED_INTERVAL);
+    QCOMPARE(scheduler.lastReason(), DetectionScheduler::DisplayOff);
+}
+
+void TestDetectionScheduler::batteryOnlyStretchesCalmIntervals()
+{
+    DetectionScheduler scheduler([this]() { return now; });
+    scheduler.setBaseInterval(1000);
+
+    DetectionScheduler::Inputs battery = running();
+    battery.onBattery = true;
+    QCOMPARE(scheduler.nextInterval(battery), DetectionScheduler::HOT_INTERVAL);
+    now += DetectionScheduler::HOT_WINDOW;
+    QCOMPARE(scheduler.nextInterval(battery), 2000);
+
+    battery.targetHostRunning = false;
+    QCOMPARE(scheduler.nextInterval(battery), 2 * DetectionScheduler::IDLE_INTERVAL);
+}
+
+void TestDetectionScheduler::eventDrivenFallsBack()
+{
+    DetectionScheduler scheduler([this]() { return now; });
+    scheduler.setBaseInterval(1000);
+    scheduler.setEventDriven(true);
+
+    // Events report changes, so even the hot phase only polls at the base rate.
+    QCOMPARE(scheduler.nextInterval(running()), 1000);
+    now += DetectionScheduler::HOT_WINDOW;
+    QCOMPARE(scheduler.nextInterval(running()), DetectionScheduler::EVENT_FALLBACK_INTERVAL);
+    QCOMPARE(scheduler.nextInterval(stopped()), DetectionScheduler::SUSPENDED_INTERVAL);
+}
+
+void TestDetectionScheduler::baseIntervalHasAFloor()
+{
+    DetectionScheduler scheduler([this]() { return now; });
+    scheduler.setBaseInterval(10);
+    scheduler.nextInterval(running());
+    now += DetectionScheduler::HOT_WINDOW;
+    QCOMPARE(scheduler.nextInterval(running()), DetectionScheduler::HOT_INTERVAL);
+}
+
+void TestDetectionScheduler::summaryCountsAndResets()
+{
+    DetectionScheduler scheduler([this]() { return now; });
+    scheduler.nextInterval(stopped());
+    scheduler.nextInterval(stopped());
+    scheduler.nextInterval(running());
+
+    QCOMPARE(scheduler.decisionCount(DetectionScheduler::Idle), quint64(2));
+    QCOMPARE(scheduler.decisionCount(DetectionScheduler::HostStarted), quint64(1));
+    QCOMPARE(scheduler.takeSummary(), QString("host started: 1, idle: 2"));
+    QCOMPARE(scheduler.decisionCount(DetectionScheduler::Idle), quint64(0));
+    QCOMPARE(scheduler.takeSummary(), QString());
+}
+
+QTEST_APPLESS_MAIN(TestDetectionScheduler)
+
+#include "tst_detectionscheduler.moc"
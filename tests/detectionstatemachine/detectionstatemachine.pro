@@ -0,0 +1,13 @@
+include(../tests.pri)
+
+TARGET = tst_detectionstatemachine
+
+INCLUDEPATH += \
+    $$SRC_DIR/DetectionStateMachine \
+
+SOURCES += \
+    $$SRC_DIR/DetectionStateMachine/detectionstatemachine.cpp \
+    tst_detectionstatemachine.cpp
+
+HEADERS += \
+    $$SRC_DIR/DetectionStateMachine/detectionstatemachine.h
@@ -0,0 +1,124 @@
+#include <QtTest>
+#include "detectionstatemachine.h"
+
+using Transition = DetectionStateMachine::Transition;
+
+struct Step
+{
+    qint64 time;
+    bool sample;
+    Transition expected;
+};
+
+Q_DECLARE_METATYPE(QList<Step>)
+
+class TestDetectionStateMachine : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void script_data();
+    void script();
+    void pendingDeadlineTracksConfirmation();
+    void resetDropsPendingState();
+};
+
+void TestDetectionStateMachine::script_data()
+{
+    QTest::addColumn<int>("enterConfirmation");
+    QTest::addColumn<int>("exitConfirmation");
+    QTest::addColumn<int>("minimumDwell");
+    QTest::addColumn<QList<Step>>("steps");
+    QTest::addColumn<quint64>("flaps");
+
+    const Transition none = DetectionStateMachine::None;
+    const Transition enter = DetectionStateMachine::EnterGamemode;
+    const Transition exit = DetectionStateMachine::ExitGamemode;
+
+    QTest::newRow("immediate") << 0 << 0 << 0
+                               << QList<Step>{{0, true, enter}, {100, true, none}, {200, false, exit}}
+                               << quint64(0);
+
+    QTest::newRow("enter after confirmation")
+        << 500 << 0 << 0
+        << QList<Step>{{0, true, none}, {200, true, none}, {499, true, none}, {500, true, enter}}
+        << quint64(0);
+
+    // The window title disappears for a moment while Big Picture changes resolution.
+    QTest::newRow("exit flap suppressed")
+        << 0 << 1000 << 0
+        << QList<Step>{{0, true, enter}, {100, false, none}, {600, false, none}, {700, true, none},
+                       {800, false, none}, {1799, false, none}, {1800, false, exit}}
+        << quint64(1);
+
+    QTest::newRow("repeated flapping")
+        << 300 << 300 << 0
+        << QList<Step>{{0, true, none}, {100, false, none}, {200, true, none}, {300, false, none},
+                       {400, true, none}, {700, true, enter}, {800, false, none}, {900, true, none}}
+        << quint64(3);
+
+    QTest::newRow("dwell holds the new state")
+        << 0 << 0 << 2000
+        << QList<Step>{{0, true, enter}, {500, false, none}, {1999, false, none}, {2000, false, exit},
+                       {2100, true, none}, {4000, true, enter}}
+        << quint64(0);
+
+    QTest::newRow("first transition ignores dwell")
+        << 0 << 0 << 60000 << QList<Step>{{5, true, enter}} << quint64(0);
+}
+
+void TestDetectionStateMachine::script()
+{
+    QFETCH(int, enterConfirmation);
+    QFETCH(int, exitConfirmation);
+    QFETCH(int, minimumDwell);
+    QFETCH(QList<Step>, steps);
+    QFETCH(quint64, flaps);
+
+    DetectionStateMachine machine;
+    machine.setEnterConfirmation(enterConfirmation);
+    machine.setExitConfirmation(exitConfirmation);
+    machine.setMinimumDwell(minimumDwell);
+
+    for (const Step &step : steps) {
+        QCOMPARE(machine.feed(step.sample, step.time), step.expected);
+    }
+    QCOMPARE(machine.suppressedFlaps(), flaps);
+}
+
+void TestDetectionStateMachine::pendingDeadlineTracksConfirmation()
+{
+    DetectionStateMachine machine;
+    machine.setEnterConfirmation(300);
+    machine.setExitConfirmation(800);
+    QCOMPARE(machine.pendingDeadline(), qint64(-1));
+
+    machine.feed(true, 1000);
+    QVERIFY(machine.isPending());
+    QCOMPARE(machine.pendingDeadline(), qint64(1300));
+    QCOMPARE(machine.feed(true, 1300), DetectionStateMachine::EnterGamemode);
+    QVERIFY(machine.isActive());
+    QCOMPARE(machine.pendingDeadline(), qint64(-1));
+
+    machine.feed(false, 2000);
+    QCOMPARE(machine.pendingDeadline(), qint64(2800));
+}
+
+void TestDetectionStateMachine::resetDropsPendingState()
+{
+    DetectionStateMachine machine;
+    machine.setEnterConfirmation(500);
+    machine.setMinimumDwell(10000);
+    machine.feed(true, 0);
+
+    machine.reset(true);
+    QVERIFY(machine.isActive());
+    QVERIFY(!machine.isPending());
+    // reset() also forgets the last transition, so the dwell does not apply.
+    machine.setExitConfirmation(0);
+    QCOMPARE(machine.feed(false, 1), DetectionStateMachine::ExitGamemode);
+}
+
+QTEST_APPLESS_MAIN(TestDetectionStateMachine)
+
+#include "tst_detectionstatemachine.moc"
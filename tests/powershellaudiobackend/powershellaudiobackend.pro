@@ -0,0 +1,22 @@
+include(../tests.pri)
+
+TARGET = tst_powershellaudiobackend
+
+DEFINES += CORPUS_DIR=\\\"$$PWD/corpus\\\"
+
+INCLUDEPATH += \
+    $$SRC_DIR/AudioBackend \
+    $$SRC_DIR/PowerShellHost \
+    $$SRC_DIR/TraceRecorder \
+
+SOURCES += \
+    $$SRC_DIR/AudioBackend/powershellaudiobackend.cpp \
+    $$SRC_DIR/PowerShellHost/powershellhost.cpp \
+    $$SRC_DIR/TraceRecorder/tracerecorder.cpp \
+    tst_powershellaudiobackend.cpp
+
+HEADERS += \
+    $$SRC_DIR/AudioBackend/audiobackend.h \
+    $$SRC_DIR/AudioBackend/powershellaudiobackend.h \
+    $$SRC_DIR/PowerShellHost/powershellhost.h \
+    $$SRC_DIR/TraceRecorder/tracerecorder.h
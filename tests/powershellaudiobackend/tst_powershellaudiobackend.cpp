@@ -0,0 +1,138 @@
+#include <QFile>
+#include <QtTest>
+#include "powershellaudiobackend.h"
+
+// Get-AudioDevice outputs live in corpus/, one file per case.
+class TestPowerShellAudioBackend : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parsesCorpus_data();
+    void parsesCorpus();
+    void emptyOutput();
+    void truncatedOutputNeverFails_data();
+    void truncatedOutputNeverFails();
+    void benchmarkParse_data();
+    void benchmarkParse();
+
+private:
+    static QByteArray corpus(const QString &name);
+    static QStringList describe(const std::vector<Device> &devices);
+};
+
+QByteArray TestPowerShellAudioBackend::corpus(const QString &name)
+{
+    QFile file(QString(CORPUS_DIR) + '/' + name);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+QStringList TestPowerShellAudioBackend::describe(const std::vector<Device> &devices)
+{
+    QStringList lines;
+    for (const Device &device : devices) {
+        lines.append(QString::number(device.index) + '|' + QString::fromStdString(device.name) + '|'
+                     + QString::fromStdString(device.type));
+    }
+    return lines;
+}
+
+void TestPowerShellAudioBackend::parsesCorpus_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<QStringList>("expected");
+
+    QStringList list = {
+        "1|Speakers (Realtek(R) Audio)|Playback",
+        "2|LG TV SSCR2 (NVIDIA High Definition Audio)|Playback",
+        "3|Headphones (Type C Dock)|Playback",
+        "4|Microphone Array (Intel\u00AE Smart Sound Technology)|Recording",
+    };
+    QTest::newRow("list") << "list.txt" << list;
+    QTest::newRow("list, CRLF") << "list_crlf.txt" << list;
+    QTest::newRow("default, localized")
+        << "default_localized.txt"
+        << QStringList({"2|Lautsprecher (2- High Definition Audio-Ger\u00E4t)|Playback"});
+    // Bad, empty or overflowing indexes drop their record; the rest still count.
+    QTest::newRow("malformed") << "malformed.txt"
+                               << QStringList({
+                                      "5|First Of Two|Playback",
+                                      "6|Second Of Two|Playback",
+                                      "7|Padded:Name|",
+                                      "8|Unterminated|",
+                                  });
+}
+
+void TestPowerShellAudioBackend::parsesCorpus()
+{
+    QFETCH(QString, file);
+    QFETCH(QStringList, expected);
+
+    QByteArray output = corpus(file);
+    QVERIFY2(!output.isEmpty(), qPrintable("Missing corpus file " + file));
+    std::vector<Device> devices = PowerShellAudioBackend::parseDevices(
+        std::string_view(output.constData(), output.size()));
+    QCOMPARE(describe(devices), expected);
+}
+
+void TestPowerShellAudioBackend::emptyOutput()
+{
+    QVERIFY(PowerShellAudioBackend::parseDevices(std::string_view()).empty());
+    QVERIFY(PowerShellAudioBackend::parseDevices("\r\n\r\n").empty());
+}
+
+void TestPowerShellAudioBackend::truncatedOutputNeverFails_data()
+{
+    QTest::addColumn<QString>("file");
+
+    QTest::newRow("list, CRLF") << "list_crlf.txt";
+    QTest::newRow("malformed") << "malformed.txt";
+}
+
+void TestPowerShellAudioBackend::truncatedOutputNeverFails()
+{
+    // Output cut off at any byte, as from a host that died mid-answer.
+    QFETCH(QString, file);
+
+    QByteArray output = corpus(file);
+    QVERIFY(!output.isEmpty());
+    size_t complete = PowerShellAudioBackend::parseDevices(std::string_view(output.constData(), output.size())).size();
+    for (int length = 0; length <= output.size(); ++length) {
+        std::vector<Device> devices = PowerShellAudioBackend::parseDevices(std::string_view(output.constData(), length));
+        QVERIFY(devices.size() <= complete);
+        for (const Device &device : devices) {
+            QVERIFY(device.index >= 0);
+        }
+    }
+}
+
+void TestPowerShellAudioBackend::benchmarkParse_data()
+{
+    QTest::addColumn<int>("records");
+
+    QTest::newRow("4 devices") << 4;
+    QTest::newRow("64 devices") << 64;
+    QTest::newRow("1024 devices") << 1024;
+}
+
+void TestPowerShellAudioBackend::benchmarkParse()
+{
+    QFETCH(int, records);
+
+    // The four-device listing repeated until it holds the wanted number of records.
+    QByteArray listing = corpus("list_crlf.txt").trimmed() + "\r\n\r\n";
+    QByteArray output = listing.repeated((records + 3) / 4);
+    std::string_view view(output.constData(), output.size());
+
+    size_t count = 0;
+    QBENCHMARK {
+        count = PowerShellAudioBackend::parseDevices(view).size();
+    }
+    QVERIFY(count >= size_t(records));
+}
+
+QTEST_APPLESS_MAIN(TestPowerShellAudioBackend)
+#include "tst_powershellaudiobackend.moc"
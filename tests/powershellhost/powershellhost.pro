@@ -0,0 +1,18 @@
+include(../tests.pri)
+
+TARGET = tst_powershellhost
+
+DEFINES += STANDIN_HOST=\\\"$$OUT_PWD/../standinhost/standinhost\\\"
+
+INCLUDEPATH += \
+    $$SRC_DIR/PowerShellHost \
+    $$SRC_DIR/TraceRecorder \
+
+SOURCES += \
+    $$SRC_DIR/PowerShellHost/powershellhost.cpp \
+    $$SRC_DIR/TraceRecorder/tracerecorder.cpp \
+    tst_powershellhost.cpp
+
+HEADERS += \
+    $$SRC_DIR/PowerShellHost/powershellhost.h \
+    $$SRC_DIR/TraceRecorder/tracerecorder.h
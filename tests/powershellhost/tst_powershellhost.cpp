@@ -0,0 +1,212 @@
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QtTest>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "powershellhost.h"
+
+class TestPowerShellHost : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void executesCommands();
+    void reusesOneProcess();
+    void reportsErrors();
+    void skipsStrayOutput();
+    void restartsAfterExit();
+    void timeoutRestartsHost();
+    void hostThatNeverGetsReady();
+    void warningsBeforeReady();
+    void missingProgram();
+    void callsFromManyThreads();
+    void powerShellArgumentsEncodeBootstrap();
+    void benchmarkCommand_data();
+    void benchmarkCommand();
+};
+
+void TestPowerShellHost::initTestCase()
+{
+    QProcess probe;
+    probe.start(STANDIN_HOST, QStringList());
+    QVERIFY2(probe.waitForStarted(5000), "Stand-in host missing: " STANDIN_HOST);
+    probe.closeWriteChannel();
+    QVERIFY(probe.waitForFinished(5000));
+}
+
+void TestPowerShellHost::executesCommands()
+{
+    PowerShellHost host(STANDIN_HOST, QStringList());
+    PowerShellHost::Result result = host.execute("echo Speakers (Realtek Audio)");
+    QVERIFY(result.completed);
+    QCOMPARE(result.output, QByteArray("Speakers (Realtek Audio)"));
+    QVERIFY(result.error.isEmpty());
+    QVERIFY(result.failure.isEmpty());
+
+    // Non-ASCII and line breaks survive the base64 framing.
+    result = host.execute("echo Lautsprecher\nHDMI \u2013 TV");
+    QVERIFY(result.completed);
+    QCOMPARE(QString::fromUtf8(result.output), QString("Lautsprecher\nHDMI \u2013 TV"));
+}
+
+void TestPowerShellHost::reusesOneProcess()
+{
+    PowerShellHost host(STANDIN_HOST, QStringList());
+    host.prepare();
+    QByteArray first = host.execute("pid").output;
+    QByteArray second = host.execute("pid").output;
+    QVERIFY(!first.isEmpty());
+    QCOMPARE(second, first);
+}
+
+void TestPowerShellHost::reportsErrors()
+{
+    PowerShellHost host(STANDIN_HOST, QStringList());
+    PowerShellHost::Result result = host.execute("fail No device named TV");
+    QVERIFY(result.completed);
+    QVERIFY(result.output.isEmpty());
+    QCOMPARE(result.error, QByteArray("No device named TV"));
+}
+
+void TestPowerShellHost::skipsStrayOutput()
+{
+    PowerShellHost host(STANDIN_HOST, QStringList());
+    PowerShellHost::Result result = host.execute("noise answer");
+    QVERIFY(result.completed);
+    QCOMPARE(result.output, QByteArray("answer"));
+}
+
+void TestPowerShellHost::restartsAfterExit()
+{
+    PowerShellHost host(STANDIN_HOST, QStringList());
+    QByteArray before = host.execute("pid").output;
+
+    // The command is retried once on a fresh host, which exits again.
+    PowerShellHost::Result result = host.execute("exit");
+    QVERIFY(!result.completed);
+    QCOMPARE(result.failure, QString("Shell host exited while running the command"));
+
+    QByteArray after = host.execute("pid").output;
+    QVERIFY(!after.isEmpty());
+    QVERIFY(after != before);
+}
+
+void TestPowerShellHost::timeoutRestartsHost()
+{
+    PowerShellHost host(STANDIN_HOST, QStringList());
+    QByteArray before = host.execute("pid").output;
+
+    QElapsedTimer timer;
+    timer.start();
+    PowerShellHost::Result result = host.execute("sleep 5000 late", 200);
+    QVERIFY(!result.completed);
+    QVERIFY(result.failure.contains("did not answer within 200 ms"));
+    QVERIFY(timer.elapsed() < 4000);
+
+    // The stuck host is replaced, so its late answer cannot be taken for a new one.
+    result = host.execute("echo next");
+    QVERIFY(result.completed);
+    QCOMPARE(result.output, QByteArray("next"));
+    QVERIFY(host.execute("pid").output != before);
+}
+
+void TestPowerShellHost::hostThatNeverGetsReady()
+{
+    PowerShellHost host(STANDIN_HOST, QStringList() << "--exit-before-ready");
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Shell host did not become ready"));
+    PowerShellHost::Result result = host.execute("echo never");
+    QVERIFY(!result.completed);
+    QCOMPARE(result.failure, QString("Shell host could not be started"));
+}
+
+void TestPowerShellHost::warningsBeforeReady()
+{
+    PowerShellHost host(STANDIN_HOST, QStringList() << "--noise-before-ready");
+    PowerShellHost::Result result = host.execute("echo Speakers");
+    QVERIFY(result.completed);
+    QCOMPARE(result.output, QByteArray("Speakers"));
+
+    QByteArray first = host.execute("pid").output;
+    QVERIFY(!first.isEmpty());
+    QCOMPARE(host.execute("pid").output, first);
+}
+
+void TestPowerShellHost::missingProgram()
+{
+    PowerShellHost host(QString(STANDIN_HOST) + "-missing", QStringList());
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Failed to start shell host"));
+    PowerShellHost::Result result = host.execute("echo never");
+    QVERIFY(!result.completed);
+    QVERIFY(!result.failure.isEmpty());
+}
+
+void TestPowerShellHost::callsFromManyThreads()
+{
+    PowerShellHost host(STANDIN_HOST, QStringList());
+    static const int THREADS = 4;
+    static const int COMMANDS = 25;
+    std::atomic<int> mismatches{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&host, &mismatches, t]() {
+            for (int i = 0; i < COMMANDS; ++i) {
+                QByteArray expected = QByteArray::number(t) + '-' + QByteArray::number(i);
+                PowerShellHost::Result result = host.execute("echo " + QString::fromLatin1(expected));
+                if (!result.completed || result.output != expected) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    QCOMPARE(mismatches.load(), 0);
+}
+
+void TestPowerShellHost::powerShellArgumentsEncodeBootstrap()
+{
+    QStringList arguments = PowerShellHost::powerShellArguments({"AudioDeviceCmdlets"});
+    int index = arguments.indexOf("-EncodedCommand");
+    QVERIFY(index >= 0 && index + 1 < arguments.size());
+    QVERIFY(arguments.contains("-NoProfile"));
+
+    QByteArray utf16 = QByteArray::fromBase64(arguments[index + 1].toLatin1());
+    QString script = QString::fromUtf16(reinterpret_cast<const char16_t *>(utf16.constData()), utf16.size() / 2);
+    QVERIFY(script.contains("Import-Module AudioDeviceCmdlets"));
+    QVERIFY(script.contains("[Console]::Out.WriteLine('ready')"));
+}
+
+void TestPowerShellHost::benchmarkCommand_data()
+{
+    QTest::addColumn<bool>("persistent");
+
+    QTest::newRow("persistent host") << true;
+    QTest::newRow("process per command") << false;
+}
+
+void TestPowerShellHost::benchmarkCommand()
+{
+    // What the host saves: the per-command cost against starting a process each time,
+    // here without PowerShell's own start-up on top.
+    QFETCH(bool, persistent);
+
+    if (persistent) {
+        PowerShellHost host(STANDIN_HOST, QStringList());
+        host.execute("echo warm");
+        QBENCHMARK {
+            host.execute("echo Speakers");
+        }
+    } else {
+        QBENCHMARK {
+            PowerShellHost host(STANDIN_HOST, QStringList());
+            host.execute("echo Speakers");
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestPowerShellHost)
+#include "tst_powershellhost.moc"
@@ -0,0 +1,18 @@
+include(../tests.pri)
+
+TARGET = tst_processrunner
+
+DEFINES += STANDIN_HOST=\\\"$$OUT_PWD/../standinhost/standinhost\\\"
+
+INCLUDEPATH += \
+    $$SRC_DIR/ProcessRunner \
+    $$SRC_DIR/TraceRecorder \
+
+SOURCES += \
+    $$SRC_DIR/ProcessRunner/processrunner.cpp \
+    $$SRC_DIR/TraceRecorder/tracerecorder.cpp \
+    tst_processrunner.cpp
+
+HEADERS += \
+    $$SRC_DIR/ProcessRunner/processrunner.h \
+    $$SRC_DIR/TraceRecorder/tracerecorder.h
@@ -0,0 +1,218 @@
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtTest>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "processrunner.h"
+
+// The children are the stand-in host: with --run it exits on its own, without it
+// waits for input that never comes until it is killed.
+class TestProcessRunner : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void runsToCompletion();
+    void missingProgram();
+    void timeoutKillsChild();
+    void capsConcurrentChildren();
+    void timeoutCoversWaitForSlot();
+    void shutdownKillsRunningChild();
+    void shutdownReleasesQueuedCalls();
+    void summaryPerProgram();
+
+private:
+    static ProcessRunner::Request exiting(int sleepMs, int exitCode);
+    static ProcessRunner::Request blocking(int timeoutMs);
+    static QList<QFuture<ProcessRunner::Result>> fillSlots(ProcessRunner &runner, int timeoutMs);
+    static void expectKills(int count);
+};
+
+ProcessRunner::Request TestProcessRunner::exiting(int sleepMs, int exitCode)
+{
+    return {STANDIN_HOST, {"--run", QString::number(sleepMs), QString::number(exitCode)}, 5000};
+}
+
+ProcessRunner::Request TestProcessRunner::blocking(int timeoutMs)
+{
+    return {STANDIN_HOST, {}, timeoutMs};
+}
+
+QList<QFuture<ProcessRunner::Result>> TestProcessRunner::fillSlots(ProcessRunner &runner, int timeoutMs)
+{
+    QList<QFuture<ProcessRunner::Result>> running;
+    for (int i = 0; i < ProcessRunner::MAX_CONCURRENT; ++i) {
+        running.append(runner.start(blocking(timeoutMs)));
+    }
+    // Long enough for every child to be spawned.
+    QThread::msleep(500);
+    return running;
+}
+
+void TestProcessRunner::expectKills(int count)
+{
+    for (int i = 0; i < count; ++i) {
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("killed: Timed out"));
+    }
+}
+
+void TestProcessRunner::runsToCompletion()
+{
+    ProcessRunner runner;
+    ProcessRunner::Result result = runner.run(exiting(0, 0));
+    QVERIFY(result.started);
+    QVERIFY(result.succeeded());
+    QCOMPARE(result.standardOutput.trimmed(), QByteArray("done"));
+
+    result = runner.run(exiting(0, 3));
+    QVERIFY(result.started);
+    QVERIFY(!result.succeeded());
+    QVERIFY(!result.timedOut);
+    QCOMPARE(result.exitCode, 3);
+
+    result = runner.start(exiting(0, 0)).result();
+    QVERIFY(result.succeeded());
+}
+
+void TestProcessRunner::missingProgram()
+{
+    ProcessRunner runner;
+    ProcessRunner::Result result = runner.run({QString(STANDIN_HOST) + "-missing", {}, 2000});
+    QVERIFY(!result.started);
+    QVERIFY(!result.errorString.isEmpty());
+}
+
+void TestProcessRunner::timeoutKillsChild()
+{
+    ProcessRunner runner;
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("killed: Timed out after 300 ms"));
+    QElapsedTimer timer;
+    timer.start();
+    ProcessRunner::Result result = runner.run(blocking(300));
+    QVERIFY(result.started);
+    QVERIFY(result.timedOut);
+    QVERIFY(!result.crashed);
+    QVERIFY(!result.succeeded());
+    QVERIFY(timer.elapsed() < 3000);
+}
+
+void TestProcessRunner::capsConcurrentChildren()
+{
+    // Two more callers than slots: the last two can only start once others are done.
+    static const int CALLERS = ProcessRunner::MAX_CONCURRENT + 2;
+    ProcessRunner runner;
+    std::atomic<int> succeeded{0};
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<std::thread> callers;
+    for (int i = 0; i < CALLERS; ++i) {
+        callers.emplace_back([&runner, &succeeded]() {
+            succeeded += runner.run(exiting(400, 0)).succeeded() ? 1 : 0;
+        });
+    }
+    for (std::thread &caller : callers) {
+        caller.join();
+    }
+    QCOMPARE(succeeded.load(), CALLERS);
+    QVERIFY(timer.elapsed() >= 800);
+}
+
+void TestProcessRunner::timeoutCoversWaitForSlot()
+{
+    ProcessRunner runner;
+    expectKills(ProcessRunner::MAX_CONCURRENT);
+    QList<QFuture<ProcessRunner::Result>> running = fillSlots(runner, 3000);
+
+    ProcessRunner::Request request = exiting(0, 0);
+    request.timeoutMs = 200;
+    QElapsedTimer timer;
+    timer.start();
+    ProcessRunner::Result result = runner.run(request);
+    QVERIFY(!result.started);
+    QVERIFY(result.timedOut);
+    QVERIFY(result.errorString.contains("waiting for a free slot"));
+    QVERIFY(timer.elapsed() < 1000);
+
+    for (QFuture<ProcessRunner::Result> &future : running) {
+        QVERIFY(future.result().timedOut);
+    }
+}
+
+void TestProcessRunner::shutdownKillsRunningChild()
+{
+    ProcessRunner runner;
+    QFuture<ProcessRunner::Result> running = runner.start(blocking(10000));
+    QThread::msleep(500);
+
+    QElapsedTimer timer;
+    timer.start();
+    runner.shutdown();
+    QVERIFY(timer.elapsed() < 3000);
+
+    ProcessRunner::Result result = running.result();
+    QVERIFY(result.started);
+    QVERIFY(!result.timedOut);
+    QVERIFY(!result.crashed);
+    QCOMPARE(result.errorString, QString("Killed on shutdown"));
+
+    result = runner.run(exiting(0, 0));
+    QVERIFY(!result.started);
+    QCOMPARE(result.errorString, QString("Shutting down"));
+    QVERIFY(!runner.startDetached(exiting(0, 0)));
+}
+
+void TestProcessRunner::shutdownReleasesQueuedCalls()
+{
+    ProcessRunner runner;
+    QList<QFuture<ProcessRunner::Result>> running = fillSlots(runner, 10000);
+
+    ProcessRunner::Result queued;
+    std::thread caller([&runner, &queued]() {
+        ProcessRunner::Request request = exiting(0, 0);
+        request.timeoutMs = 10000;
+        queued = runner.run(request);
+    });
+    QThread::msleep(300);
+
+    QElapsedTimer timer;
+    timer.start();
+    runner.shutdown();
+    caller.join();
+    QVERIFY(timer.elapsed() < 3000);
+    QVERIFY(!queued.started);
+    QCOMPARE(queued.errorString, QString("Shutting down"));
+    for (QFuture<ProcessRunner::Result> &future : running) {
+        QCOMPARE(future.result().errorString, QString("Killed on shutdown"));
+    }
+}
+
+void TestProcessRunner::summaryPerProgram()
+{
+    ProcessRunner runner;
+    QCOMPARE(runner.takeSummary(), QString("none"));
+
+    runner.run(exiting(0, 0));
+    runner.run(exiting(0, 3));
+    expectKills(1);
+    runner.run(blocking(200));
+    runner.run({QString(STANDIN_HOST) + "-missing", {}, 2000});
+
+    QString summary = runner.takeSummary();
+    QStringList parts = summary.split("; ");
+    QCOMPARE(parts.size(), 2);
+    QString standin = parts.filter(QRegularExpression("^standinhost ")).value(0);
+    QVERIFY2(standin.startsWith("standinhost 3x spawn "), qPrintable(summary));
+    QVERIFY2(standin.endsWith(", 1 timed out"), qPrintable(summary));
+    QVERIFY2(!standin.contains("failed to start"), qPrintable(summary));
+    QString missing = parts.filter(QRegularExpression("^standinhost-missing ")).value(0);
+    QVERIFY2(missing.startsWith("standinhost-missing 1x "), qPrintable(summary));
+    QVERIFY2(missing.contains("exit -1, 1 failed to start"), qPrintable(summary));
+
+    // Taking the summary starts the next one afresh.
+    QCOMPARE(runner.takeSummary(), QString("none"));
+}
+
+QTEST_GUILESS_MAIN(TestProcessRunner)
+#include "tst_processrunner.moc"
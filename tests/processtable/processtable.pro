@@ -0,0 +1,17 @@
+include(../tests.pri)
+
+TARGET = tst_processtable
+
+INCLUDEPATH += \
+    $$SRC_DIR/ProcessTable \
+
+SOURCES += \
+    $$SHARED_DIR/procfsprocesssource.cpp \
+    $$SRC_DIR/ProcessTable/processtable.cpp \
+    tst_processtable.cpp
+
+HEADERS += \
+    $$SHARED_DIR/fakeprocesssource.h \
+    $$SHARED_DIR/procfsprocesssource.h \
+    $$SRC_DIR/ProcessTable/processsource.h \
+    $$SRC_DIR/ProcessTable/processtable.h
@@ -0,0 +1,159 @@
+#include <QProcess>
+#include <QtTest>
+#include "fakeprocesssource.h"
+#include "processtable.h"
+#include "procfsprocesssource.h"
+
+class TestProcessTable : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void findsRunningImages();
+    void exitedProcessesAreDropped();
+    void reusedProcessIdIsReplaced();
+    void commandLinesOnlyForWatchedImages();
+    void watchingAKnownImageQueriesIt();
+    void refreshIsRateLimited();
+    void failedListingKeepsTheTable();
+    void procfsSeesChildProcess();
+};
+
+void TestProcessTable::findsRunningImages()
+{
+    FakeProcessSource source;
+    source.addProcess(10, "steam.exe");
+    source.addProcess(11, "explorer.exe");
+    ProcessTable table(&source);
+
+    QVERIFY(table.refresh());
+    QCOMPARE(table.size(), 2);
+    QVERIFY(table.isRunning("Steam.exe"));
+    QVERIFY(!table.isRunning("discord.exe"));
+    QCOMPARE(table.imageName(10), QString("steam.exe"));
+    QCOMPARE(table.imageName(12), QString());
+}
+
+void TestProcessTable::exitedProcessesAreDropped()
+{
+    FakeProcessSource source;
+    source.addProcess(10, "steam.exe");
+    ProcessTable table(&source);
+    table.refresh();
+
+    source.removeProcess(10);
+    table.refresh();
+    QVERIFY(!table.isRunning("steam.exe"));
+    QCOMPARE(table.size(), 0);
+}
+
+void TestProcessTable::reusedProcessIdIsReplaced()
+{
+    FakeProcessSource source;
+    source.addProcess(10, "steamwebhelper.exe", "steamwebhelper.exe -gamepadui");
+    ProcessTable table(&source);
+    table.watchImage("steamwebhelper.exe");
+    table.refresh();
+    QVERIFY(table.isRunning("steamwebhelper.exe", "-gamepadui"));
+
+    source.addProcess(10, "notepad.exe");
+    table.refresh();
+    QCOMPARE(table.imageName(10), QString("notepad.exe"));
+    QVERIFY(!table.isRunning("steamwebhelper.exe"));
+}
+
+void TestProcessTable::commandLinesOnlyForWatchedImages()
+{
+    FakeProcessSource source;
+    source.addProcess(10, "steamwebhelper.exe", "steamwebhelper.exe -gamepadui");
+    source.addProcess(11, "explorer.exe", "explorer.exe");
+    ProcessTable table(&source);
+    table.watchImage("SteamWebHelper.exe");
+
+    table.refresh();
+    table.refresh();
+    QCOMPARE(source.commandLineQueries, 1);
+    QVERIFY(table.isRunning("steamwebhelper.exe", "-GamepadUI"));
+    QVERIFY(!table.isRunning("steamwebhelper.exe", "-silent"));
+    QVERIFY(!table.isRunning("explorer.exe", "explorer"));
+}
+
+void TestProcessTable::watchingAKnownImageQueriesIt()
+{
+    FakeProcessSource source;
+    source.addProcess(10, "steamwebhelper.exe", "steamwebhelper.exe -gamepadui");
+    ProcessTable table(&source);
+    table.refresh();
+    QCOMPARE(source.commandLineQueries, 0);
+
+    table.watchImage("steamwebhelper.exe");
+    QCOMPARE(source.commandLineQueries, 1);
+    QVERIFY(table.isRunning("steamwebhelper.exe", "-gamepadui"));
+}
+
+void TestProcessTable::refreshIsRateLimited()
+{
+    FakeProcessSource source;
+    source.addProcess(10, "steam.exe");
+    ProcessTable table(&source);
+
+    QVERIFY(table.refresh(60000));
+    QVERIFY(table.refresh(60000));
+    QCOMPARE(source.listings, 1);
+
+    // A stale table is still answered from until the interval is up.
+    source.removeProcess(10);
+    table.refresh(60000);
+    QVERIFY(table.isRunning("steam.exe"));
+
+    QVERIFY(table.refresh());
+    QCOMPARE(source.listings, 2);
+    QVERIFY(!table.isRunning("steam.exe"));
+}
+
+void TestProcessTable::failedListingKeepsTheTable()
+{
+    FakeProcessSource source;
+    source.addProcess(10, "steam.exe");
+    ProcessTable table(&source);
+    table.refresh();
+
+    source.available = false;
+    source.removeProcess(10);
+    QVERIFY(!table.refresh());
+    QVERIFY(table.isRunning("steam.exe"));
+
+    source.available = true;
+    QVERIFY(table.refresh());
+    QVERIFY(!table.isRunning("steam.exe"));
+}
+
+void TestProcessTable::procfsSeesChildProcess()
+{
+    if (!QFileInfo::exists("/proc/self")) {
+        QSKIP("No /proc on this system");
+    }
+
+    QProcess child;
+    child.start("sleep", {"30"});
+    QVERIFY(child.waitForStarted());
+    quint32 processId = quint32(child.processId());
+
+    ProcfsProcessSource source;
+    ProcessTable table(&source);
+    QVERIFY(table.refresh());
+    // sleep may be a link to a multi-call binary, so take whatever image /proc reports.
+    QString image = table.imageName(processId);
+    QVERIFY(!image.isEmpty());
+    table.watchImage(image);
+    QVERIFY(table.isRunning(image, "sleep 30"));
+
+    child.kill();
+    child.waitForFinished();
+    QVERIFY(table.refresh());
+    QVERIFY(table.imageName(processId).isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestProcessTable)
+
+#include "tst_processtable.moc"
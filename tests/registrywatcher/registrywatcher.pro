@@ -0,0 +1,16 @@
+include(../tests.pri)
+
+TARGET = tst_registrywatcher
+
+INCLUDEPATH += \
+    $$SRC_DIR/RegistryWatcher \
+
+SOURCES += \
+    $$SRC_DIR/RegistryWatcher/keystore.cpp \
+    $$SRC_DIR/RegistryWatcher/registrywatcher.cpp \
+    tst_registrywatcher.cpp
+
+HEADERS += \
+    $$SHARED_DIR/fakekeystore.h \
+    $$SRC_DIR/RegistryWatcher/keystore.h \
+    $$SRC_DIR/RegistryWatcher/registrywatcher.h
@@ -0,0 +1,117 @@
+#include <QSignalSpy>
+#include <QtTest>
+#include "fakekeystore.h"
+#include "registrywatcher.h"
+
+class TestRegistryWatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void watchesTheRegistryLocation();
+    void watchedValueIsReadOnce();
+    void changeUpdatesTheCache();
+    void unchangedValueIsSilent();
+    void unwatchableValueIsReadEveryTime();
+    void lostWatchFallsBackToReading();
+    void refreshPicksUpOwnWrites();
+};
+
+void TestRegistryWatcher::watchesTheRegistryLocation()
+{
+    FakeKeyStore *store = new FakeKeyStore();
+    RegistryWatcher watcher(store);
+    watcher.value(RegistryWatcher::SteamLanguage);
+
+    const KeyStore::Location location = store->locations.value(RegistryWatcher::SteamLanguage);
+    QCOMPARE(location.root, KeyStore::CurrentUser);
+    QCOMPARE(location.keyPath, QString("Software\\Valve\\Steam\\steamglobal"));
+    QCOMPARE(location.valueName, QString("Language"));
+}
+
+void TestRegistryWatcher::watchedValueIsReadOnce()
+{
+    FakeKeyStore *store = new FakeKeyStore();
+    store->set(RegistryWatcher::SteamLanguage, "french");
+    RegistryWatcher watcher(store);
+
+    for (int i = 0; i < 10; ++i) {
+        QCOMPARE(watcher.value(RegistryWatcher::SteamLanguage).toString(), QString("french"));
+    }
+    QCOMPARE(store->reads, 1);
+}
+
+void TestRegistryWatcher::changeUpdatesTheCache()
+{
+    FakeKeyStore *store = new FakeKeyStore();
+    store->set(RegistryWatcher::AppsUseLightTheme, 1u);
+    RegistryWatcher watcher(store);
+    QSignalSpy changed(&watcher, &RegistryWatcher::valueChanged);
+    watcher.value(RegistryWatcher::AppsUseLightTheme);
+
+    store->set(RegistryWatcher::AppsUseLightTheme, 0u);
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(changed.at(0).at(0).value<RegistryWatcher::Value>(), RegistryWatcher::AppsUseLightTheme);
+    QCOMPARE(watcher.value(RegistryWatcher::AppsUseLightTheme).toUInt(), 0u);
+    QCOMPARE(store->reads, 2);
+}
+
+void TestRegistryWatcher::unchangedValueIsSilent()
+{
+    FakeKeyStore *store = new FakeKeyStore();
+    store->set(RegistryWatcher::ActivePowerScheme, "balanced");
+    RegistryWatcher watcher(store);
+    QSignalSpy changed(&watcher, &RegistryWatcher::valueChanged);
+    watcher.value(RegistryWatcher::ActivePowerScheme);
+
+    store->set(RegistryWatcher::ActivePowerScheme, "balanced");
+    QCOMPARE(changed.count(), 0);
+}
+
+void TestRegistryWatcher::unwatchableValueIsReadEveryTime()
+{
+    FakeKeyStore *store = new FakeKeyStore();
+    store->watchable = false;
+    store->set(RegistryWatcher::SteamLanguage, "german");
+    RegistryWatcher watcher(store);
+
+    watcher.value(RegistryWatcher::SteamLanguage);
+    watcher.value(RegistryWatcher::SteamLanguage);
+    store->set(RegistryWatcher::SteamLanguage, "danish");
+    QCOMPARE(watcher.value(RegistryWatcher::SteamLanguage).toString(), QString("danish"));
+    QCOMPARE(store->reads, 3);
+}
+
+void TestRegistryWatcher::lostWatchFallsBackToReading()
+{
+    FakeKeyStore *store = new FakeKeyStore();
+    store->set(RegistryWatcher::SteamLanguage, "english");
+    RegistryWatcher watcher(store);
+    watcher.value(RegistryWatcher::SteamLanguage);
+
+    store->watchable = false;
+    store->set(RegistryWatcher::SteamLanguage, "thai");
+    int readsAfterChange = store->reads;
+
+    QCOMPARE(watcher.value(RegistryWatcher::SteamLanguage).toString(), QString("thai"));
+    QCOMPARE(watcher.value(RegistryWatcher::SteamLanguage).toString(), QString("thai"));
+    QCOMPARE(store->reads, readsAfterChange + 2);
+}
+
+void TestRegistryWatcher::refreshPicksUpOwnWrites()
+{
+    FakeKeyStore *store = new FakeKeyStore();
+    RegistryWatcher watcher(store);
+    QSignalSpy changed(&watcher, &RegistryWatcher::valueChanged);
+    watcher.value(RegistryWatcher::NightLightState);
+
+    // A value written by the application itself, before the notification arrives.
+    store->write(RegistryWatcher::NightLightState, QByteArray("\x02\x01", 2));
+    watcher.refresh(RegistryWatcher::NightLightState);
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(watcher.value(RegistryWatcher::NightLightState).toByteArray(), QByteArray("\x02\x01", 2));
+}
+
+QTEST_APPLESS_MAIN(TestRegistryWatcher)
+
+#include "tst_registrywatcher.moc"
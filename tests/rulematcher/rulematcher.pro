@@ -0,0 +1,23 @@
+include(../tests.pri)
+
+TARGET = tst_rulematcher
+
+INCLUDEPATH += \
+    $$SRC_DIR/ProcessTable \
+    $$SRC_DIR/RuleMatcher \
+    $$SRC_DIR/TitleMatcher \
+    $$SRC_DIR/WindowMatcher \
+
+SOURCES += \
+    $$SRC_DIR/ProcessTable/processtable.cpp \
+    $$SRC_DIR/RuleMatcher/rulematcher.cpp \
+    $$SRC_DIR/TitleMatcher/titlematcher.cpp \
+    tst_rulematcher.cpp
+
+HEADERS += \
+    $$SHARED_DIR/fakeprocesssource.h \
+    $$SRC_DIR/ProcessTable/processsource.h \
+    $$SRC_DIR/ProcessTable/processtable.h \
+    $$SRC_DIR/RuleMatcher/rulematcher.h \
+    $$SRC_DIR/TitleMatcher/titlematcher.h \
+    $$SRC_DIR/WindowMatcher/windowmatcher.h
@@ -0,0 +1,276 @@
+#include <QtTest>
+#include "fakeprocesssource.h"
+#include "processtable.h"
+#include "rulematcher.h"
+
+class TestRuleMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseRule_data();
+    void parseRule();
+    void matches_data();
+    void matches();
+    void firstRuleWins();
+    void earlierRegexBeatsLeftmostMatch();
+    void invalidRegexIsIgnored();
+    void regexesThatCannotCombine();
+    void numberedReferencesRunAlone_data();
+    void numberedReferencesRunAlone();
+    void processFilter();
+    void agreesWithRulesOnTheirOwn();
+    void describeRule();
+    void benchmarkMatch_data();
+    void benchmarkMatch();
+
+private:
+    static int matchOne(const QString &pattern, const QString &title);
+    static QList<RuleMatcher::Rule> manyRules(int count);
+};
+
+int TestRuleMatcher::matchOne(const QString &pattern, const QString &title)
+{
+    RuleMatcher matcher(nullptr);
+    matcher.setRules({RuleMatcher::parseRule(pattern)});
+    return matcher.matchWindow(title, 0);
+}
+
+QList<RuleMatcher::Rule> TestRuleMatcher::manyRules(int count)
+{
+    // A mix of kinds, none of which fire on the benchmark titles, then the real rule.
+    QList<RuleMatcher::Rule> rules;
+    for (int i = 0; i + 1 < count; ++i) {
+        switch (i % 3) {
+        case 0:
+            rules.append(RuleMatcher::parseRule(QString("Window%1 Title%1").arg(i)));
+            break;
+        case 1:
+            rules.append(RuleMatcher::parseRule(QString("*Game%1 - *").arg(i)));
+            break;
+        default:
+            rules.append(RuleMatcher::parseRule(QString("re:^Launcher%1 v\\d+").arg(i)));
+            break;
+        }
+    }
+    rules.append(RuleMatcher::parseRule("Steam Big Picture"));
+    return rules;
+}
+
+void TestRuleMatcher::parseRule_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<int>("kind");
+    QTest::addColumn<QString>("parsed");
+
+    QTest::newRow("words") << " Big Picture " << int(RuleMatcher::Words) << "Big Picture";
+    QTest::newRow("star") << "Steam*" << int(RuleMatcher::Glob) << "Steam*";
+    QTest::newRow("question mark") << "Game ?" << int(RuleMatcher::Glob) << "Game ?";
+    QTest::newRow("regex") << "re:^Steam.*$" << int(RuleMatcher::Regex) << "^Steam.*$";
+    QTest::newRow("regex with star") << "re:a*" << int(RuleMatcher::Regex) << "a*";
+}
+
+void TestRuleMatcher::parseRule()
+{
+    QFETCH(QString, pattern);
+    QFETCH(int, kind);
+    QFETCH(QString, parsed);
+
+    RuleMatcher::Rule rule = RuleMatcher::parseRule(pattern, " steam.exe ");
+    QCOMPARE(int(rule.kind), kind);
+    QCOMPARE(rule.pattern, parsed);
+    QCOMPARE(rule.processImage, QString("steam.exe"));
+}
+
+void TestRuleMatcher::matches_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QString>("title");
+    QTest::addColumn<bool>("matches");
+
+    QTest::newRow("words") << "Picture Big" << "Steam Big Picture Mode" << true;
+    QTest::newRow("words case") << "big picture" << "STEAM BIG PICTURE" << true;
+    QTest::newRow("words missing") << "Big Picture" << "Steam Big Mode" << false;
+    QTest::newRow("glob whole title") << "Steam*Mode" << "Steam Big Picture Mode" << true;
+    QTest::newRow("glob is anchored") << "Steam*Mode" << "My Steam Big Picture Mode" << false;
+    QTest::newRow("glob case") << "steam*MODE" << "Steam Big Picture Mode" << true;
+    QTest::newRow("glob question mark") << "Game ?" << "Game 7" << true;
+    QTest::newRow("glob question mark needs one") << "Game ?" << "Game " << false;
+    QTest::newRow("glob star only") << "*" << "Anything" << true;
+    QTest::newRow("glob no literal") << "?*?" << "ab" << true;
+    QTest::newRow("glob repeated literal") << "*ab*ab" << "xabyab" << true;
+    QTest::newRow("glob backtracks") << "*aab" << "aaab" << true;
+    QTest::newRow("glob nbsp") << "Steam Big*" << "Steam\u00A0Big Picture" << true;
+    QTest::newRow("regex") << "re:^Steam .* Mode$" << "Steam Big Picture Mode" << true;
+    QTest::newRow("regex case") << "re:big\\s+picture" << "BIG   PICTURE" << true;
+    QTest::newRow("regex miss") << "re:^Big" << "Steam Big Picture" << false;
+    QTest::newRow("empty title") << "*" << "" << false;
+}
+
+void TestRuleMatcher::matches()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, title);
+    QFETCH(bool, matches);
+
+    QCOMPARE(matchOne(pattern, title), matches ? 0 : -1);
+}
+
+void TestRuleMatcher::firstRuleWins()
+{
+    RuleMatcher matcher(nullptr);
+    matcher.setRules({RuleMatcher::parseRule("re:Mode$"),
+                      RuleMatcher::parseRule("*Picture*"),
+                      RuleMatcher::parseRule("Steam")});
+    QCOMPARE(matcher.matchWindow(u"Steam Big Picture Mode", 0), 0);
+    QCOMPARE(matcher.matchWindow(u"Steam Big Picture", 0), 1);
+    QCOMPARE(matcher.matchWindow(u"Steam", 0), 2);
+    QCOMPARE(matcher.matchWindow(u"Notepad", 0), -1);
+
+    matcher.setRules({RuleMatcher::parseRule("Steam"), RuleMatcher::parseRule("re:Mode$")});
+    QCOMPARE(matcher.matchWindow(u"Steam Big Picture Mode", 0), 0);
+}
+
+void TestRuleMatcher::earlierRegexBeatsLeftmostMatch()
+{
+    // The combined alternation finds "Steam" first, but the "Mode" rule comes first.
+    RuleMatcher matcher(nullptr);
+    matcher.setRules({RuleMatcher::parseRule("re:Mode"), RuleMatcher::parseRule("re:(S)team")});
+    QCOMPARE(matcher.matchWindow(u"Steam Mode", 0), 0);
+    QCOMPARE(matcher.matchWindow(u"Steam", 0), 1);
+}
+
+void TestRuleMatcher::invalidRegexIsIgnored()
+{
+    RuleMatcher matcher(nullptr);
+    matcher.setRules({RuleMatcher::parseRule("re:("), RuleMatcher::parseRule("Steam")});
+    QCOMPARE(matcher.rules().size(), 1);
+    QCOMPARE(matcher.matchWindow(u"Steam", 0), 0);
+}
+
+void TestRuleMatcher::regexesThatCannotCombine()
+{
+    RuleMatcher matcher(nullptr);
+    matcher.setRules({RuleMatcher::parseRule("re:(?<name>Big)"), RuleMatcher::parseRule("re:(?<name>Steam)")});
+    QCOMPARE(matcher.matchWindow(u"Steam", 0), 1);
+    QCOMPARE(matcher.matchWindow(u"Steam Big", 0), 0);
+    QCOMPARE(matcher.matchWindow(u"Notepad", 0), -1);
+}
+
+void TestRuleMatcher::numberedReferencesRunAlone_data()
+{
+    QTest::addColumn<QString>("pattern");
+
+    QTest::newRow("backreference") << "re:(o)\\1";
+    QTest::newRow("g backreference") << "re:(o)\\g1";
+    QTest::newRow("relative backreference") << "re:(o)\\g{-1}";
+    QTest::newRow("subroutine call") << "re:(o)(?1)";
+    QTest::newRow("relative subroutine call") << "re:(o)(?-1)";
+}
+
+void TestRuleMatcher::numberedReferencesRunAlone()
+{
+    // Inside the alternation, group 1 would be the first rule's, and the reference
+    // could never match.
+    QFETCH(QString, pattern);
+
+    RuleMatcher matcher(nullptr);
+    matcher.setRules({RuleMatcher::parseRule("re:^(S)team"), RuleMatcher::parseRule(pattern)});
+    QCOMPARE(matcher.matchWindow(u"Google Chrome", 0), 1);
+    QCOMPARE(matcher.matchWindow(u"Steam Book", 0), 0);
+    QCOMPARE(matcher.matchWindow(u"Notepad", 0), -1);
+
+    matcher.setRules({RuleMatcher::parseRule(pattern), RuleMatcher::parseRule("re:^(S)team")});
+    QCOMPARE(matcher.matchWindow(u"Steam Book", 0), 0);
+    QCOMPARE(matcher.matchWindow(u"Steam", 0), 1);
+}
+
+void TestRuleMatcher::processFilter()
+{
+    FakeProcessSource source;
+    source.addProcess(10, "steamwebhelper.exe");
+    source.addProcess(11, "chrome.exe");
+    ProcessTable processes(&source);
+    processes.refresh();
+
+    RuleMatcher matcher(&processes);
+    QVERIFY(!matcher.usesProcessFilters());
+    matcher.setRules({RuleMatcher::parseRule("Big Picture", "SteamWebHelper.exe"),
+                      RuleMatcher::parseRule("*Picture*")});
+    QVERIFY(matcher.usesProcessFilters());
+
+    QCOMPARE(matcher.matchWindow(u"Steam Big Picture", 10), 0);
+    QCOMPARE(matcher.matchWindow(u"Steam Big Picture", 11), 1);
+    QCOMPARE(matcher.matchWindow(u"Steam Big Picture", 99), 1);
+
+    RuleMatcher withoutProcesses(nullptr);
+    withoutProcesses.setRules({RuleMatcher::parseRule("Big Picture", "steamwebhelper.exe")});
+    QCOMPARE(withoutProcesses.matchWindow(u"Steam Big Picture", 10), -1);
+}
+
+void TestRuleMatcher::agreesWithRulesOnTheirOwn()
+{
+    // Rules whose literals overlap exercise the automaton's failure links.
+    const QStringList patterns = {
+        "*picture*", "*big picture*", "*ure mode", "*tu*", "?team*", "*a*b*c*",
+        "Big Mode", "Picture Steam", "re:^steam", "re:e\\s+m", "re:(x|y)z", "*e?m*",
+    };
+    const QStringList titles = {
+        "Steam Big Picture Mode", "Big picture", "Texture Mode", "abc", "aXbYc", "Steam",
+        "team", "Steam Mode", "xz", "", "Picture Big Steam Mode", "capture mode",
+    };
+
+    QList<RuleMatcher::Rule> rules;
+    for (const QString &pattern : patterns) {
+        rules.append(RuleMatcher::parseRule(pattern));
+    }
+    RuleMatcher matcher(nullptr);
+    matcher.setRules(rules);
+
+    for (const QString &title : titles) {
+        int expected = -1;
+        for (int i = 0; i < patterns.size() && expected < 0; ++i) {
+            if (matchOne(patterns[i], title) == 0) {
+                expected = i;
+            }
+        }
+        QVERIFY2(matcher.matchWindow(title, 0) == expected, qPrintable(title));
+    }
+}
+
+void TestRuleMatcher::describeRule()
+{
+    RuleMatcher matcher(nullptr);
+    matcher.setRules({RuleMatcher::parseRule("re:^Steam", "steam.exe"), RuleMatcher::parseRule("Big Picture")});
+    QCOMPARE(matcher.describeRule(0), QString("regex \"^Steam\" in steam.exe"));
+    QCOMPARE(matcher.describeRule(1), QString("words \"Big Picture\""));
+    QCOMPARE(matcher.describeRule(2), QString());
+}
+
+void TestRuleMatcher::benchmarkMatch_data()
+{
+    QTest::addColumn<int>("ruleCount");
+    QTest::addColumn<QString>("title");
+
+    for (int count : {1, 10, 50, 200}) {
+        QTest::addRow("%d rules, hit", count) << count << "Steam Big Picture Mode";
+        QTest::addRow("%d rules, miss", count) << count << "Untitled - Notepad";
+    }
+}
+
+void TestRuleMatcher::benchmarkMatch()
+{
+    QFETCH(int, ruleCount);
+    QFETCH(QString, title);
+
+    RuleMatcher matcher(nullptr);
+    matcher.setRules(manyRules(ruleCount));
+    int result = -1;
+    QBENCHMARK {
+        result = matcher.matchWindow(title, 0);
+    }
+    Q_UNUSED(result)
+}
+
+QTEST_APPLESS_MAIN(TestRuleMatcher)
+#include "tst_rulematcher.moc"
@@ -0,0 +1,163 @@
+#include "allocationcounter.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Plain thread_locals in the executable are in static TLS, so touching them from
+// inside malloc cannot recurse into the allocator.
+thread_local quint64 threadAllocations = 0;
+thread_local quint64 threadBytes = 0;
+
+inline void record(std::size_t size)
+{
+    ++threadAllocations;
+    threadBytes += size;
+}
+
+} // namespace
+
+#if defined(__GLIBC__)
+
+// glibc exports its allocator under __libc_* names, so malloc and friends can be
+// defined here and forward to it. operator new ends up in malloc and is counted there.
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *pointer, std::size_t size);
+void *__libc_memalign(std::size_t alignment, std::size_t size);
+
+void *malloc(std::size_t size) noexcept
+{
+    record(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(std::size_t count, std::size_t size) noexcept
+{
+    record(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, std::size_t size) noexcept
+{
+    record(size);
+    return __libc_realloc(pointer, size);
+}
+
+void *memalign(std::size_t alignment, std::size_t size) noexcept
+{
+    record(size);
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+{
+    record(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **pointer, std::size_t alignment, std::size_t size) noexcept
+{
+    if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+        return 22; // EINVAL
+    }
+    record(size);
+    void *block = __libc_memalign(alignment, size);
+    if (!block) {
+        return 12; // ENOMEM
+    }
+    *pointer = block;
+    return 0;
+}
+}
+
+bool AllocationCounter::countsCAllocations()
+{
+    return true;
+}
+
+#else
+
+void *operator new(std::size_t size)
+{
+    record(size);
+    if (void *block = std::malloc(size ? size : 1)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    record(size);
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept
+{
+    std::free(pointer);
+}
+
+bool AllocationCounter::countsCAllocations()
+{
+    return false;
+}
+
+#endif
+
+AllocationCounter::AllocationCounter()
+{
+    reset();
+}
+
+void AllocationCounter::reset()
+{
+    startAllocations = threadAllocations;
+    startBytes = threadBytes;
+}
+
+quint64 AllocationCounter::allocations() const
+{
+    return threadAllocations - startAllocations;
+}
+
+quint64 AllocationCounter::bytes() const
+{
+    return threadBytes - startBytes;
+}
@@ -0,0 +1,28 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+// Counts heap allocations made by the calling thread since construction or reset().
+// Linking allocationcounter.cpp replaces the global allocation functions of the
+// executable, so only link it into tests and benchmarks.
+class AllocationCounter
+{
+public:
+    AllocationCounter();
+
+    void reset();
+    quint64 allocations() const;
+    quint64 bytes() const;
+
+    // Qt containers allocate through malloc rather than operator new. Those calls are
+    // only seen where the C allocator can be interposed (glibc); elsewhere just
+    // operator new is counted.
+    static bool countsCAllocations();
+
+private:
+    quint64 startAllocations;
+    quint64 startBytes;
+};
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,134 @@
+#ifndef FAKEAUDIOBACKEND_H
+#define FAKEAUDIOBACKEND_H
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include "audiobackend.h"
+
+// Endpoints kept in memory. Changes made through the setters notify a watcher like
+// the endpoint API does, from whichever thread makes them.
+class FakeAudioBackend : public AudioBackend
+{
+public:
+    FakeAudioBackend()
+        : available(true)
+        , notifies(true)
+        , failListing(false)
+        , prepared(0)
+        , listings(0)
+        , switches(0)
+    {}
+
+    void addEndpoint(const std::string &id, const std::string &name)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            endpoints.push_back(AudioEndpoint{id, name});
+        }
+        notify();
+    }
+
+    void removeEndpoint(const std::string &id)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto it = endpoints.begin(); it != endpoints.end(); ++it) {
+                if (it->id == id) {
+                    endpoints.erase(it);
+                    break;
+                }
+            }
+        }
+        notify();
+    }
+
+    // setDefaultEndpoint() fails for this endpoint, like a disabled device.
+    void refuse(const std::string &id)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        refused.insert(id);
+    }
+
+    std::string defaultId()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return currentDefault;
+    }
+
+    void prepare() override { ++prepared; }
+
+    bool isAvailable() override { return available; }
+
+    std::vector<AudioEndpoint> listEndpoints() override
+    {
+        ++listings;
+        if (failListing) {
+            throw std::runtime_error("Failed to enumerate audio endpoints");
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        return endpoints;
+    }
+
+    std::string defaultEndpointName() override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const AudioEndpoint &endpoint : endpoints) {
+            if (endpoint.id == currentDefault) {
+                return endpoint.name;
+            }
+        }
+        return std::string();
+    }
+
+    bool setDefaultEndpoint(const AudioEndpoint &endpoint) override
+    {
+        ++switches;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (refused.count(endpoint.id)) {
+            return false;
+        }
+        currentDefault = endpoint.id;
+        return true;
+    }
+
+    bool watchEndpoints(const std::function<void()> &changed) override
+    {
+        if (!notifies) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        watcher = changed;
+        return true;
+    }
+
+    bool available;
+    bool notifies;
+    std::atomic<bool> failListing;
+    std::atomic<int> prepared;
+    std::atomic<int> listings;
+    std::atomic<int> switches;
+
+private:
+    void notify()
+    {
+        std::function<void()> changed;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            changed = watcher;
+        }
+        if (changed) {
+            changed();
+        }
+    }
+
+    std::mutex mutex;
+    std::vector<AudioEndpoint> endpoints;
+    std::set<std::string> refused;
+    std::string currentDefault;
+    std::function<void()> watcher;
+};
+
+#endif // FAKEAUDIOBACKEND_H
@@ -0,0 +1,59 @@
+#ifndef FAKEKEYSTORE_H
+#define FAKEKEYSTORE_H
+
+#include <QHash>
+#include <QSet>
+#include "keystore.h"
+
+// In-memory key store. Setting a watched value notifies like a registry change would.
+class FakeKeyStore : public KeyStore
+{
+    Q_OBJECT
+
+public:
+    explicit FakeKeyStore(QObject *parent = nullptr)
+        : KeyStore(parent)
+        , watchable(true)
+        , reads(0)
+    {}
+
+    bool watch(int id, const Location &location) override
+    {
+        locations.insert(id, location);
+        if (watchable) {
+            watched.insert(id);
+        }
+        return watchable;
+    }
+
+    QVariant read(int id) override
+    {
+        ++reads;
+        return values.value(id);
+    }
+
+    // Changes a value without a notification, like a write that has not been reported yet.
+    void write(int id, const QVariant &value) { values.insert(id, value); }
+
+    void set(int id, const QVariant &value)
+    {
+        write(id, value);
+        if (watched.contains(id)) {
+            if (!watchable) {
+                watched.remove(id);
+            }
+            emit changed(id, watchable);
+        }
+    }
+
+    // When false, watch() fails and the next notification reports the watch as lost.
+    bool watchable;
+    int reads;
+    QHash<int, Location> locations;
+
+private:
+    QHash<int, QVariant> values;
+    QSet<int> watched;
+};
+
+#endif // FAKEKEYSTORE_H
@@ -0,0 +1,57 @@
+#ifndef FAKEPROCESSSOURCE_H
+#define FAKEPROCESSSOURCE_H
+
+#include <QHash>
+#include <QMap>
+#include "processsource.h"
+
+// Process list set up by the test. Counts how often it is read.
+class FakeProcessSource : public ProcessSource
+{
+public:
+    FakeProcessSource()
+        : available(true)
+        , listings(0)
+        , commandLineQueries(0)
+    {}
+
+    void addProcess(quint32 processId, const QString &imageName, const QString &commandLine = QString())
+    {
+        images.insert(processId, imageName);
+        commandLines.insert(processId, commandLine);
+    }
+
+    void removeProcess(quint32 processId)
+    {
+        images.remove(processId);
+        commandLines.remove(processId);
+    }
+
+    bool visitProcesses(ProcessVisitor &visitor) const override
+    {
+        ++listings;
+        if (!available) {
+            return false;
+        }
+        for (auto it = images.cbegin(); it != images.cend(); ++it) {
+            visitor.visitProcess(it.key(), it.value());
+        }
+        return true;
+    }
+
+    QString commandLine(quint32 processId) const override
+    {
+        ++commandLineQueries;
+        return commandLines.value(processId);
+    }
+
+    bool available;
+    mutable int listings;
+    mutable int commandLineQueries;
+
+private:
+    QMap<quint32, QString> images;
+    QHash<quint32, QString> commandLines;
+};
+
+#endif // FAKEPROCESSSOURCE_H
@@ -0,0 +1,121 @@
+#ifndef FAKEWINDOWENUMERATOR_H
+#define FAKEWINDOWENUMERATOR_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <algorithm>
+#include "windowenumerator.h"
+
+// Window list set up by a test or benchmark. Reads behave like GetWindowText and
+// GetClassName: truncated to the buffer and never allocating.
+class FakeWindowEnumerator : public WindowEnumerator
+{
+public:
+    struct Window
+    {
+        quintptr handle = 0;
+        QString title;
+        QString className;
+        quint32 processId = 0;
+        bool toolWindow = false;
+    };
+
+    FakeWindowEnumerator()
+        : titleReads(0)
+    {}
+
+    void addWindow(const Window &window)
+    {
+        index.insert(window.handle, windows.size());
+        windows.append(window);
+    }
+
+    void setTitle(quintptr handle, const QString &title)
+    {
+        auto it = index.constFind(handle);
+        if (it != index.constEnd()) {
+            windows[it.value()].title = title;
+        }
+    }
+
+    void removeWindow(quintptr handle)
+    {
+        auto it = index.constFind(handle);
+        if (it == index.constEnd()) {
+            return;
+        }
+        windows.removeAt(it.value());
+        index.clear();
+        for (int i = 0; i < windows.size(); ++i) {
+            index.insert(windows[i].handle, i);
+        }
+    }
+
+    void enumerateWindows(QVector<quintptr> &handles) const override
+    {
+        handles.clear();
+        for (const Window &window : windows) {
+            handles.append(window.handle);
+        }
+    }
+
+    int readTitle(quintptr window, char16_t *buffer, int capacity) const override
+    {
+        ++titleReads;
+        const Window *found = find(window);
+        return found ? copy(found->title, buffer, capacity) : 0;
+    }
+
+    void readAttributes(quintptr window, char16_t *classBuffer, WindowAttributes &attributes) const override
+    {
+        const Window *found = find(window);
+        if (!found) {
+            attributes = WindowAttributes();
+            return;
+        }
+        int length = copy(found->className, classBuffer, CLASS_CAPACITY);
+        attributes.className = QStringView(classBuffer, length);
+        attributes.processId = found->processId;
+        attributes.toolWindow = found->toolWindow;
+    }
+
+    void visitWindows(WindowVisitor &visitor) const override
+    {
+        for (const Window &window : windows) {
+            char16_t className[CLASS_CAPACITY];
+            WindowAttributes attributes;
+            readAttributes(window.handle, className, attributes);
+            if (!visitor.acceptWindow(window.handle, attributes)) {
+                continue;
+            }
+            char16_t title[TITLE_CAPACITY];
+            int length = readTitle(window.handle, title, TITLE_CAPACITY);
+            if (!visitor.visitWindow(window.handle, QStringView(title, length))) {
+                return;
+            }
+        }
+    }
+
+    mutable int titleReads;
+
+private:
+    const Window *find(quintptr handle) const
+    {
+        auto it = index.constFind(handle);
+        return it != index.constEnd() ? &windows[it.value()] : nullptr;
+    }
+
+    // Like the Win32 calls, leaves room for the terminator.
+    static int copy(const QString &text, char16_t *buffer, int capacity)
+    {
+        int length = std::min(int(text.size()), capacity - 1);
+        std::copy_n(reinterpret_cast<const char16_t *>(text.utf16()), length, buffer);
+        return length;
+    }
+
+    QList<Window> windows;
+    QHash<quintptr, int> index;
+};
+
+#endif // FAKEWINDOWENUMERATOR_H
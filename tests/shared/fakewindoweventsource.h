@@ -0,0 +1,39 @@
+#ifndef FAKEWINDOWEVENTSOURCE_H
+#define FAKEWINDOWEVENTSOURCE_H
+
+#include "windoweventsource.h"
+
+// Window event source driven by the test instead of system hooks.
+class FakeWindowEventSource : public WindowEventSource
+{
+    Q_OBJECT
+
+public:
+    explicit FakeWindowEventSource(QObject *parent = nullptr)
+        : WindowEventSource(parent)
+        , active(false)
+    {}
+
+    bool start() override
+    {
+        active = true;
+        return true;
+    }
+
+    void stop() override { active = false; }
+
+    bool isActive() const override { return active; }
+
+    // Delivers an event as if a hook had reported it.
+    void inject(quintptr window, EventType type)
+    {
+        if (active) {
+            publish(window, type);
+        }
+    }
+
+private:
+    bool active;
+};
+
+#endif // FAKEWINDOWEVENTSOURCE_H
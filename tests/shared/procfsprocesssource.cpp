@@ -0,0 +1,59 @@
+#include "procfsprocesssource.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+ProcfsProcessSource::ProcfsProcessSource() {}
+
+ProcfsProcessSource::~ProcfsProcessSource() {}
+
+QString ProcfsProcessSource::imageName(const QString &processDirectory)
+{
+    // The executable link is only readable for our own processes; comm is always
+    // readable but truncated to 15 characters.
+    QString target = QFileInfo(processDirectory + "/exe").symLinkTarget();
+    if (!target.isEmpty()) {
+        return QFileInfo(target).fileName();
+    }
+
+    QFile comm(processDirectory + "/comm");
+    if (!comm.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    return QString::fromUtf8(comm.readAll()).trimmed();
+}
+
+bool ProcfsProcessSource::visitProcesses(ProcessVisitor &visitor) const
+{
+    QDir proc("/proc");
+    if (!proc.exists()) {
+        return false;
+    }
+
+    const QStringList entries = proc.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &entry : entries) {
+        bool numeric = false;
+        quint32 processId = entry.toUInt(&numeric);
+        if (!numeric) {
+            continue;
+        }
+        // Processes can exit while the list is walked.
+        QString image = imageName(proc.filePath(entry));
+        if (!image.isEmpty()) {
+            visitor.visitProcess(processId, image);
+        }
+    }
+    return true;
+}
+
+QString ProcfsProcessSource::commandLine(quint32 processId) const
+{
+    QFile file(QString("/proc/%1/cmdline").arg(processId));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    // Arguments are separated by NUL bytes.
+    QByteArray arguments = file.readAll();
+    arguments.replace('\0', ' ');
+    return QString::fromUtf8(arguments).trimmed();
+}
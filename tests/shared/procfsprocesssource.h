@@ -0,0 +1,21 @@
+#ifndef PROCFSPROCESSSOURCE_H
+#define PROCFSPROCESSSOURCE_H
+
+#include "processsource.h"
+
+// Reads the process list from /proc, so ProcessTable can be exercised against real
+// processes on Linux.
+class ProcfsProcessSource : public ProcessSource
+{
+public:
+    ProcfsProcessSource();
+    ~ProcfsProcessSource();
+
+    bool visitProcesses(ProcessVisitor &visitor) const override;
+    QString commandLine(quint32 processId) const override;
+
+private:
+    static QString imageName(const QString &processDirectory);
+};
+
+#endif // PROCFSPROCESSSOURCE_H
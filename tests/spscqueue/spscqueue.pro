@@ -0,0 +1,15 @@
+include(../tests.pri)
+
+TARGET = tst_spscqueue
+
+# Run under ThreadSanitizer, so a missing acquire/release pair is reported as a race.
+CONFIG += sanitizer sanitize_thread
+
+INCLUDEPATH += \
+    $$SRC_DIR/DetectionWorker \
+
+SOURCES += \
+    tst_spscqueue.cpp
+
+HEADERS += \
+    $$SRC_DIR/DetectionWorker/spscqueue.h
@@ -0,0 +1,111 @@
+#include <QtTest>
+#include <thread>
+#include "spscqueue.h"
+
+class TestSpscQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void popsInOrder();
+    void fullQueueRejects();
+    void wrapsAround();
+    void popReleasesValue();
+    void stress();
+};
+
+void TestSpscQueue::popsInOrder()
+{
+    SpscQueue<int, 4> queue;
+    int value = 0;
+    QVERIFY(!queue.pop(value));
+
+    QVERIFY(queue.push(1));
+    QVERIFY(queue.push(2));
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, 1);
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, 2);
+    QVERIFY(!queue.pop(value));
+}
+
+void TestSpscQueue::fullQueueRejects()
+{
+    SpscQueue<int, 4> queue;
+    for (int i = 0; i < 4; ++i) {
+        QVERIFY(queue.push(i));
+    }
+    QVERIFY(!queue.push(4));
+
+    int value = -1;
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, 0);
+    QVERIFY(queue.push(4));
+    for (int i = 1; i <= 4; ++i) {
+        QVERIFY(queue.pop(value));
+        QCOMPARE(value, i);
+    }
+}
+
+void TestSpscQueue::wrapsAround()
+{
+    // Push and pop many times the capacity, so the positions wrap the buffer.
+    SpscQueue<int, 2> queue;
+    int value = -1;
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(queue.push(i));
+        QVERIFY(queue.pop(value));
+        QCOMPARE(value, i);
+    }
+}
+
+void TestSpscQueue::popReleasesValue()
+{
+    SpscQueue<QString, 2> queue;
+    QString detail = QString("Big Picture detected").repeated(4);
+    QVERIFY(queue.push(detail));
+    QVERIFY(!detail.isDetached());
+
+    QString popped;
+    QVERIFY(queue.pop(popped));
+    popped.clear();
+    QVERIFY(detail.isDetached());
+}
+
+void TestSpscQueue::stress()
+{
+    // Small capacity keeps the queue full or empty most of the time, which is where
+    // a wrong memory order would show up.
+    static const int COUNT = 200000;
+    SpscQueue<QString, 8> queue;
+
+    std::thread producer([&queue]() {
+        for (int i = 0; i < COUNT; ++i) {
+            QString value = QString::number(i);
+            while (!queue.push(value)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    int mismatches = 0;
+    QString value;
+    while (expected < COUNT) {
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (value.toInt() != expected) {
+            ++mismatches;
+        }
+        ++expected;
+    }
+    producer.join();
+
+    QCOMPARE(mismatches, 0);
+    QVERIFY(!queue.pop(value));
+}
+
+QTEST_APPLESS_MAIN(TestSpscQueue)
+#include "tst_spscqueue.moc"
@@ -0,0 +1,86 @@
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QStringList>
+#include <QThread>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+// Answers PowerShellHost requests like the PowerShell bootstrap does. A script is
+// "<command> <argument>":
+//   echo <text>         outputs the text
+//   fail <text>         reports the text as an error
+//   sleep <ms> <text>   waits, then outputs the text
+//   noise <text>        writes stray lines before the answer
+//   pid                 outputs the process id, to tell restarts apart
+//   exit                exits without answering
+// --exit-before-ready makes it exit before announcing itself, --noise-before-ready
+// writes import warnings first. For the process runner tests, --run <ms> <code>
+// instead waits, prints "done" and exits with the code.
+namespace {
+
+void answer(const std::string &id, const QByteArray &output, const QByteArray &error)
+{
+    std::cout << id << ' ' << output.toBase64().constData() << ' ' << error.toBase64().constData() << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList arguments = app.arguments();
+    if (arguments.contains("--exit-before-ready")) {
+        return 1;
+    }
+    int run = arguments.indexOf("--run");
+    if (run >= 0 && run + 2 < arguments.size()) {
+        QThread::msleep(arguments[run + 1].toULong());
+        std::cout << "done" << std::endl;
+        return arguments[run + 2].toInt();
+    }
+
+    if (arguments.contains("--noise-before-ready")) {
+        std::cout << "WARNING: The names of some imported commands from the module 'AudioDeviceCmdlets' include "
+                     "unapproved verbs."
+                  << std::endl;
+        std::cout << std::endl;
+    }
+    std::cout << "ready" << std::endl;
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        size_t space = line.find(' ');
+        std::string id = line.substr(0, space);
+        QByteArray script = space == std::string::npos
+                                ? QByteArray()
+                                : QByteArray::fromBase64(QByteArray::fromStdString(line.substr(space + 1)));
+
+        int split = script.indexOf(' ');
+        QByteArray command = split < 0 ? script : script.left(split);
+        QByteArray argument = split < 0 ? QByteArray() : script.mid(split + 1);
+
+        if (command == "echo") {
+            answer(id, argument, QByteArray());
+        } else if (command == "fail") {
+            answer(id, QByteArray(), argument);
+        } else if (command == "sleep") {
+            int next = argument.indexOf(' ');
+            QThread::msleep(argument.left(next).toULong());
+            answer(id, next < 0 ? QByteArray() : argument.mid(next + 1), QByteArray());
+        } else if (command == "noise") {
+            std::cout << "WARNING: The module imported some commands with unapproved verbs." << std::endl;
+            std::cout << "0 c3RhbGU= " << std::endl;
+            answer(id, argument, QByteArray());
+        } else if (command == "pid") {
+            answer(id, QByteArray::number(QCoreApplication::applicationPid()), QByteArray());
+        } else if (command == "exit") {
+            return 0;
+        } else {
+            answer(id, QByteArray(), "unknown command: " + command);
+        }
+    }
+    return 0;
+}
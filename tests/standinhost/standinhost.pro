@@ -0,0 +1,12 @@
+# Speaks the PowerShellHost protocol without PowerShell, for tst_powershellhost; also
+# the child process of tst_processrunner.
+QT -= gui
+
+CONFIG += c++17 console silent
+CONFIG -= app_bundle debug_and_release
+
+TARGET = standinhost
+DESTDIR = $$OUT_PWD
+
+SOURCES += \
+    main.cpp
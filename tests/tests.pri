@@ -0,0 +1,14 @@
+QT -= gui
+QT += testlib
+
+CONFIG += c++17 \
+          console \
+          silent \
+          testcase \
+
+CONFIG -= app_bundle
+
+SRC_DIR = $$PWD/../src
+SHARED_DIR = $$PWD/shared
+
+INCLUDEPATH += $$SHARED_DIR
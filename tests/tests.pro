@@ -0,0 +1,25 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    audiomanager \
+    bigpicturetitles \
+    detectionscheduler \
+    detectionstatemachine \
+    powershellaudiobackend \
+    powershellhost \
+    processrunner \
+    processtable \
+    registrywatcher \
+    rulematcher \
+    spscqueue \
+    standinhost \
+    titlematcher \
+    tracerecorder \
+    transitionexecutor \
+    windoweventsource \
+    windowfilter \
+    windowtable
+
+# These tests run the stand-in program.
+powershellhost.depends = standinhost
+processrunner.depends = standinhost
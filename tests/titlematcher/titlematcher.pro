@@ -0,0 +1,19 @@
+include(../tests.pri)
+
+TARGET = tst_titlematcher
+
+INCLUDEPATH += \
+    $$SRC_DIR/SteamWindowManager \
+    $$SRC_DIR/TitleMatcher \
+    $$SRC_DIR/WindowMatcher \
+
+SOURCES += \
+    $$SHARED_DIR/allocationcounter.cpp \
+    $$SRC_DIR/TitleMatcher/titlematcher.cpp \
+    tst_titlematcher.cpp
+
+HEADERS += \
+    $$SHARED_DIR/allocationcounter.h \
+    $$SRC_DIR/SteamWindowManager/bigpicturetitles.h \
+    $$SRC_DIR/TitleMatcher/titlematcher.h \
+    $$SRC_DIR/WindowMatcher/windowmatcher.h
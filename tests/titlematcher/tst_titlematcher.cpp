@@ -0,0 +1,267 @@
+#include <QtTest>
+#include <algorithm>
+#include "allocationcounter.h"
+#include "bigpicturetitles.h"
+#include "titlematcher.h"
+
+class TestTitleMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void matchesWordsInAnyOrder_data();
+    void matchesWordsInAnyOrder();
+    void prefersTargetWithMostWords();
+    void matchAllReportsEveryTarget();
+    void duplicateTargetsShareAnIndex();
+    void clearRemovesTargets();
+    void scanDoesNotAllocate();
+    void foldMatchesToLower_data();
+    void foldMatchesToLower();
+    void foldHandlesEveryBlockBoundary();
+    void benchmarkMatch_data();
+    void benchmarkMatch();
+    void benchmarkFold_data();
+    void benchmarkFold();
+
+private:
+    static TitleMatcher manyTargets(int count);
+    static QString fold(const QString &text);
+    static QString lowered(const QString &text);
+};
+
+TitleMatcher TestTitleMatcher::manyTargets(int count)
+{
+    // Distinct words per target push the matcher past any small inline capacity.
+    TitleMatcher matcher;
+    for (int i = 0; i < count; ++i) {
+        matcher.addTarget(QString("Window%1 Title%1").arg(i));
+    }
+    matcher.addTarget("Steam Big Picture mode");
+    return matcher;
+}
+
+QString TestTitleMatcher::fold(const QString &text)
+{
+    QString folded(text.size(), Qt::Uninitialized);
+    TitleMatcher::fold(reinterpret_cast<const char16_t *>(text.utf16()),
+                       text.size(),
+                       reinterpret_cast<char16_t *>(folded.data()));
+    return folded;
+}
+
+// What fold() promises: QString::toLower(), plus NBSP as a plain space.
+QString TestTitleMatcher::lowered(const QString &text)
+{
+    return text.toLower().replace(QChar(0x00A0), u' ');
+}
+
+void TestTitleMatcher::matchesWordsInAnyOrder_data()
+{
+    QTest::addColumn<QString>("target");
+    QTest::addColumn<QString>("title");
+    QTest::addColumn<bool>("matches");
+
+    QTest::newRow("exact") << "Steam Big Picture mode" << "Steam Big Picture mode" << true;
+    QTest::newRow("case") << "Steam Big Picture mode" << "STEAM big picture MODE" << true;
+    QTest::newRow("order") << "Steam Big Picture mode" << "mode Picture Big Steam" << true;
+    QTest::newRow("extra words") << "Big Picture" << "Steam Big Picture mode" << true;
+    QTest::newRow("nbsp") << "Steam Big Picture mode" << "Steam\u00A0Big\u00A0Picture mode" << true;
+    QTest::newRow("spaces") << "Steam Big Picture" << "  Steam   Big  Picture  " << true;
+    QTest::newRow("accent") << "Modalità Big Picture" << "MODALITÀ BIG PICTURE" << true;
+    QTest::newRow("cyrillic") << "Режим Big Picture" << "РЕЖИМ BIG PICTURE" << true;
+    QTest::newRow("cjk") << "Steam 大屏幕模式" << "Steam\u00A0大屏幕模式" << true;
+    QTest::newRow("missing word") << "Steam Big Picture mode" << "Steam Big mode" << false;
+    QTest::newRow("partial word") << "Steam Big Picture" << "Steam Bigger Picture" << false;
+    QTest::newRow("empty title") << "Steam" << "" << false;
+}
+
+void TestTitleMatcher::matchesWordsInAnyOrder()
+{
+    QFETCH(QString, target);
+    QFETCH(QString, title);
+    QFETCH(bool, matches);
+
+    TitleMatcher matcher;
+    matcher.setTarget(target);
+    QCOMPARE(matcher.matches(title), matches);
+    QCOMPARE(matcher.matchWindow(title, 0), matches ? 0 : -1);
+}
+
+void TestTitleMatcher::prefersTargetWithMostWords()
+{
+    TitleMatcher matcher;
+    int shortTarget = matcher.addTarget("Big Picture");
+    int longTarget = matcher.addTarget("Steam Big Picture mode");
+
+    QCOMPARE(matcher.match("Steam Big Picture mode"), longTarget);
+    QCOMPARE(matcher.match("Big Picture"), shortTarget);
+    QCOMPARE(matcher.match("Steam"), -1);
+}
+
+void TestTitleMatcher::matchAllReportsEveryTarget()
+{
+    TitleMatcher matcher;
+    int first = matcher.addTarget("Big Picture");
+    int second = matcher.addTarget("Steam mode");
+    matcher.addTarget("Discord");
+
+    QList<int> matched;
+    matcher.matchAll("Steam Big Picture mode", matched);
+    std::sort(matched.begin(), matched.end());
+    QCOMPARE(matched, QList<int>({first, second}));
+}
+
+void TestTitleMatcher::duplicateTargetsShareAnIndex()
+{
+    TitleMatcher matcher;
+    int first = matcher.addTarget("Steam Big Picture");
+    QCOMPARE(matcher.addTarget("Steam Big Picture"), first);
+    QCOMPARE(matcher.targetCount(), 1);
+    QCOMPARE(matcher.target(first), QString("Steam Big Picture"));
+}
+
+void TestTitleMatcher::clearRemovesTargets()
+{
+    TitleMatcher matcher;
+    matcher.addTarget("Steam Big Picture");
+    matcher.clear();
+    QVERIFY(matcher.isEmpty());
+    QCOMPARE(matcher.match("Steam Big Picture"), -1);
+
+    matcher.addTarget("Discord");
+    QCOMPARE(matcher.match("Discord"), 0);
+}
+
+void TestTitleMatcher::scanDoesNotAllocate()
+{
+    TitleMatcher matcher = manyTargets(150);
+    const QString titles[] = {"Steam Big Picture mode",
+                              "Window149 Title149",
+                              "Untitled - Notepad",
+                              QString(200, u'x')};
+    QList<int> matched;
+    matched.reserve(8);
+
+    // The first scan may still detach the scratch counters.
+    for (const QString &title : titles) {
+        matcher.matchAll(title, matched);
+        matched.clear();
+    }
+
+    AllocationCounter counter;
+    for (int round = 0; round < 100; ++round) {
+        for (const QString &title : titles) {
+            matcher.match(title);
+            matcher.matchAll(title, matched);
+            matched.clear();
+        }
+    }
+    QCOMPARE(counter.allocations(), quint64(0));
+}
+
+void TestTitleMatcher::foldMatchesToLower_data()
+{
+    QTest::addColumn<QString>("text");
+
+    for (int entry = 0; entry < BigPictureTitles::COUNT; ++entry) {
+        QString title = QString::fromUtf16(BigPictureTitles::ENTRIES[entry].title);
+        QString language = QString::fromUtf16(BigPictureTitles::ENTRIES[entry].language);
+        QTest::newRow(qPrintable(language)) << title;
+        QTest::newRow(qPrintable(language + " upper")) << title.toUpper();
+    }
+
+    QTest::newRow("empty") << QString();
+    QTest::newRow("ascii block") << "ABCDEFGHIJKLMNOPQRSTUVWXYZ [\\]^_`abcxyz{|}~@ 0123456789";
+    QTest::newRow("nbsp runs") << "STEAM\u00A0\u00A0BIG\u00A0PICTURE\u00A0MODE - Google Chrome";
+    QTest::newRow("latin-1") << "ÀÁÂÃÄÅÆÇÈÉÊËÌÍÎÏÐÑÒÓÔÕÖØÙÚÛÜÝÞ ×÷ß";
+    QTest::newRow("greek") << "ΑΒΓΔΕΖΗΘΙΚΛΜΝΞΟΠΡΣΤΥΦΧΨΩ ΆΈΉΊΌΎΏ";
+    QTest::newRow("cyrillic") << "ЀЁЂЃЄЅІЇЈЉЊЋЌЍЎЏАБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+    // Deseret has case pairs outside the BMP, so surrogates must be folded as pairs.
+    QTest::newRow("surrogates") << "ABCDEFG\U00010400\U00010401 Steam \U00010402xyz";
+    QTest::newRow("emoji") << "Steam 🎮 Big Picture 🎮🎮🎮 MODE";
+    QTest::newRow("lone surrogate") << QString("ABCDEFG") + QChar(0xD800) + "HIJ" + QChar(0xDC00);
+}
+
+void TestTitleMatcher::foldMatchesToLower()
+{
+    QFETCH(QString, text);
+    QCOMPARE(fold(text), lowered(text));
+}
+
+void TestTitleMatcher::foldHandlesEveryBlockBoundary()
+{
+    // The vector path works on blocks of 8 units and hands non-ASCII blocks to the
+    // scalar path, so put a non-ASCII unit or pair at every offset of every length.
+    const QString inserts[] = {"É", "\u00A0", "Ж", "大", "\U00010400"};
+    for (int length = 1; length <= 40; ++length) {
+        for (int position = 0; position < length; ++position) {
+            for (const QString &insert : inserts) {
+                QString text = QString(length, u'A');
+                text.replace(position, 1, insert);
+                QCOMPARE(fold(text), lowered(text));
+            }
+        }
+    }
+}
+
+void TestTitleMatcher::benchmarkMatch_data()
+{
+    QTest::addColumn<int>("targetCount");
+    QTest::addColumn<QString>("title");
+
+    QTest::newRow("1 target, hit") << 0 << "Steam Big Picture mode";
+    QTest::newRow("1 target, miss") << 0 << "Untitled - Notepad";
+    QTest::newRow("200 targets, hit") << 200 << "Steam Big Picture mode";
+    QTest::newRow("200 targets, miss") << 200 << "Untitled - Notepad";
+}
+
+void TestTitleMatcher::benchmarkMatch()
+{
+    QFETCH(int, targetCount);
+    QFETCH(QString, title);
+
+    TitleMatcher matcher = manyTargets(targetCount);
+    int result = -1;
+    QBENCHMARK {
+        result = matcher.match(title);
+    }
+    Q_UNUSED(result)
+}
+
+void TestTitleMatcher::benchmarkFold_data()
+{
+    QTest::addColumn<bool>("vectorized");
+    QTest::addColumn<QString>("text");
+
+    const QString ascii = QString("Steam Big Picture Mode - Google Chrome ").repeated(6);
+    const QString mixed = QString("Steam\u00A0Большая картинка 大屏幕模式 ").repeated(8);
+    QTest::newRow("fold, ascii") << true << ascii;
+    QTest::newRow("toLower, ascii") << false << ascii;
+    QTest::newRow("fold, mixed") << true << mixed;
+    QTest::newRow("toLower, mixed") << false << mixed;
+}
+
+void TestTitleMatcher::benchmarkFold()
+{
+    QFETCH(bool, vectorized);
+    QFETCH(QString, text);
+
+    // Window titles are read into buffers of this size.
+    char16_t buffer[256];
+    const qsizetype length = qMin(text.size(), qsizetype(256));
+    if (vectorized) {
+        QBENCHMARK {
+            TitleMatcher::fold(reinterpret_cast<const char16_t *>(text.utf16()), length, buffer);
+        }
+    } else {
+        QBENCHMARK {
+            QString folded = text.toLower();
+            Q_UNUSED(folded)
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(TestTitleMatcher)
+
+#include "tst_titlematcher.moc"
@@ -0,0 +1,15 @@
+include(../tests.pri)
+
+TARGET = tst_tracerecorder
+
+INCLUDEPATH += \
+    $$SRC_DIR/TraceRecorder \
+
+SOURCES += \
+    $$SHARED_DIR/allocationcounter.cpp \
+    $$SRC_DIR/TraceRecorder/tracerecorder.cpp \
+    tst_tracerecorder.cpp
+
+HEADERS += \
+    $$SHARED_DIR/allocationcounter.h \
+    $$SRC_DIR/TraceRecorder/tracerecorder.h
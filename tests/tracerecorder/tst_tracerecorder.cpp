@@ -0,0 +1,169 @@
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QtTest>
+#include "allocationcounter.h"
+#include "tracerecorder.h"
+
+class TestTraceRecorder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void disabledSpanRecordsNothing();
+    void disabledSpanDoesNotAllocate();
+    void spanRecordsNameAndDetail();
+    void ringKeepsNewestEvents();
+    void writesChromeTrace();
+    void benchmarkSpan_data();
+    void benchmarkSpan();
+
+private:
+    static QJsonArray writeAndRead(const QString &path);
+};
+
+void TestTraceRecorder::init()
+{
+    TraceRecorder::instance()->setEnabled(false);
+    TraceRecorder::instance()->clear();
+}
+
+void TestTraceRecorder::cleanup()
+{
+    TraceRecorder::instance()->setEnabled(false);
+}
+
+QJsonArray TestTraceRecorder::writeAndRead(const QString &path)
+{
+    if (!TraceRecorder::instance()->writeChromeTrace(path)) {
+        return QJsonArray();
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QJsonArray();
+    }
+    return QJsonDocument::fromJson(file.readAll()).object().value("traceEvents").toArray();
+}
+
+void TestTraceRecorder::disabledSpanRecordsNothing()
+{
+    {
+        TraceRecorder::Span span(QStringLiteral("sweep"), "detection");
+        QVERIFY(!span.isRecording());
+        span.setDetail("ignored");
+    }
+    TraceRecorder::instance()->record("direct", "detection", 0, 1);
+    QCOMPARE(TraceRecorder::instance()->size(), 0);
+}
+
+void TestTraceRecorder::disabledSpanDoesNotAllocate()
+{
+    const QString name = QStringLiteral("process");
+    const QStringList arguments = {"-NoProfile", "-Command", "Get-AudioDevice -List"};
+
+    AllocationCounter counter;
+    for (int i = 0; i < 100; ++i) {
+        TraceRecorder::Span span(name, "process");
+        if (span.isRecording()) {
+            span.setDetail(arguments.join(' '));
+        }
+    }
+    QCOMPARE(counter.allocations(), quint64(0));
+}
+
+void TestTraceRecorder::spanRecordsNameAndDetail()
+{
+    TraceRecorder::instance()->setEnabled(true);
+    {
+        TraceRecorder::Span span(QStringLiteral("process"), "process");
+        QVERIFY(span.isRecording());
+        span.setName("powershell.exe");
+        span.setDetail("-NoProfile");
+    }
+    QCOMPARE(TraceRecorder::instance()->size(), 1);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QJsonArray events = writeAndRead(dir.filePath("trace.json"));
+    QCOMPARE(events.size(), 1);
+    QJsonObject event = events[0].toObject();
+    QCOMPARE(event.value("name").toString(), QString("powershell.exe"));
+    QCOMPARE(event.value("cat").toString(), QString("process"));
+    QCOMPARE(event.value("args").toObject().value("detail").toString(), QString("-NoProfile"));
+    QVERIFY(event.value("dur").toDouble() >= 0);
+}
+
+void TestTraceRecorder::ringKeepsNewestEvents()
+{
+    TraceRecorder *recorder = TraceRecorder::instance();
+    recorder->setEnabled(true);
+    int total = TraceRecorder::CAPACITY + 10;
+    for (int i = 0; i < total; ++i) {
+        recorder->record("event", "test", i, 1);
+    }
+    QCOMPARE(recorder->size(), TraceRecorder::CAPACITY);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QJsonArray events = writeAndRead(dir.filePath("trace.json"));
+    QCOMPARE(events.size(), TraceRecorder::CAPACITY);
+    QCOMPARE(events.first().toObject().value("ts").toInteger(), qint64(10));
+    QCOMPARE(events.last().toObject().value("ts").toInteger(), qint64(total - 1));
+
+    recorder->clear();
+    QCOMPARE(recorder->size(), 0);
+}
+
+void TestTraceRecorder::writesChromeTrace()
+{
+    TraceRecorder *recorder = TraceRecorder::instance();
+    recorder->setThreadName("test");
+    recorder->setEnabled(true);
+    recorder->record("event", "test", 5, 2);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QJsonArray events = writeAndRead(dir.filePath("nested/trace.json"));
+
+    QJsonObject metadata;
+    QJsonObject event;
+    for (const QJsonValue &value : std::as_const(events)) {
+        QJsonObject object = value.toObject();
+        if (object.value("ph").toString() == "M") {
+            metadata = object;
+        } else {
+            event = object;
+        }
+    }
+    QCOMPARE(metadata.value("args").toObject().value("name").toString(), QString("test"));
+    QCOMPARE(event.value("ph").toString(), QString("X"));
+    QCOMPARE(event.value("ts").toInteger(), qint64(5));
+    QCOMPARE(event.value("dur").toInteger(), qint64(2));
+    QCOMPARE(event.value("tid").toInteger(), metadata.value("tid").toInteger());
+    QVERIFY(!event.contains("args"));
+}
+
+void TestTraceRecorder::benchmarkSpan_data()
+{
+    QTest::addColumn<bool>("enabled");
+
+    QTest::newRow("disabled") << false;
+    QTest::newRow("enabled") << true;
+}
+
+void TestTraceRecorder::benchmarkSpan()
+{
+    QFETCH(bool, enabled);
+
+    TraceRecorder::instance()->setEnabled(enabled);
+    const QString name = QStringLiteral("window sweep");
+    QBENCHMARK {
+        TraceRecorder::Span span(name, "detection");
+    }
+}
+
+QTEST_APPLESS_MAIN(TestTraceRecorder)
+#include "tst_tracerecorder.moc"
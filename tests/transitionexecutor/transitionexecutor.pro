@@ -0,0 +1,16 @@
+include(../tests.pri)
+
+TARGET = tst_transitionexecutor
+
+INCLUDEPATH += \
+    $$SRC_DIR/TraceRecorder \
+    $$SRC_DIR/TransitionExecutor \
+
+SOURCES += \
+    $$SRC_DIR/TraceRecorder/tracerecorder.cpp \
+    $$SRC_DIR/TransitionExecutor/transitionexecutor.cpp \
+    tst_transitionexecutor.cpp
+
+HEADERS += \
+    $$SRC_DIR/TraceRecorder/tracerecorder.h \
+    $$SRC_DIR/TransitionExecutor/transitionexecutor.h
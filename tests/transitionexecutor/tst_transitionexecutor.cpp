@@ -0,0 +1,271 @@
+#include <QMutex>
+#include <QSemaphore>
+#include <QSignalSpy>
+#include <QThread>
+#include <QtTest>
+#include <stdexcept>
+#include "transitionexecutor.h"
+
+class TestTransitionExecutor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void runsDependenciesFirst();
+    void independentActionsOverlap();
+    void rejectsCycles();
+    void missingDependencyIsMet();
+    void matchingStateSkipsOffOwnerThread();
+    void ownerThreadActionsRunOnOwner();
+    void failingActionDoesNotStopTransition();
+    void cancelStopsAtActionBoundary();
+    void rapidTogglesSettleOnLatestTarget();
+
+private:
+    static bool runToEnd(TransitionExecutor &executor);
+};
+
+bool TestTransitionExecutor::runToEnd(TransitionExecutor &executor)
+{
+    QSignalSpy finished(&executor, &TransitionExecutor::finished);
+    if (!executor.start()) {
+        return false;
+    }
+    return finished.wait(5000) && !executor.isRunning();
+}
+
+void TestTransitionExecutor::runsDependenciesFirst()
+{
+    TransitionExecutor executor;
+    QMutex mutex;
+    QStringList order;
+    auto log = [&mutex, &order](const QString &name) {
+        return [&mutex, &order, name]() {
+            QMutexLocker locker(&mutex);
+            order.append(name);
+        };
+    };
+    executor.addAction("audio", {"display"}, log("audio"));
+    executor.addAction("display", {}, log("display"));
+    executor.addAction("notify", {"audio", "display"}, log("notify"));
+
+    QVERIFY(runToEnd(executor));
+    QCOMPARE(order, QStringList({"display", "audio", "notify"}));
+    QCOMPARE(executor.count(TransitionExecutor::Done), 3);
+    QVERIFY(!executor.wasCancelled());
+}
+
+void TestTransitionExecutor::independentActionsOverlap()
+{
+    // Each action waits for the other to start, which only works if both run at once.
+    TransitionExecutor executor;
+    QSemaphore first;
+    QSemaphore second;
+    std::atomic<int> met{0};
+    executor.addAction("a", {}, [&]() {
+        first.release();
+        met += second.tryAcquire(1, 2000) ? 1 : 0;
+    });
+    executor.addAction("b", {}, [&]() {
+        second.release();
+        met += first.tryAcquire(1, 2000) ? 1 : 0;
+    });
+
+    QVERIFY(runToEnd(executor));
+    QCOMPARE(met.load(), 2);
+}
+
+void TestTransitionExecutor::rejectsCycles()
+{
+    TransitionExecutor executor;
+    executor.addAction("a", {"b"}, []() {});
+    executor.addAction("b", {"a"}, []() {});
+    QVERIFY(!executor.start());
+    QVERIFY(!executor.isRunning());
+
+    executor.clear();
+    executor.addAction("self", {"self"}, []() {});
+    QVERIFY(!executor.start());
+
+    executor.clear();
+    QVERIFY(!executor.start());
+}
+
+void TestTransitionExecutor::missingDependencyIsMet()
+{
+    TransitionExecutor executor;
+    bool ran = false;
+    executor.addAction("audio", {"display"}, [&ran]() { ran = true; }, TransitionExecutor::OwnerThread);
+    QVERIFY(runToEnd(executor));
+    QVERIFY(ran);
+}
+
+void TestTransitionExecutor::matchingStateSkipsOffOwnerThread()
+{
+    TransitionExecutor executor;
+    QThread *checkThread = nullptr;
+    std::atomic<bool> ran{false};
+
+    TransitionExecutor::StateCheck same;
+    same.currentState = [&checkThread]() {
+        checkThread = QThread::currentThread();
+        return QString("Extend");
+    };
+    same.desiredState = "extend";
+    executor.addAction("display", {}, [&ran]() { ran = true; }, TransitionExecutor::Pool, same);
+
+    TransitionExecutor::StateCheck different;
+    different.currentState = []() { return QString("running"); };
+    different.desiredState = "stopped";
+    executor.addAction("discord", {"display"}, []() {}, TransitionExecutor::Pool, different);
+
+    QVERIFY(runToEnd(executor));
+    QVERIFY(!ran);
+    QVERIFY(checkThread != nullptr);
+    QVERIFY(checkThread != QThread::currentThread());
+
+    const QList<TransitionExecutor::Timing> &timings = executor.timings();
+    QCOMPARE(timings[0].status, TransitionExecutor::Skipped);
+    QCOMPARE(timings[0].state, QString("Extend"));
+    QCOMPARE(timings[1].status, TransitionExecutor::Done);
+    QCOMPARE(timings[1].state, QString("running"));
+    QVERIFY(executor.report().contains("display skipped, already Extend"));
+}
+
+void TestTransitionExecutor::ownerThreadActionsRunOnOwner()
+{
+    TransitionExecutor executor;
+    QThread *actionThread = nullptr;
+    QThread *checkThread = nullptr;
+    TransitionExecutor::StateCheck check;
+    check.currentState = [&checkThread]() {
+        checkThread = QThread::currentThread();
+        return QString("on");
+    };
+    check.desiredState = "off";
+    executor.addAction("nightlight", {}, [&actionThread]() {
+        actionThread = QThread::currentThread();
+    }, TransitionExecutor::OwnerThread, check);
+
+    QVERIFY(runToEnd(executor));
+    QCOMPARE(actionThread, QThread::currentThread());
+    QCOMPARE(checkThread, QThread::currentThread());
+}
+
+void TestTransitionExecutor::failingActionDoesNotStopTransition()
+{
+    TransitionExecutor executor;
+    std::atomic<bool> ran{false};
+    executor.addAction("display", {}, []() { throw std::runtime_error("display switch failed"); });
+    executor.addAction("audio", {"display"}, [&ran]() { ran = true; });
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("display.*display switch failed"));
+    QVERIFY(runToEnd(executor));
+    QVERIFY(ran);
+    QCOMPARE(executor.count(TransitionExecutor::Done), 2);
+}
+
+void TestTransitionExecutor::cancelStopsAtActionBoundary()
+{
+    TransitionExecutor executor;
+    QSemaphore started;
+    QSemaphore release;
+    std::atomic<bool> dependentRan{false};
+    executor.addAction("display", {}, [&]() {
+        started.release();
+        release.tryAcquire(1, 5000);
+    });
+    executor.addAction("audio", {"display"}, [&dependentRan]() { dependentRan = true; });
+
+    QSignalSpy finished(&executor, &TransitionExecutor::finished);
+    QSignalSpy cancelling(&executor, &TransitionExecutor::cancelling);
+    QVERIFY(executor.start());
+    QVERIFY(!executor.start());
+    QVERIFY(started.tryAcquire(1, 5000));
+
+    executor.cancel();
+    executor.cancel();
+    QVERIFY(executor.cancellationFlag()->load());
+    QCOMPARE(cancelling.count(), 1);
+    release.release();
+
+    QVERIFY(finished.wait(5000));
+    QCOMPARE(finished.count(), 1);
+    QVERIFY(executor.wasCancelled());
+    QVERIFY(!dependentRan);
+    QCOMPARE(executor.timings()[0].status, TransitionExecutor::Done);
+    QCOMPARE(executor.timings()[1].status, TransitionExecutor::NotStarted);
+    QVERIFY(executor.report().startsWith("cancelled after"));
+
+    // The next transition starts clean.
+    executor.clear();
+    executor.addAction("audio", {}, [&dependentRan]() { dependentRan = true; });
+    QVERIFY(runToEnd(executor));
+    QVERIFY(!executor.wasCancelled());
+    QVERIFY(dependentRan);
+
+    // Nothing to wake while idle.
+    executor.cancel();
+    QCOMPARE(cancelling.count(), 1);
+}
+
+void TestTransitionExecutor::rapidTogglesSettleOnLatestTarget()
+{
+    // Drives the executor like BigPictureTV::applyGamemode(): a newer target cancels
+    // the running transition, and its finish handler heads for whatever is current.
+    TransitionExecutor executor;
+    bool target = false;
+    bool applied = false;
+    bool interrupted = false;
+    int transitions = 0;
+    QList<bool> completed;
+
+    std::function<void()> apply = [&]() {
+        if (executor.isRunning()) {
+            if (target != applied) {
+                executor.cancel();
+            }
+            return;
+        }
+        if (target == applied && !interrupted) {
+            return;
+        }
+        applied = target;
+        interrupted = false;
+        ++transitions;
+
+        bool direction = applied;
+        executor.clear();
+        executor.addAction("audio", {}, [&executor]() {
+            // Like the audio retries: long, but gives up once cancelled.
+            for (int i = 0; i < 40 && !executor.cancellationFlag()->load(); ++i) {
+                QThread::msleep(5);
+            }
+        });
+        executor.addAction("done", {"audio"}, [&completed, direction]() {
+            completed.append(direction);
+        }, TransitionExecutor::OwnerThread);
+        executor.start();
+    };
+    connect(&executor, &TransitionExecutor::finished, this, [&]() {
+        interrupted = executor.wasCancelled();
+        apply();
+    });
+
+    static const int FLIPS = 50;
+    for (int i = 0; i < FLIPS; ++i) {
+        target = !target;
+        apply();
+        QTest::qWait(1);
+    }
+    target = true;
+    apply();
+
+    QTRY_VERIFY_WITH_TIMEOUT(!executor.isRunning() && applied == target && !interrupted, 10000);
+    QVERIFY(transitions < FLIPS);
+    QVERIFY(!completed.isEmpty());
+    QCOMPARE(completed.last(), true);
+}
+
+QTEST_GUILESS_MAIN(TestTransitionExecutor)
+#include "tst_transitionexecutor.moc"
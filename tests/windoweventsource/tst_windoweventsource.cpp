@@ -0,0 +1,65 @@
+#include <QSignalSpy>
+#include <QtTest>
+#include "fakewindoweventsource.h"
+
+class TestWindowEventSource : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void burstIsCoalesced();
+    void separateBurstsNotifySeparately();
+    void stoppedSourceIsSilent();
+};
+
+void TestWindowEventSource::burstIsCoalesced()
+{
+    FakeWindowEventSource source;
+    QVERIFY(source.start());
+    QSignalSpy events(&source, &WindowEventSource::windowEvent);
+    QSignalSpy changed(&source, &WindowEventSource::windowsChanged);
+
+    source.inject(1, WindowEventSource::Created);
+    source.inject(1, WindowEventSource::Shown);
+    source.inject(1, WindowEventSource::NameChanged);
+
+    QCOMPARE(events.count(), 3);
+    QCOMPARE(events.at(2).at(1).value<WindowEventSource::EventType>(), WindowEventSource::NameChanged);
+    QCOMPARE(changed.count(), 0);
+
+    QVERIFY(changed.wait(1000));
+    QTest::qWait(200);
+    QCOMPARE(changed.count(), 1);
+}
+
+void TestWindowEventSource::separateBurstsNotifySeparately()
+{
+    FakeWindowEventSource source;
+    source.start();
+    QSignalSpy changed(&source, &WindowEventSource::windowsChanged);
+
+    source.inject(1, WindowEventSource::Created);
+    QVERIFY(changed.wait(1000));
+    source.inject(2, WindowEventSource::Destroyed);
+    QVERIFY(changed.wait(1000));
+    QCOMPARE(changed.count(), 2);
+}
+
+void TestWindowEventSource::stoppedSourceIsSilent()
+{
+    FakeWindowEventSource source;
+    source.start();
+    source.stop();
+    QVERIFY(!source.isActive());
+    QSignalSpy events(&source, &WindowEventSource::windowEvent);
+    QSignalSpy changed(&source, &WindowEventSource::windowsChanged);
+
+    source.inject(1, WindowEventSource::Created);
+    QTest::qWait(200);
+    QCOMPARE(events.count(), 0);
+    QCOMPARE(changed.count(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestWindowEventSource)
+
+#include "tst_windoweventsource.moc"
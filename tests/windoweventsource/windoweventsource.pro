@@ -0,0 +1,14 @@
+include(../tests.pri)
+
+TARGET = tst_windoweventsource
+
+INCLUDEPATH += \
+    $$SRC_DIR/WindowEventSource \
+
+SOURCES += \
+    $$SRC_DIR/WindowEventSource/windoweventsource.cpp \
+    tst_windoweventsource.cpp
+
+HEADERS += \
+    $$SHARED_DIR/fakewindoweventsource.h \
+    $$SRC_DIR/WindowEventSource/windoweventsource.h
@@ -0,0 +1,178 @@
+#include <QtTest>
+#include "fakeprocesssource.h"
+#include "processtable.h"
+#include "windowfilter.h"
+
+class TestWindowFilter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void emptyListsAcceptAnything();
+    void classNamesIgnoreCase();
+    void learnsFromMatches();
+    void unknownProcessIsAccepted();
+    void skipsToolWindows();
+    void firstMissRunsFullSweep();
+    void missesFallBackWithinInterval();
+    void matchKeepsFiltering();
+    void newListsAreCheckedAgain();
+
+private:
+    WindowAttributes attributes(const QString &className, quint32 processId = 0, bool toolWindow = false) const;
+
+    qint64 now;
+};
+
+void TestWindowFilter::init()
+{
+    now = 1000;
+}
+
+WindowAttributes TestWindowFilter::attributes(const QString &className, quint32 processId, bool toolWindow) const
+{
+    WindowAttributes result;
+    result.className = className;
+    result.processId = processId;
+    result.toolWindow = toolWindow;
+    return result;
+}
+
+void TestWindowFilter::emptyListsAcceptAnything()
+{
+    WindowFilter filter(nullptr);
+    QString className("Notepad");
+    QVERIFY(filter.accepts(attributes(className)));
+    QVERIFY(!filter.usesProcessImages());
+}
+
+void TestWindowFilter::classNamesIgnoreCase()
+{
+    WindowFilter filter(nullptr);
+    quint32 revision = filter.revision();
+    filter.setClassNames({" SDL_app "});
+    QVERIFY(filter.revision() != revision);
+
+    QString matching("sdl_APP");
+    QString other("Notepad");
+    QVERIFY(filter.accepts(attributes(matching)));
+    QVERIFY(!filter.accepts(attributes(other)));
+}
+
+void TestWindowFilter::learnsFromMatches()
+{
+    FakeProcessSource source;
+    source.addProcess(10, "steamwebhelper.exe");
+    source.addProcess(11, "notepad.exe");
+    ProcessTable processes(&source);
+    processes.refresh();
+
+    WindowFilter filter(&processes);
+    quint32 revision = filter.revision();
+    filter.learn(u"SDL_app", 10);
+    QVERIFY(filter.revision() != revision);
+    QVERIFY(filter.usesProcessImages());
+
+    QString className("SDL_app");
+    QVERIFY(filter.accepts(attributes(className, 10)));
+    QVERIFY(!filter.accepts(attributes(className, 11)));
+
+    // Learning the same names again does not invalidate anything.
+    revision = filter.revision();
+    filter.learn(u"sdl_app", 10);
+    QCOMPARE(filter.revision(), revision);
+
+    filter.clearLearned();
+    QVERIFY(!filter.usesProcessImages());
+    QVERIFY(filter.accepts(attributes(className, 11)));
+}
+
+void TestWindowFilter::unknownProcessIsAccepted()
+{
+    FakeProcessSource source;
+    source.addProcess(10, "steamwebhelper.exe");
+    ProcessTable processes(&source);
+    processes.refresh();
+
+    WindowFilter filter(&processes);
+    filter.setProcessImages({"steamwebhelper.exe"});
+
+    // Started after the last refresh, so its image is not known yet.
+    QString className("SDL_app");
+    QVERIFY(filter.accepts(attributes(className, 99)));
+}
+
+void TestWindowFilter::skipsToolWindows()
+{
+    WindowFilter filter(nullptr);
+    QString className("SDL_app");
+    QVERIFY(filter.accepts(attributes(className, 0, true)));
+
+    quint32 revision = filter.revision();
+    filter.setSkipToolWindows(true);
+    QVERIFY(filter.revision() != revision);
+    QVERIFY(!filter.accepts(attributes(className, 0, true)));
+    QVERIFY(filter.accepts(attributes(className, 0, false)));
+}
+
+void TestWindowFilter::firstMissRunsFullSweep()
+{
+    WindowFilter filter(nullptr, [this]() { return now; });
+    filter.setClassNames({"SDL_app"});
+
+    QVERIFY(filter.shouldFilter());
+    filter.recordSweep(true, false);
+
+    // Nothing has been checked without the filter yet, so there is no waiting.
+    QVERIFY(!filter.shouldFilter());
+}
+
+void TestWindowFilter::missesFallBackWithinInterval()
+{
+    WindowFilter filter(nullptr, [this]() { return now; });
+    filter.setClassNames({"SDL_app"});
+    filter.recordSweep(true, false);
+    filter.recordSweep(false, false);
+
+    for (int i = 0; i < 100; ++i) {
+        now += 10;
+        QVERIFY(filter.shouldFilter());
+        filter.recordSweep(true, false);
+    }
+
+    now += WindowFilter::FULL_SWEEP_INTERVAL_MS;
+    QVERIFY(!filter.shouldFilter());
+    filter.recordSweep(false, false);
+    QVERIFY(filter.shouldFilter());
+}
+
+void TestWindowFilter::matchKeepsFiltering()
+{
+    WindowFilter filter(nullptr, [this]() { return now; });
+    filter.setClassNames({"SDL_app"});
+
+    now += 10 * WindowFilter::FULL_SWEEP_INTERVAL_MS;
+    filter.recordSweep(true, true);
+    QVERIFY(filter.shouldFilter());
+    filter.recordSweep(true, true);
+    QVERIFY(filter.shouldFilter());
+}
+
+void TestWindowFilter::newListsAreCheckedAgain()
+{
+    WindowFilter filter(nullptr, [this]() { return now; });
+    filter.setClassNames({"SDL_app"});
+    filter.recordSweep(true, false);
+    filter.recordSweep(false, false);
+    filter.recordSweep(true, false);
+    QVERIFY(filter.shouldFilter());
+
+    filter.setClassNames({"CEF-OSC-WIDGET"});
+    QVERIFY(filter.shouldFilter());
+    filter.recordSweep(true, false);
+    QVERIFY(!filter.shouldFilter());
+}
+
+QTEST_APPLESS_MAIN(TestWindowFilter)
+#include "tst_windowfilter.moc"
@@ -0,0 +1,20 @@
+include(../tests.pri)
+
+TARGET = tst_windowfilter
+
+INCLUDEPATH += \
+    $$SRC_DIR/ProcessTable \
+    $$SRC_DIR/WindowEnumerator \
+    $$SRC_DIR/WindowFilter \
+
+SOURCES += \
+    $$SRC_DIR/ProcessTable/processtable.cpp \
+    $$SRC_DIR/WindowFilter/windowfilter.cpp \
+    tst_windowfilter.cpp
+
+HEADERS += \
+    $$SHARED_DIR/fakeprocesssource.h \
+    $$SRC_DIR/ProcessTable/processsource.h \
+    $$SRC_DIR/ProcessTable/processtable.h \
+    $$SRC_DIR/WindowEnumerator/windowenumerator.h \
+    $$SRC_DIR/WindowFilter/windowfilter.h
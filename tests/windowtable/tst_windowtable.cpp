@@ -0,0 +1,188 @@
+#include <QtTest>
+#include "fakewindowenumerator.h"
+#include "windowfilter.h"
+#include "windowmatcher.h"
+#include "windowtable.h"
+
+namespace {
+
+// Matches titles that contain the target text, in target order.
+class ContainsMatcher : public WindowMatcher
+{
+public:
+    QStringList targets;
+
+    bool isEmpty() const override { return targets.isEmpty(); }
+
+    int matchWindow(QStringView title, quint32 processId) override
+    {
+        Q_UNUSED(processId)
+        for (int i = 0; i < targets.size(); ++i) {
+            if (title.contains(targets[i])) {
+                return i;
+            }
+        }
+        return -1;
+    }
+};
+
+} // namespace
+
+class TestWindowTable : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void readsNewWindowsOnce();
+    void invalidatedWindowIsReread();
+    void reportsDepartedWindows();
+    void newMatcherKeepsTitles();
+    void filteredWindowIsNotRead();
+    void filteredWindowKeepsPendingTitle();
+
+private:
+    FakeWindowEnumerator::Window window(quintptr handle, const QString &title, const QString &className = "SDL_app") const;
+
+    FakeWindowEnumerator enumerator;
+    SweepStats stats;
+    ContainsMatcher matcher;
+};
+
+void TestWindowTable::init()
+{
+    enumerator = FakeWindowEnumerator();
+    stats = SweepStats();
+    matcher.targets = QStringList{"Big Picture"};
+}
+
+FakeWindowEnumerator::Window TestWindowTable::window(quintptr handle, const QString &title, const QString &className) const
+{
+    FakeWindowEnumerator::Window result;
+    result.handle = handle;
+    result.title = title;
+    result.className = className;
+    return result;
+}
+
+void TestWindowTable::readsNewWindowsOnce()
+{
+    enumerator.addWindow(window(1, "Steam Big Picture Mode"));
+    enumerator.addWindow(window(2, "Notepad"));
+    WindowTable table(&enumerator, &stats);
+    table.setMatcher(&matcher);
+
+    QCOMPARE(table.sweep().arrived.size(), 2);
+    QCOMPARE(enumerator.titleReads, 2);
+    quintptr matched = 0;
+    QCOMPARE(table.matchingTarget(&matched), 0);
+    QCOMPARE(matched, quintptr(1));
+
+    QVERIFY(table.sweep().arrived.isEmpty());
+    QCOMPARE(enumerator.titleReads, 2);
+    QCOMPARE(stats.sweeps, quint64(2));
+}
+
+void TestWindowTable::invalidatedWindowIsReread()
+{
+    enumerator.addWindow(window(1, "Steam"));
+    WindowTable table(&enumerator, &stats);
+    table.setMatcher(&matcher);
+    table.sweep();
+    QCOMPARE(table.matchingTarget(), -1);
+
+    // A changed title is not seen until the window is invalidated.
+    enumerator.setTitle(1, "Steam Big Picture Mode");
+    table.sweep();
+    QCOMPARE(table.matchingTarget(), -1);
+
+    table.invalidate(1);
+    const WindowTable::Delta &delta = table.sweep();
+    QCOMPARE(delta.retitled, QVector<quintptr>{1});
+    QCOMPARE(table.matchingTarget(), 0);
+}
+
+void TestWindowTable::reportsDepartedWindows()
+{
+    enumerator.addWindow(window(1, "Steam Big Picture Mode"));
+    enumerator.addWindow(window(2, "Notepad"));
+    WindowTable table(&enumerator, &stats);
+    table.setMatcher(&matcher);
+    table.sweep();
+
+    enumerator.removeWindow(1);
+    const WindowTable::Delta &delta = table.sweep();
+    QCOMPARE(delta.departed, QVector<quintptr>{1});
+    QCOMPARE(table.size(), 1);
+    QCOMPARE(table.matchingTarget(), -1);
+}
+
+void TestWindowTable::newMatcherKeepsTitles()
+{
+    enumerator.addWindow(window(1, "Steam Big Picture Mode"));
+    enumerator.addWindow(window(2, "Notepad"));
+    WindowTable table(&enumerator, &stats);
+    table.setMatcher(&matcher);
+    table.sweep();
+
+    ContainsMatcher other;
+    other.targets = QStringList{"Notepad"};
+    table.setMatcher(&other);
+    table.sweep();
+
+    quintptr matched = 0;
+    QCOMPARE(table.matchingTarget(&matched), 0);
+    QCOMPARE(matched, quintptr(2));
+    QCOMPARE(enumerator.titleReads, 2);
+}
+
+void TestWindowTable::filteredWindowIsNotRead()
+{
+    enumerator.addWindow(window(1, "Steam Big Picture Mode"));
+    enumerator.addWindow(window(2, "Notepad", "Notepad"));
+    WindowFilter filter(nullptr);
+    filter.setClassNames({"SDL_app"});
+    WindowTable table(&enumerator, &stats);
+    table.setMatcher(&matcher);
+    table.setFilter(&filter);
+
+    table.sweep();
+    QCOMPARE(enumerator.titleReads, 1);
+    QCOMPARE(stats.windowsFiltered, quint64(1));
+    QCOMPARE(table.matchingTarget(), 0);
+
+    // Accepting every window reads the one that was skipped.
+    table.setFilter(nullptr);
+    table.sweep();
+    QCOMPARE(enumerator.titleReads, 2);
+}
+
+void TestWindowTable::filteredWindowKeepsPendingTitle()
+{
+    enumerator.addWindow(window(1, "Steam"));
+    WindowTable table(&enumerator, &stats);
+    table.setMatcher(&matcher);
+    table.sweep();
+    QCOMPARE(table.matchingTarget(), -1);
+
+    // The title changes while the filter rejects the window.
+    WindowFilter filter(nullptr);
+    filter.setClassNames({"CEF-OSC-WIDGET"});
+    enumerator.setTitle(1, "Steam Big Picture Mode");
+    table.invalidate(1);
+    table.setFilter(&filter);
+    table.sweep();
+    QCOMPARE(table.matchingTarget(), -1);
+    QCOMPARE(enumerator.titleReads, 1);
+
+    // Once it is accepted again the new title has to be read, not the cached one.
+    filter.setClassNames({"SDL_app"});
+    table.setFilter(&filter);
+    const WindowTable::Delta &delta = table.sweep();
+    QCOMPARE(enumerator.titleReads, 2);
+    QCOMPARE(delta.retitled, QVector<quintptr>{1});
+    QCOMPARE(table.matchingTarget(), 0);
+}
+
+QTEST_APPLESS_MAIN(TestWindowTable)
+#include "tst_windowtable.moc"
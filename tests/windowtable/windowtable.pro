@@ -0,0 +1,25 @@
+include(../tests.pri)
+
+TARGET = tst_windowtable
+
+INCLUDEPATH += \
+    $$SRC_DIR/ProcessTable \
+    $$SRC_DIR/WindowEnumerator \
+    $$SRC_DIR/WindowFilter \
+    $$SRC_DIR/WindowMatcher \
+    $$SRC_DIR/WindowTable \
+
+SOURCES += \
+    $$SRC_DIR/ProcessTable/processtable.cpp \
+    $$SRC_DIR/WindowFilter/windowfilter.cpp \
+    $$SRC_DIR/WindowTable/windowtable.cpp \
+    tst_windowtable.cpp
+
+HEADERS += \
+    $$SHARED_DIR/fakewindowenumerator.h \
+    $$SRC_DIR/ProcessTable/processsource.h \
+    $$SRC_DIR/ProcessTable/processtable.h \
+    $$SRC_DIR/WindowEnumerator/windowenumerator.h \
+    $$SRC_DIR/WindowFilter/windowfilter.h \
+    $$SRC_DIR/WindowMatcher/windowmatcher.h \
+    $$SRC_DIR/WindowTable/windowtable.h